@@ -21,8 +21,40 @@
 #include "fsc2.h"
 
 
+/* Description of a data set within a message from the child */
+
+typedef struct {
+    long         x_index;
+    long         y_index;       /* always 0 for 1D data */
+    long         curve;
+    Var_Type_T   type;
+    long         len;           /* number of points (not for REF types) */
+    const char * data;          /* start of the data (for arrays with their
+                                   length) */
+} Data_Set_T;
+
+/* What's needed to find out if a data set gets overwritten completely by a
+   later one */
+
+typedef struct {
+    int  dim;
+    long curve;
+    long y_index;
+    long start;                 /* range of x-indices written to */
+    long end;
+    bool can_be_skipped;
+} Set_Range_T;
+
+
+static void redraw_new_data( void );
+static double accept_time( void );
+static void find_stale_sets( void );
 static void unpack_and_accept( int          dim,
-                               const char * ptr );
+                               const char * ptr,
+                               const bool * stale );
+static const char * get_data_set( int          dim,
+                                  const char * ptr,
+                                  Data_Set_T * ds );
 static void other_data_request( int          dim,
                                 int          type,
                                 const char * ptr );
@@ -51,6 +83,12 @@ static bool incr_y( long y_index );
 static bool incr_x_and_y( long x_index,
                           long len,
                           long y_index );
+static void grow_2d_arrays( long nx,
+                            long ny );
+static void rescale_points( double * points,
+                            long     num,
+                            double   factor,
+                            double   offset );
 
 
 /* These variables are used to determine which parts of the display(s) need
@@ -62,19 +100,47 @@ static bool Scale_2d_changed[ 3 ];
 static bool Need_2d_redraw;
 static bool Need_cut_redraw;
 
+/* Displays for which new data still have to be drawn (1 for 1D, 2 for 2D)
+   and when the last redraw was done */
 
-#define MAX_ACCEPT_TIME  0.2    /* 200 ms */
+static int Pending_dim = 0;
+static double Last_redraw = 0.0;
+
+
+/* When the display falls behind the child the message queue may contain
+   data sets that get overwritten completely by later ones, which then don't
+   need to be displayed at all. For the entries in the message queue found
+   when starting to accept new data these data sets get flagged in 'Stale',
+   with the flags for the data sets of the entry at queue position 'i'
+   starting at 'First_set[ i ]' (-1 for entries that weren't looked at). */
+
+static Set_Range_T * Set_ranges = NULL;
+static bool * Stale = NULL;
+static long Max_sets = 0;
+static long First_set[ QUEUE_SIZE ];
+
+
+#define MAX_ACCEPT_TIME      0.05    /* 50 ms */
+#define MIN_REDRAW_INTERVAL  0.1     /* 100 ms */
+
+/* Maximum number of ranges written to by later data sets that are compared
+   to the range of a data set when checking if it can be skipped */
+
+#define MAX_COVER_RANGES  64
 
 
 /*--------------------------------------------------------------------------*
  * This is the function that takes new data from the message queue and
  * displays them. The function is invoked as an idle callback, i.e. whenever
- * the program has nothing else to do for a limited time (currently set to
- * 200 ms), and schedules them to be displayed. When all sets have been
- * removed from the message queue (or the maximum time in the accept loop is
- * over or only a REQUEST type date item is left, which is always the last
+ * the program has nothing else to do, and accepts data for a limited time
+ * only (currently 50 ms). When all sets have been removed from the message
+ * queue (or only a REQUEST type date item is left, which is always the last
  * if one exists) all parts of the display windows that changed due to the
- * new data get updated.
+ * new data get updated. If the child sends data faster than they can be
+ * displayed this is also done, but not more often than every 100 ms, so
+ * that the time spent drawing stays limited and the program still reacts
+ * quickly to the user (e.g. the STOP button), requests from the child and
+ * the HTTP server, which all get dealt with between calls.
  *--------------------------------------------------------------------------*/
 
 void
@@ -83,30 +149,33 @@ accept_new_data( bool empty_queue )
     /* Get the time we arrived here, it's later used to avoid spending too
        much time in the loop for accepting data sets */
 
-    volatile double start_time = 0.0;
-    if ( ! empty_queue )
+    volatile double start_time = empty_queue ? 0.0 : accept_time( );
+
+    /* Clear the flags that later tell us what really needs to be redrawn
+       (unless the new data from a previous call haven't been drawn yet) */
+
+    if ( ! Pending_dim )
     {
-        struct timeval time_struct;
-        gettimeofday( &time_struct, NULL );
-        start_time = time_struct.tv_sec + 1.0e-6 * time_struct.tv_sec;
+        memset( Scale_1d_changed, 0, sizeof Scale_1d_changed );
+        memset( Scale_2d_changed, 0, sizeof Scale_2d_changed );
+        Need_2d_redraw = Need_cut_redraw = false;
     }
 
-    /* Clear the flags that later tell us what really needs to be redrawn */
-
-    memset( Scale_1d_changed, 0, sizeof Scale_1d_changed );
-    memset( Scale_2d_changed, 0, sizeof Scale_2d_changed );
-    Need_2d_redraw = Need_cut_redraw = false;
+    /* Find the data sets already waiting in the queue that don't need to be
+       displayed since later ones overwrite them */
 
-    volatile int dim = 0;
+    find_stale_sets( );
 
     while ( true )
     {
-        /* Attach to the shared memory segment pointed to by the oldest entry
-           in the message queue - even though this should never fail it
-           sometimes does (with 2.0 kernels only) */
+        /* Get at the data for the oldest entry in the message queue, either
+           in the ring buffer or in a shared memory segment of their own -
+           even though attaching to a segment should never fail it sometimes
+           does (with 2.0 kernels only) */
 
+        Slot_T * slot = Comm.MQ->slot + Comm.MQ->low;
         const char * volatile buf;
-        if ( ! ( buf = attach_shm( Comm.MQ->slot[ Comm.MQ->low ].shm_id ) ) )
+        if ( ! ( buf = fetch_data( slot ) ) )
         {
 #ifndef NDEBUG
             eprint( FATAL, false, "Internal communication error at %s:%d, "
@@ -123,26 +192,29 @@ accept_new_data( bool empty_queue )
         }
 
         /* Unpack and accept the data sets (skip the length field, it's not
-           needed) - if an exception happens detach from the segment and
-           re-throw the exception */
+           needed) - if an exception happens release the data and re-throw
+           the exception */
 
         TRY
         {
-            int type = Comm.MQ->slot[ Comm.MQ->low ].type;
-            dim |= type == DATA_1D ? 1 : 2;
-            unpack_and_accept( type, buf + sizeof( long ) );
+            int type = slot->type;
+            long first = First_set[ Comm.MQ->low ];
+
+            Pending_dim |= type == DATA_1D ? 1 : 2;
+            unpack_and_accept( type, buf + sizeof( long ),
+                               first >= 0 ? Stale + first : NULL );
             TRY_SUCCESS;
         }
         OTHERWISE
         {
-            detach_shm( buf, &Comm.MQ->slot[ Comm.MQ->low ].shm_id );
+            release_data( buf, slot );
+            Pending_dim = 0;
             RETHROW;
         }
 
-        /* Detach from the shared memory segment and remove it */
+        /* Give the memory used for the data back */
 
-        detach_shm( buf, &Comm.MQ->slot[ Comm.MQ->low ].shm_id );
-        Comm.MQ->slot[ Comm.MQ->low ].shm_id = -1;
+        release_data( buf, slot );
 
         /* Increment the low queue pointer and post the data semaphore to
            tell the child that there's again room in the message queue. */
@@ -163,18 +235,34 @@ accept_new_data( bool empty_queue )
            'empty_queue' is set, in which case the child is already dead and
            we have to fetch everything it sent during its live time. */
 
-        if ( ! empty_queue )
-        {
-            struct timeval time_struct;
-            gettimeofday( &time_struct, NULL );
-            if ( time_struct.tv_sec + 1.0e-6 * time_struct.tv_sec
-                 - start_time >= MAX_ACCEPT_TIME )
-                break;
-        }
+        if ( ! empty_queue && accept_time( ) - start_time >= MAX_ACCEPT_TIME )
+            break;
     }
 
-    /* After being done with unpacking we display the new data by redrawing
-       the canvases that have been changed because of the new data */
+    /* Display the new data if all of them have been accepted or, when there
+       are still more, if the last redraw was long enough ago */
+
+    if (    empty_queue
+         || Comm.MQ->low == Comm.MQ->high
+         || Comm.MQ->slot[ Comm.MQ->low ].type == REQUEST
+         || accept_time( ) - Last_redraw >= MIN_REDRAW_INTERVAL )
+        redraw_new_data( );
+}
+
+
+/*----------------------------------------------------------------*
+ * Redraws the canvases that have been changed because of the new
+ * data. Only displays that still exist are dealt with.
+ *----------------------------------------------------------------*/
+
+static void
+redraw_new_data( void )
+{
+    int dim = Pending_dim & G.dim;
+
+
+    Pending_dim = 0;
+    Last_redraw = accept_time( );
 
     if ( dim & 1 )
     {
@@ -201,14 +289,150 @@ accept_new_data( bool empty_queue )
 }
 
 
+/*-----------------------------------------*
+ * Returns the current time in seconds.
+ *-----------------------------------------*/
+
+static double
+accept_time( void )
+{
+    struct timeval time_struct;
+
+    gettimeofday( &time_struct, NULL );
+    return time_struct.tv_sec + 1.0e-6 * time_struct.tv_usec;
+}
+
+
+/*---------------------------------------------------------------------*
+ * Looks at the data sets of all entries in the message queue (up to a
+ * REQUEST or anything else than new data, e.g. a command for clearing
+ * a curve) and flags the ones that get completely overwritten by later
+ * data sets for the same curve (and row for 2D data). Extrema don't
+ * need to be calculated and nothing needs to be redrawn for them.
+ * Data sets for the 1D display in sliding window mode (where new data
+ * get appended instead of overwriting old ones) and 2D data sets with
+ * several rows are never skipped.
+ *---------------------------------------------------------------------*/
+
+static void
+find_stale_sets( void )
+{
+    long num_sets = 0;
+
+
+    for ( int i = 0; i < QUEUE_SIZE; i++ )
+        First_set[ i ] = -1;
+
+    for ( int i = Comm.MQ->low; i != Comm.MQ->high;
+          i = ( i + 1 ) % QUEUE_SIZE )
+    {
+        Slot_T * slot = Comm.MQ->slot + i;
+
+        if ( slot->type == REQUEST )
+            break;
+
+        const char * volatile buf = fetch_data( slot );
+        if ( buf == NULL )
+            break;
+
+        const char * ptr = buf + sizeof( long );
+        int nsets;
+        memcpy( &nsets, ptr, sizeof nsets );
+        ptr += sizeof nsets;
+
+        if ( nsets < 0 )
+        {
+            unfetch_data( buf, slot );
+            break;
+        }
+
+        TRY
+        {
+            if ( num_sets + nsets > Max_sets )
+            {
+                Max_sets = 2 * ( num_sets + nsets );
+                Set_ranges = T_realloc( Set_ranges,
+                                        Max_sets * sizeof *Set_ranges );
+                Stale = T_realloc( Stale, Max_sets * sizeof *Stale );
+            }
+            TRY_SUCCESS;
+        }
+        OTHERWISE
+        {
+            unfetch_data( buf, slot );
+            RETHROW;
+        }
+
+        First_set[ i ] = num_sets;
+
+        for ( int j = 0; j < nsets; j++, num_sets++ )
+        {
+            Data_Set_T ds;
+            Set_Range_T * sr = Set_ranges + num_sets;
+
+            ptr = get_data_set( slot->type, ptr, &ds );
+
+            sr->dim            = slot->type;
+            sr->curve          = ds.curve;
+            sr->y_index        = ds.y_index;
+            sr->start          = ds.x_index;
+            sr->end            = ds.x_index + ds.len;
+            sr->can_be_skipped =    ! ( ds.type & ( INT_REF | FLOAT_REF ) )
+                                 && (    slot->type == DATA_2D
+                                      || G.mode == NORMAL_DISPLAY );
+            Stale[ num_sets ] = false;
+        }
+
+        unfetch_data( buf, slot );
+    }
+
+    /* Go through the data sets from the newest to the oldest, remembering
+       the ranges written to by the most recent ones (as far as there's
+       room) and flag all that are within one of them */
+
+    Set_Range_T * covers[ MAX_COVER_RANGES ];
+    int num_covers = 0;
+    int next_cover = 0;
+
+    for ( long i = num_sets - 1; i >= 0; i-- )
+    {
+        Set_Range_T * sr = Set_ranges + i;
+
+        if ( ! sr->can_be_skipped )
+            continue;
+
+        for ( int j = 0; j < num_covers; j++ )
+            if (    covers[ j ]->dim == sr->dim
+                 && covers[ j ]->curve == sr->curve
+                 && covers[ j ]->y_index == sr->y_index
+                 && covers[ j ]->start <= sr->start
+                 && covers[ j ]->end >= sr->end )
+            {
+                Stale[ i ] = true;
+                break;
+            }
+
+        if ( ! Stale[ i ] )
+        {
+            covers[ next_cover ] = sr;
+            next_cover = ( next_cover + 1 ) % MAX_COVER_RANGES;
+            num_covers = i_min( num_covers + 1, MAX_COVER_RANGES );
+        }
+    }
+}
+
+
 /*----------------------------------------------------------------*
  * Function examines the new data by looking at the first item
  * and calls the appropriate functions for dealing with the data.
+ * If 'stale' isn't NULL it points to flags for each of the data
+ * sets, telling if the data set can be skipped.
  *----------------------------------------------------------------*/
 
 static void
 unpack_and_accept( int          dim,
-                   const char * ptr )
+                   const char * ptr,
+                   const bool * stale )
 {
     /* The first item of a new data package indicates the amount of data
        sets that needs handling. When the first item is a negative number
@@ -229,66 +453,78 @@ unpack_and_accept( int          dim,
 
     for ( int i = 0; i < nsets; i++ )
     {
-        long x_index;
-        memcpy( &x_index, ptr, sizeof x_index );
-        ptr += sizeof x_index;
+        Data_Set_T ds;
 
-        long y_index = 0;
-        if ( dim == DATA_2D )
-        {
-            memcpy( &y_index, ptr, sizeof y_index );
-            ptr += sizeof y_index;
-        }
+        ptr = get_data_set( dim, ptr, &ds );
 
-        long curve;
-        memcpy( &curve, ptr, sizeof curve );
-        ptr += sizeof curve;
+        if ( stale && stale[ i ] )
+            continue;
 
-        Var_Type_T type;
-        memcpy( &type, ptr, sizeof type );
-        ptr += sizeof type;
+        if ( dim == DATA_1D )
+            accept_1d_data( ds.x_index, ds.curve, ds.type, ds.data );
+        else
+            accept_2d_data( ds.x_index, ds.y_index, ds.curve, ds.type,
+                            ds.data );
+    }
+}
 
-        const char * ptr_next = NULL;
-        long len;
 
-        switch ( type )
-        {
-            case INT_VAR :
-                ptr_next = ptr + sizeof( long );
-                break;
+/*----------------------------------------------------------------*
+ * Extracts the description of a data set from a message, returns
+ * a pointer to the start of the next data set.
+ *----------------------------------------------------------------*/
 
-            case FLOAT_VAR :
-                ptr_next = ptr + sizeof( double );
-                break;
+static const char *
+get_data_set( int          dim,
+              const char * ptr,
+              Data_Set_T * ds )
+{
+    memcpy( &ds->x_index, ptr, sizeof ds->x_index );
+    ptr += sizeof ds->x_index;
 
-            case INT_ARR :
-                memcpy( &len, ptr, sizeof len );
-                ptr_next = ptr + sizeof len + len * sizeof( long );
-                break;
+    ds->y_index = 0;
+    if ( dim == DATA_2D )
+    {
+        memcpy( &ds->y_index, ptr, sizeof ds->y_index );
+        ptr += sizeof ds->y_index;
+    }
 
-            case FLOAT_ARR :
-                memcpy( &len, ptr, sizeof len );
-                ptr_next = ptr + sizeof len + len * sizeof( double );
-                break;
+    memcpy( &ds->curve, ptr, sizeof ds->curve );
+    ptr += sizeof ds->curve;
 
-            case INT_REF : case FLOAT_REF :
-                fsc2_assert( dim == DATA_2D );
-                memcpy( &len, ptr, sizeof len );
-                ptr += sizeof len;
-                ptr_next = ptr + len;
-                break;
+    memcpy( &ds->type, ptr, sizeof ds->type );
+    ptr += sizeof ds->type;
 
-        default :
-            fsc2_impossible( );       /* This can't happen... */
-        }
+    ds->data = ptr;
+    ds->len = 1;
 
-        if ( dim == DATA_1D )
-            accept_1d_data( x_index, curve, type, ptr );
-        else
-            accept_2d_data( x_index, y_index, curve, type, ptr );
+    switch ( ds->type )
+    {
+        case INT_VAR :
+            return ptr + sizeof( long );
 
-        ptr = ptr_next;
+        case FLOAT_VAR :
+            return ptr + sizeof( double );
+
+        case INT_ARR :
+            memcpy( &ds->len, ptr, sizeof ds->len );
+            return ptr + sizeof ds->len + ds->len * sizeof( long );
+
+        case FLOAT_ARR :
+            memcpy( &ds->len, ptr, sizeof ds->len );
+            return ptr + sizeof ds->len + ds->len * sizeof( double );
+
+        case INT_REF : case FLOAT_REF :
+            fsc2_assert( dim == DATA_2D );
+            memcpy( &ds->len, ptr, sizeof ds->len );
+            ds->data = ptr += sizeof ds->len;
+            return ptr + ds->len;
+
+        default :
+            fsc2_impossible( );       /* This can't happen... */
     }
+
+    return NULL;
 }
 
 
@@ -617,9 +853,9 @@ accept_1d_data( long         x_index,
             cv->xpoints = T_realloc( cv->xpoints,
                                      end_index * sizeof *cv->xpoints );
 
-            Scaled_Point_T * sp = cv->points + G_1d.nx;
+            double * sp = cv->points + G_1d.nx;
             for ( long j = G_1d.nx; j < end_index; sp++, j++ )
-                sp->exist = false;
+                *sp = NO_POINT;
 
             if ( G_1d.is_fs )
                 cv->s2d[ X ] = ( double ) ( G_1d.canvas.w - 1 ) /
@@ -629,65 +865,45 @@ accept_1d_data( long         x_index,
         Scale_1d_changed[ X ] |= G_1d.is_fs;
     }
 
-    /* Find maximum and minimum of old and new data and, if the minimum or
-       maximum has changed, rescale all old scaled data*/
-
-    double old_rw_min = G_1d.rw_min;
+    /* Find maximum and minimum of old and new data. Once the scaling is set
+       the scaled data stay relative to the minimum and the range of the data
+       at that moment, so a new minimum or maximum doesn't require touching
+       the old data. Only in full scale mode the y-scaling of the curves has
+       to be adjusted to the new range, otherwise nothing visible changes. */
 
     if ( get_new_extrema( &G_1d.rw_max, &G_1d.rw_min, ptr, len, type ) )
     {
-        double new_rwc_delta_y = G_1d.rw_max - G_1d.rw_min;
-
         if ( G_1d.is_scale_set )
         {
-            double factor = G_1d.rwc_delta[ Y ] / new_rwc_delta_y;
-            double offset = ( old_rw_min - G_1d.rw_min ) / new_rwc_delta_y;
-
-            Curve_1d_T * cv = G_1d.curve[ 0 ];
-            for ( long i = 0; i < G_1d.nc; cv = G_1d.curve[ ++i ] )
+            if ( G_1d.is_fs )
             {
-                Scaled_Point_T * sp = cv->points;
-                for ( long count = cv->count; count > 0; sp++ )
-                    if ( sp->exist )
-                    {
-                        sp->v = factor * sp->v + offset;
-                        count--;
-                    }
-
-                if ( G_1d.is_fs )
-                    continue;
-
-                cv->s2d[ Y ]  /= factor;
-                cv->shift[ Y ] = factor * cv->shift[ Y ] - offset;
+                fs_adjust_y_1d( );
+                Scale_1d_changed[ Y ] = true;
             }
         }
+        else if ( G_1d.rw_max != G_1d.rw_min )
+        {
+            /* If the data had not been scaled to [0,1] yet and the maximum
+               value isn't identical to the minimum anymore do the scaling
+               now */
 
-        /* If the data had not been scaled to [0,1] yet and the maximum value
-           isn't identical to the minimum anymore do the scaling now */
+            G_1d.rwc_start[ Y ] = G_1d.rw_min;
+            G_1d.rwc_delta[ Y ] = G_1d.rw_max - G_1d.rw_min;
 
-        if ( ! G_1d.is_scale_set && G_1d.rw_max != G_1d.rw_min )
-        {
-            double factor = 1.0 / new_rwc_delta_y;
-            double offset = - G_1d.rw_min / new_rwc_delta_y;
+            double factor = 1.0 / G_1d.rwc_delta[ Y ];
+            double offset = - G_1d.rw_min / G_1d.rwc_delta[ Y ];
 
             Curve_1d_T * cv = G_1d.curve[ 0 ];
             for ( long i = 0; i < G_1d.nc; cv = G_1d.curve[ ++i ] )
             {
-                Scaled_Point_T * sp = cv->points;
-                for ( long count = cv->count; count > 0; sp++ )
-                    if ( sp->exist )
-                    {
-                          sp->v = factor * sp->v + offset;
-                          count--;
-                    }
+                rescale_points( cv->points, G_1d.nx, factor, offset );
+                cv->lod_size = 0;
             }
 
             G_1d.is_scale_set = true;
             Scale_1d_changed[ X ] = true;
+            Scale_1d_changed[ Y ] = true;
         }
-
-        Scale_1d_changed[ Y ] = true;
-        G_1d.rwc_delta[ Y ] = new_rwc_delta_y;
     }
 
     /* Now we're finished with rescaling and can set the new number of points
@@ -698,8 +914,9 @@ accept_1d_data( long         x_index,
 
     /* Include the new data into the scaled data */
 
+    Curve_1d_T * cv = G_1d.curve[ curve ];
     const char * cur_ptr = ptr;
-    Scaled_Point_T * sp = G_1d.curve[ curve ]->points + x_index;
+    double * sp = cv->points + x_index;
     for ( long i = x_index; i < end_index; sp++, i++ )
     {
         double data;
@@ -717,35 +934,30 @@ accept_1d_data( long         x_index,
             cur_ptr += sizeof data;
         }
 
+        /* Increase the point count if the point is new (a NaN as the new
+           value removes the point) */
+
+        bool existed = POINT_EXISTS( *sp );
+
         if ( G_1d.is_scale_set )
-            sp->v = ( data - G_1d.rw_min ) / G_1d.rwc_delta[ Y ];
+            *sp = ( data - G_1d.rwc_start[ Y ] ) / G_1d.rwc_delta[ Y ];
         else
-            sp->v = data;
+            *sp = data;
 
-        /* Increase the point count if the point is new and mark it as set */
-
-        if ( ! sp->exist )
-        {
-            G_1d.curve[ curve ]->count++;
-            sp->exist = true;
-        }
+        cv->count += POINT_EXISTS( *sp ) - existed;
+        lod_point_changed_1d( cv, i );
     }
 
-    /* Calculate new points for display (unless no scale is set yet) */
-
-    if ( G_1d.is_scale_set )
-    {
-        G_1d.rwc_start[ Y ] = G_1d.rw_min;
+    /* The points for display are only calculated when the canvas gets
+       redrawn, which may happen only after several calls of this function.
+       If the scale did not change this is needed for the current curve only,
+       otherwise for all curves. */
 
-        /* If the scale did not change redraw only the current curve,
-           otherwise all curves */
+    cv->needs_recalc = true;
 
-        if ( ! ( Scale_1d_changed[ X ] || Scale_1d_changed[ Y ] ) )
-            recalc_XPoints_of_curve_1d( G_1d.curve[ curve ] );
-        else
-            for ( long i = 0; i < G_1d.nc; i++ )
-                recalc_XPoints_of_curve_1d( G_1d.curve[ i ] );
-    }
+    if ( Scale_1d_changed[ X ] || Scale_1d_changed[ Y ] )
+        for ( long i = 0; i < G_1d.nc; i++ )
+            G_1d.curve[ i ]->needs_recalc = true;
 }
 
 
@@ -763,60 +975,45 @@ accept_1d_data_sliding( long         curve,
 
     long len = get_number_of_new_points( &ptr, type );
 
-    /* Find maximum and minimum of old and new data and, if the minimum or
-       maximum has changed, rescale all old scaled data*/
-
-    double old_rw_min = G_1d.rw_min;
+    /* Find maximum and minimum of old and new data. Once the scaling is set
+       the scaled data stay relative to the minimum and the range of the data
+       at that moment, so a new minimum or maximum doesn't require touching
+       the old data. Only in full scale mode the y-scaling of the curves has
+       to be adjusted to the new range, otherwise nothing visible changes. */
 
     if ( get_new_extrema( &G_1d.rw_max, &G_1d.rw_min, ptr, len, type ) )
     {
-        double new_rwc_delta_y = G_1d.rw_max - G_1d.rw_min;
-
         if ( G_1d.is_scale_set )
         {
-            double factor = G_1d.rwc_delta[ Y ] / new_rwc_delta_y;
-            double offset = ( old_rw_min - G_1d.rw_min ) / new_rwc_delta_y;
-
-            Curve_1d_T * cv = G_1d.curve[ 0 ];
-            for ( long i = 0; i < G_1d.nc; cv = G_1d.curve[ ++i ] )
+            if ( G_1d.is_fs )
             {
-                Scaled_Point_T * sp = cv->points;
-                for ( long count = cv->count; count > 0; sp++ )
-                {
-                    sp->v = factor * sp->v + offset;
-                    count--;
-                }
-
-                if ( G_1d.is_fs )
-                    continue;
-
-                cv->s2d[ Y ]  /= factor;
-                cv->shift[ Y ] = factor * cv->shift[ Y ] - offset;
+                fs_adjust_y_1d( );
+                Scale_1d_changed[ Y ] = true;
             }
         }
+        else if ( G_1d.rw_max != G_1d.rw_min )
+        {
+            /* If the data had not been scaled to [0,1] yet and the maximum
+               value isn't identical to the minimum anymore do the scaling
+               now */
 
-        /* If the data had not been scaled to [0,1] yet and the maximum value
-           isn't identical to the minimum anymore do the scaling now */
+            G_1d.rwc_start[ Y ] = G_1d.rw_min;
+            G_1d.rwc_delta[ Y ] = G_1d.rw_max - G_1d.rw_min;
 
-        if ( ! G_1d.is_scale_set && G_1d.rw_max != G_1d.rw_min )
-        {
-            double factor = 1.0 / new_rwc_delta_y;
-            double offset = - G_1d.rw_min / new_rwc_delta_y;
+            double factor = 1.0 / G_1d.rwc_delta[ Y ];
+            double offset = - G_1d.rw_min / G_1d.rwc_delta[ Y ];
 
             Curve_1d_T * cv = G_1d.curve[ 0 ];
             for ( long i = 0; i < G_1d.nc; cv = G_1d.curve[ ++i ] )
             {
-                Scaled_Point_T * sp = cv->points;
-                for ( long count = cv->count; count > 0; sp++, count-- )
-                    sp->v = factor * sp->v + offset;
+                rescale_points( cv->points, G_1d.nx, factor, offset );
+                cv->lod_size = 0;
             }
 
             Scale_1d_changed[ X ] = true;
             G_1d.is_scale_set = true;
+            Scale_1d_changed[ Y ] = true;
         }
-
-        Scale_1d_changed[ Y ] = true;
-        G_1d.rwc_delta[ Y ] = new_rwc_delta_y;
     }
 
     /* Now we're finished with rescaling we can deal with the new data. First
@@ -832,7 +1029,9 @@ accept_1d_data_sliding( long         curve,
     }
 
     /* Remove old points of all curves that wouldn't fit into the window
-       anymore */
+       anymore. The points of each curve are stored in a ring buffer, so
+       this just requires unsetting them and moving the start index of the
+       curve, and all curves then need new XPoints. */
 
     if ( G_1d.curve[ curve ]->count + len > G_1d.nx )
     {
@@ -841,27 +1040,20 @@ accept_1d_data_sliding( long         curve,
         for ( long i = 0; i < G_1d.nc; i++ )
         {
             Curve_1d_T * cv = G_1d.curve[ i ];
-            if ( shift >= cv->count )
+            long drop = l_min( shift, cv->count );
+
+            for ( long count = 0; count < drop; count++ )
             {
-                Scaled_Point_T * sp = cv->points;
-                for ( long count = cv->count; count > 0; sp++, count-- )
-                    sp->exist = false;
-                cv->count = 0;
+                cv->points[ cv->start ] = NO_POINT;
+                lod_point_changed_1d( cv, cv->start );
+                if ( ++cv->start == G_1d.nx )
+                    cv->start = 0;
             }
-            else
-            {
-                Scaled_Point_T * sp1 = cv->points,
-                               * sp2 = sp1 + shift;
-                long count;
-                for ( count = shift; count < cv->count; sp1++, sp2++, count++ )
-                    sp1->v = sp2->v;
 
-                for ( count -= shift, sp2 -= shift; count < cv->count;
-                      sp2++, count++ )
-                    sp2->exist = 0;
+            if ( ( cv->count -= drop ) == 0 )
+                cv->start = 0;
 
-                cv->count -= shift;
-            }
+            cv->needs_recalc = true;
         }
 
         Marker_1d_T * m = G_1d.marker_1d,
@@ -889,13 +1081,14 @@ accept_1d_data_sliding( long         curve,
         }
     }
 
-    /* Now append the new data */
+    /* Now append the new data (NaNs are dropped, in sliding window mode
+       the points of a curve can't have any gaps) */
 
     Curve_1d_T * cv = G_1d.curve[ curve ];
     const char * cur_ptr = ptr;
-    Scaled_Point_T * sp = cv->points + cv->count;
+    long index = ( cv->start + cv->count ) % G_1d.nx;
 
-    for ( long i = 0; i < len; sp++, i++ )
+    for ( long i = 0; i < len; i++ )
     {
         double data;
 
@@ -912,31 +1105,33 @@ accept_1d_data_sliding( long         curve,
             cur_ptr += sizeof data;
         }
 
+        if ( ! POINT_EXISTS( data ) )
+            continue;
+
         if ( G_1d.is_scale_set )
-            sp->v = ( data - G_1d.rw_min ) / G_1d.rwc_delta[ Y ];
+            cv->points[ index ] =
+                          ( data - G_1d.rwc_start[ Y ] ) / G_1d.rwc_delta[ Y ];
         else
-            sp->v = data;
+            cv->points[ index ] = data;
 
-        sp->exist = true;
-    }
+        lod_point_changed_1d( cv, index );
 
-    cv->count += len;
+        if ( ++index == G_1d.nx )
+            index = 0;
 
-    /* Calculate new points for display (unless no scale is set yet) */
+        cv->count++;
+    }
 
-    if ( G_1d.is_scale_set )
-    {
-        G_1d.rwc_start[ Y ] = G_1d.rw_min;
+    /* The points for display are only calculated when the canvas gets
+       redrawn after all new data have been accepted. If the scale did not
+       change this is needed for the current curve only (unless old points
+       had to be removed), otherwise for all curves. */
 
-        /* If the scale did not change recalculate the points of the current
-           curve only, otherwise the points of all curves */
+    cv->needs_recalc = true;
 
-        if ( ! ( Scale_1d_changed[ X ] || Scale_1d_changed[ Y ] ) )
-            recalc_XPoints_of_curve_1d( G_1d.curve[ curve ] );
-        else
-            for ( long i = 0; i < G_1d.nc; i++ )
-                recalc_XPoints_of_curve_1d( G_1d.curve[ i ] );
-    }
+    if ( Scale_1d_changed[ X ] || Scale_1d_changed[ Y ] )
+        for ( long i = 0; i < G_1d.nc; i++ )
+            G_1d.curve[ i ]->needs_recalc = true;
 }
 
 
@@ -1014,52 +1209,32 @@ static void accept_2d_data( long         x_index,
         size_changed = true;
     }
 
-    /* Find maximum and minimum of old and new data. If the minimum or
-       maximum changed, (re)scale all old data */
-
-    double old_rw_min = cv->rw_min;
+    /* Find maximum and minimum of old and new data. As for the 1D display
+       the scaled data don't change once the scaling is set, in full scale
+       mode just the z-scaling gets adjusted to the new range. Only when the
+       data haven't been scaled yet all points need to be dealt with (this
+       can include the unused elements of the arrays, they're all unset) */
 
     if ( get_new_extrema( &cv->rw_max, &cv->rw_min, ptr, x_len, type ) )
     {
-        double new_rwc_delta_z = cv->rw_max - cv->rw_min;
-
         if ( cv->is_scale_set )
         {
-            double factor = cv->rwc_delta[ Z ] / new_rwc_delta_z;
-            double offset = ( old_rw_min - cv->rw_min ) / new_rwc_delta_z;
-
-            Scaled_Point_T * sp = cv->points;
-            for ( long count = cv->count; count > 0; sp++ )
-                if ( sp->exist )
-                {
-                    sp->v = factor * sp->v + offset;
-                    count--;
-                }
-
-            if ( ! cv->is_fs )
-            {
-                cv->s2d[ Z ] /= factor;
-                cv->shift[ Z ] = factor * cv->shift[ Z ] - offset;
-                cv->z_factor /= factor;
-            }
+            if ( cv->is_fs )
+                fs_adjust_z_2d( cv );
         }
+        else if ( cv->rw_max != cv->rw_min )
+        {
+            /* If data have not been scaled yet to the interval [0,1] and the
+               maximum value isn't identical to the minimum value anymore
+               calculate the scaling */
 
-        /* If data have not been scaled yet to the interval [0,1] and the
-           maximum value isn't identical to the minimum value anymore
-           calculate the scaling */
+            long num_points = G_2d.nx_max * G_2d.ny_max;
 
-        if ( ! cv->is_scale_set && cv->rw_max != cv->rw_min )
-        {
-            double factor = 1.0 / new_rwc_delta_z;
-            double offset = - cv->rw_min / new_rwc_delta_z;
+            cv->rwc_start[ Z ] = cv->rw_min;
+            cv->rwc_delta[ Z ] = cv->rw_max - cv->rw_min;
 
-            Scaled_Point_T *sp = cv->points;
-            for ( long count = cv->count; count > 0; sp++ )
-                if ( sp->exist )
-                {
-                    sp->v = factor * sp->v + offset;
-                    count--;
-                }
+            rescale_points( cv->points, num_points, 1.0 / cv->rwc_delta[ Z ],
+                            - cv->rw_min / cv->rwc_delta[ Z ] );
 
             cv->is_scale_set = true;
 
@@ -1068,8 +1243,7 @@ static void accept_2d_data( long         x_index,
         }
 
         Scale_2d_changed[ Z ] |= cv->active && cv->is_fs;
-        Need_cut_redraw |= cut_data_rescaled( curve, cv->rw_min, cv->rw_max );
-        cv->rwc_delta[ Z ] = new_rwc_delta_z;
+        Need_cut_redraw |= cut_data_rescaled( curve );
     }
 
     /* Now we're finished with rescaling and can set the new number of points
@@ -1086,7 +1260,7 @@ static void accept_2d_data( long         x_index,
     {
         const char * cur_ptr = ptr;
         long end_index = x_index + x_len;
-        Scaled_Point_T * sp = cv->points + y_index * G_2d.nx + x_index;
+        double * sp = cv->points + y_index * G_2d.nx_max + x_index;
 
         for ( long i = x_index; i < end_index; sp++, i++ )
         {
@@ -1105,19 +1279,17 @@ static void accept_2d_data( long         x_index,
                 cur_ptr += sizeof data;
             }
 
+            /* Increase the point count if the point is new (a NaN as the
+               new value removes the point) */
+
+            bool existed = POINT_EXISTS( *sp );
+
             if ( cv->is_scale_set )
-                sp->v = ( data - cv->rw_min ) / cv->rwc_delta[ Z ];
+                *sp = ( data - cv->rwc_start[ Z ] ) / cv->rwc_delta[ Z ];
             else
-                sp->v = data;
+                *sp = data;
 
-            /* Increase the point count if the point is new and mark it as
-               set */
-
-            if ( ! sp->exist )
-            {
-                cv->count++;
-                sp->exist = true;
-            }
+            cv->count += POINT_EXISTS( *sp ) - existed;
         }
 
         /* Tell the cross section handler about the new data, its return value
@@ -1132,7 +1304,7 @@ static void accept_2d_data( long         x_index,
 
         for ( long i = y_index; i <= end_index; i++ )
         {
-            Scaled_Point_T * sp = cv->points + i * G_2d.nx + x_index;
+            double * sp = cv->points + i * G_2d.nx_max + x_index;
             memcpy( &x_len, cur_ptr, sizeof x_len );
             cur_ptr += sizeof x_len;
 
@@ -1153,19 +1325,17 @@ static void accept_2d_data( long         x_index,
                     cur_ptr += sizeof data;
                 }
 
+                /* Increase the point count if the point is new (a NaN as the
+                   new value removes the point) */
+
+                bool existed = POINT_EXISTS( *sp );
+
                 if ( cv->is_scale_set )
-                    sp->v = ( data - cv->rw_min ) / cv->rwc_delta[ Z ];
+                    *sp = ( data - cv->rwc_start[ Z ] ) / cv->rwc_delta[ Z ];
                 else
-                    sp->v = data;
-
-                /* Increase the point count if the point is new and mark it as
-                   set */
+                    *sp = data;
 
-                if ( ! sp->exist )
-                {
-                    cv->count++;
-                    sp->exist = true;
-                }
+                cv->count += POINT_EXISTS( *sp ) - existed;
             }
 
             /* Tell the cross section handler about the new data, its return
@@ -1181,11 +1351,6 @@ static void accept_2d_data( long         x_index,
     if ( ! cv->is_scale_set )
         return;
 
-    /* Set flags that indicate what needs to be recalculated and what needs
-       to be redrawn */
-
-    cv->rwc_start[ Z ] = cv->rw_min;
-
     /* Since new points were included a recalculation of the current curve
        is required */
 
@@ -1379,27 +1544,13 @@ incr_x( long x_index,
         long len )
 {
     long new_Gnx = x_index + len;
-    long new_num = new_Gnx * G_2d.ny;
+
+    grow_2d_arrays( new_Gnx, G_2d.ny );
 
     for ( long i = 0; i < G_2d.nc; i++ )
     {
         Curve_2d_T * cv = G_2d.curve_2d[ i ];
 
-        Scaled_Point_T * old_points = cv->points;
-        Scaled_Point_T * sp = cv->points = T_malloc( new_num * sizeof *sp );
-
-        for ( long j = 0; j < G_2d.ny; j++ )
-        {
-            memcpy( sp, old_points + j * G_2d.nx, G_2d.nx * sizeof *sp );
-            sp += G_2d.nx;
-            for ( long k = G_2d.nx; k < new_Gnx; sp++, k++ )
-                sp->exist = false;
-        }
-
-        T_free( old_points );
-
-        cv->xpoints = T_realloc( cv->xpoints, new_num * sizeof *cv->xpoints );
-
         if ( cv->is_fs )
             cv->s2d[ X ] = ( double ) ( G_2d.canvas.w - 1 ) /
                            ( double ) ( new_Gnx - 1 );
@@ -1421,19 +1572,13 @@ static bool
 incr_y( long y_index )
 {
     long new_Gny = y_index + 1;
-    long new_num = G_2d.nx * new_Gny;
+
+    grow_2d_arrays( G_2d.nx, new_Gny );
 
     for ( long i = 0; i < G_2d.nc; i++ )
     {
         Curve_2d_T * cv = G_2d.curve_2d[ i ];
 
-        cv->points = T_realloc( cv->points, new_num * sizeof *cv->points );
-        cv->xpoints = T_realloc( cv->xpoints, new_num * sizeof *cv->xpoints );
-
-        Scaled_Point_T *sp = cv->points + G_2d.ny * G_2d.nx;
-        for ( long j = G_2d.ny * G_2d.nx; j < new_num; sp++, j++ )
-            sp->exist = false;
-
         if ( cv->is_fs )
             cv->s2d[ Y ] = ( double ) ( G_2d.canvas.h - 1 ) /
                            ( double ) ( new_Gny - 1 );
@@ -1458,33 +1603,12 @@ incr_x_and_y( long x_index,
 {
     long new_Gnx = x_index + len;
     long new_Gny = y_index + 1;
-    long new_num = new_Gnx * new_Gny;
+
+    grow_2d_arrays( new_Gnx, new_Gny );
 
     for ( long i = 0; i < G_2d.nc; i++ )
     {
         Curve_2d_T * cv = G_2d.curve_2d[ i ];
-        Scaled_Point_T * old_points = cv->points;
-        Scaled_Point_T * sp = cv->points = T_malloc( new_num * sizeof *sp );
-
-        /* Reorganise the old elements to fit into the new array and clear
-           the new elements in the already existing rows */
-
-        for ( long j = 0; j < G_2d.ny; j++ )
-        {
-            memcpy( sp, old_points + j * G_2d.nx, G_2d.nx * sizeof *sp );
-            sp += G_2d.nx;
-            for ( long k = G_2d.nx; k < new_Gnx; sp++, k++ )
-                sp->exist = false;
-        }
-
-        /* Now also set the elements in the comletely new rows to unused */
-
-        for ( long j = new_Gnx * G_2d.ny; j < new_num; sp++, j++ )
-            sp->exist = false;
-
-        T_free( old_points );
-
-        cv->xpoints = T_realloc( cv->xpoints, new_num * sizeof *cv->xpoints );
 
         if ( cv->is_fs )
         {
@@ -1504,6 +1628,90 @@ incr_x_and_y( long x_index,
 }
 
 
+/*---------------------------------------------------------------------*
+ * Makes sure the arrays for the data of all 2D curves have room for at
+ * least 'nx' points per row and 'ny' rows. Capacities that are too
+ * small get (at least) doubled, so adding data point by point, row by
+ * row or column by column only requires copying all data every now
+ * and then instead of each time. Rows are always G_2d.nx_max elements
+ * apart and all elements outside of the G_2d.nx times G_2d.ny points
+ * in use are kept unset.
+ *---------------------------------------------------------------------*/
+
+static void
+grow_2d_arrays( long nx,
+                long ny )
+{
+    long new_nx_max = G_2d.nx_max;
+    long new_ny_max = G_2d.ny_max;
+
+    if ( nx > new_nx_max )
+        new_nx_max = l_max( nx, 2 * new_nx_max );
+    if ( ny > new_ny_max )
+        new_ny_max = l_max( ny, 2 * new_ny_max );
+
+    if ( new_nx_max == G_2d.nx_max && new_ny_max == G_2d.ny_max )
+        return;
+
+    long old_num = G_2d.nx_max * G_2d.ny_max;
+    long new_num = new_nx_max * new_ny_max;
+
+    for ( long i = 0; i < G_2d.nc; i++ )
+    {
+        Curve_2d_T * cv = G_2d.curve_2d[ i ];
+
+        if ( new_nx_max == G_2d.nx_max )
+        {
+            /* If only further rows are needed they can simply be appended */
+
+            cv->points = T_realloc( cv->points, new_num * sizeof *cv->points );
+
+            for ( long j = old_num; j < new_num; j++ )
+                cv->points[ j ] = NO_POINT;
+        }
+        else
+        {
+            /* Otherwise the rows in use must be copied to their new
+               positions in a new array */
+
+            double * old_points = cv->points;
+            double * sp = cv->points = T_malloc( new_num * sizeof *sp );
+
+            for ( long j = 0; j < new_num; j++ )
+                sp[ j ] = NO_POINT;
+
+            for ( long j = 0; j < G_2d.ny; j++ )
+                memcpy( sp + j * new_nx_max, old_points + j * G_2d.nx_max,
+                        G_2d.nx * sizeof *sp );
+
+            T_free( old_points );
+        }
+
+        cv->xpoints = T_realloc( cv->xpoints, new_num * sizeof *cv->xpoints );
+    }
+
+    G_2d.nx_max = new_nx_max;
+    G_2d.ny_max = new_ny_max;
+}
+
+
+/*-------------------------------------------------------------------*
+ * Rescales the scaled data of a curve. Points that don't exist are
+ * marked by a NaN which doesn't change, so there's no need to check
+ * each point and the loop can be vectorized by the compiler.
+ *-------------------------------------------------------------------*/
+
+static void
+rescale_points( double * points,
+                long     num,
+                double   factor,
+                double   offset )
+{
+    for ( long i = 0; i < num; i++ )
+        points[ i ] = factor * points[ i ] + offset;
+}
+
+
 /*
  * Local variables:
  * tags-file-name: "../TAGS"
@@ -0,0 +1,1033 @@
+/*
+ *  Copyright (C) 1999-2016 Jens Thoms Toerring
+ *
+ *  This file is part of fsc2.
+ *
+ *  Fsc2 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3, or (at your option)
+ *  any later version.
+ *
+ *  Fsc2 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*---------------------------------------------------------------------------*
+ * Checkpoints for long running experiments, switched on by the
+ * '-checkpoint' command line option. Every few minutes (at the start of
+ * a statement) the state of the experiment, i.e. the position in the
+ * EXPERIMENT section, the state of all loops being run, the values of
+ * all variables and the lengths of the files written to, gets stored in
+ * a file next to the EDL script. If the experiment fails (or fsc2 or the
+ * computer crashes) it can be continued from the last checkpoint by
+ * starting it again with the '-resume' option: after the test run and
+ * the modules' exp hooks have been run as usual the variables and loops
+ * are restored, data written to the files after the checkpoint are
+ * removed and the experiment continues where the checkpoint was taken.
+ *
+ * To keep the experiment from being stalled the checkpoint file is
+ * written by a process forked off for the purpose. It got a copy of the
+ * memory of the experiment at the moment the checkpoint was taken (which,
+ * due to copy-on-write, is cheap) and can take its time. The experiment
+ * only has to wait for the data for the files the EDL script writes to
+ * having made it to the disk and for the fork() itself. The data files
+ * never get copied, just their lengths are stored. The process writing
+ * the checkpoint file is a grandchild that's never waited for, it tells
+ * via a pipe if it succeeded. The intermediate child exits immediately
+ * and is waited for with SIGCHLD blocked, so the SIGCHLD signal for it
+ * (which the experiment ignores) gets delivered at a well-defined moment
+ * and can't interrupt e.g. the communication with a device.
+ *
+ * Not stored are the contents of the display windows (they belong to the
+ * parent process) and the internal state of the device modules - after
+ * a resume the display is empty and the devices are in the state the
+ * modules' exp hooks have set them to.
+ *---------------------------------------------------------------------------*/
+
+
+#include "fsc2.h"
+#include "exp_parser_common.h"
+
+
+#define CKPT_MAGIC      "FSC2CKPT"
+#define CKPT_MAGIC_LEN  8
+#define CKPT_VERSION    1
+
+#define CKPT_RETRY      10          /* seconds to wait for the writer */
+
+#define CKPT_BUF_SIZE   65536       /* output buffer of the writer */
+
+/* Flags of variables that get stored and restored */
+
+#define CKPT_VAR_FLAGS  ( NEW_VARIABLE | IS_DYNAMIC | IS_TEMP )
+
+
+static char * Ckpt_Name = NULL;     /* name of the checkpoint file */
+static char * Ckpt_Tmp_Name = NULL; /* name while it's being written */
+static time_t Ckpt_Next = 0;        /* time the next checkpoint is due */
+static int Ckpt_Pipe = -1;          /* read end of pipe from writer */
+static bool Ckpt_Is_Written = false;
+
+static int Out_Fd;                  /* only used by the writer process */
+static bool Out_Failed;
+static size_t Out_Len;
+static unsigned char Out_Buf[ CKPT_BUF_SIZE ];
+
+static FILE * In_Fp;                /* only used when resuming */
+
+
+static bool writer_done( bool wait );
+static void write_checkpoint( int            status_fd,
+                              File_State_T * fs,
+                              int            num_files,
+                              int            file_flags );
+static void out_var( Var_T * v );
+static void out_simp_var( Simp_Var_T * sv );
+static void out_str( const char * str );
+static void out_long( long val );
+static void out_double( double val );
+static void out_data( const void * data,
+                      size_t       len );
+static void out_write( const void * data,
+                       size_t       len );
+static void resume( void );
+static void in_header( void );
+static void in_loops( void );
+static void in_vars( void );
+static void in_var( Var_T * v,
+                    long    type );
+static void clear_var( Var_T * v );
+static void in_files( void );
+static void in_simp_var( Simp_Var_T * sv );
+static char * in_str( void );
+static long in_long( void );
+static double in_double( void );
+static void in_data( void * data,
+                     size_t len );
+static void corrupted( void );
+
+
+/*-------------------------------------------------------------------*
+ * Sets up checkpointing and, if the '-resume' option was given,
+ * restores the state of the experiment from the checkpoint file. To
+ * be called by the child process immediately before the experiment
+ * starts. Throws an exception if resuming isn't possible.
+ *-------------------------------------------------------------------*/
+
+void
+checkpoint_init( void )
+{
+    if (    EDL.prg_length <= 0
+         || Fsc2_Internals.cmdline_flags & DO_CHECK
+         || (    ! CHECKPOINTING
+              && ! ( Fsc2_Internals.cmdline_flags & DO_RESUME ) ) )
+        return;
+
+    Ckpt_Name = get_string( "%s.checkpoint", EDL.files->name );
+    Ckpt_Tmp_Name = get_string( "%s.tmp", Ckpt_Name );
+
+    if ( Fsc2_Internals.cmdline_flags & DO_RESUME )
+        resume( );
+
+    if ( CHECKPOINTING )
+        Ckpt_Next = time( NULL ) + Fsc2_Internals.checkpoint_interval;
+}
+
+
+/*-------------------------------------------------------------------*
+ * Tells if it's time for a new checkpoint. Once the ON_STOP part of
+ * the EXPERIMENT section has been reached no checkpoints are taken
+ * anymore, there's nothing left worth resuming.
+ *-------------------------------------------------------------------*/
+
+bool
+checkpoint_due( void )
+{
+    return    Ckpt_Next != 0
+           && EDL.react_to_do_quit
+           && time( NULL ) >= Ckpt_Next;
+}
+
+
+/*-------------------------------------------------------------------*
+ * Takes a checkpoint, to be called at the start of a statement (i.e.
+ * with EDL.cur_prg_token pointing to it and nothing on the variable
+ * stack). If the checkpoint file from the previous one is still being
+ * written it's postponed a bit. Otherwise all data for the files get
+ * written out and the process for writing the checkpoint file gets
+ * started.
+ *-------------------------------------------------------------------*/
+
+void
+checkpoint_write( void )
+{
+    if ( ! writer_done( false ) )
+    {
+        Ckpt_Next = time( NULL ) + CKPT_RETRY;
+        return;
+    }
+
+    int num_files;
+    int file_flags;
+    File_State_T *fs = get_file_states( &num_files, &file_flags );
+
+    Ckpt_Next = time( NULL ) + Fsc2_Internals.checkpoint_interval;
+
+    int pd[ 2 ];
+    pid_t pid;
+    sigset_t new_mask,
+             old_mask;
+
+    if ( pipe( pd ) == -1 )
+    {
+        T_free( fs );
+        print( WARN, "Can't take checkpoint, no pipe available.\n" );
+        return;
+    }
+
+    sigemptyset( &new_mask );
+    sigaddset( &new_mask, SIGCHLD );
+    sigprocmask( SIG_BLOCK, &new_mask, &old_mask );
+
+    /* The child just forks again and quits, it's the grandchild that does
+       the real work */
+
+    if ( ( pid = fork( ) ) == 0 )
+    {
+        sigprocmask( SIG_SETMASK, &old_mask, NULL );
+        close( pd[ READ ] );
+        if ( fork( ) == 0 )
+            write_checkpoint( pd[ WRITE ], fs, num_files, file_flags );
+        _exit( EXIT_SUCCESS );
+    }
+
+    close( pd[ WRITE ] );
+    T_free( fs );
+
+    if ( pid == -1 )
+    {
+        sigprocmask( SIG_SETMASK, &old_mask, NULL );
+        close( pd[ READ ] );
+        print( WARN, "Can't take checkpoint, failed to start process for "
+               "writing it.\n" );
+        return;
+    }
+
+    while ( waitpid( pid, NULL, 0 ) == -1 && errno == EINTR )
+        /* empty */ ;
+
+    sigprocmask( SIG_SETMASK, &old_mask, NULL );
+
+    fcntl( pd[ READ ], F_SETFL, O_NONBLOCK );
+    Ckpt_Pipe = pd[ READ ];
+}
+
+
+/*-------------------------------------------------------------------*
+ * To be called by the child process when the experiment is finished.
+ * Waits for the checkpoint file still being written. If the experiment
+ * ended normally (including the user having stopped it) the checkpoint
+ * file isn't needed anymore and gets deleted, otherwise the user is
+ * told that the experiment can be resumed.
+ *-------------------------------------------------------------------*/
+
+void
+checkpoint_done( bool ok )
+{
+    if ( ! Ckpt_Name )
+        return;
+
+    writer_done( true );
+    Ckpt_Next = 0;
+
+    if ( ok )
+        unlink( Ckpt_Name );
+    else if ( Ckpt_Is_Written )
+        print( NO_ERROR, "The experiment can be resumed from the last "
+               "checkpoint by restarting it with the '-resume' option.\n" );
+
+    Ckpt_Name = T_free( Ckpt_Name );
+    Ckpt_Tmp_Name = T_free( Ckpt_Tmp_Name );
+}
+
+
+/*-------------------------------------------------------------------*
+ * Checks if the process writing the checkpoint file is done (if
+ * 'wait' is set it waits for this to happen). It writes a single
+ * byte to the pipe after it successfully renamed the new file to
+ * the name of the checkpoint file and then exits, closing the pipe.
+ *-------------------------------------------------------------------*/
+
+static bool
+writer_done( bool wait )
+{
+    char c;
+    ssize_t len;
+
+
+    if ( Ckpt_Pipe < 0 )
+        return true;
+
+    if ( wait )
+        fcntl( Ckpt_Pipe, F_SETFL, 0 );
+
+    while ( ( len = read( Ckpt_Pipe, &c, 1 ) ) == -1 && errno == EINTR )
+        /* empty */ ;
+
+    if ( len == -1 && errno == EAGAIN )
+        return false;
+
+    close( Ckpt_Pipe );
+    Ckpt_Pipe = -1;
+
+    if ( len == 1 )
+        Ckpt_Is_Written = true;
+    else
+        print( WARN, "Failed to write checkpoint file '%s'.\n", Ckpt_Name );
+
+    return true;
+}
+
+
+/*-------------------------------------------------------------------*
+ * Writes the checkpoint file, run by the process forked off for this
+ * purpose, which never returns. Since the experiment process may use
+ * threads (for writing the data files) only functions that are safe
+ * to be used after a fork() get called, e.g. no memory is allocated.
+ * The file first gets written to a temporary file which, after it and
+ * the data files are safely on the disk, is renamed, so there's always
+ * a complete checkpoint file. The file is in a binary format with the
+ * machine's byte order, consisting of
+ *  - a header with the sizes of longs and doubles, the version of the
+ *    format, if the EXPERIMENT section was compiled, the modification
+ *    times of the EDL files, the number of program tokens and the
+ *    index of the token the experiment is to continue with
+ *  - a record for each loop being run, i.e. its program token index,
+ *    the token type, the loop counter and, for REPEAT and FOR loops,
+ *    the rest of their state, ended by an index of -1
+ *  - the name, type, flags and values of all variables (for matrices
+ *    recursively those of their sub-matrices), ended by an empty name
+ *  - flags and the number of entries of the list of files opened by
+ *    the script, followed by their names, types and lengths (for
+ *    compressed files also the CRC32 and length of the uncompressed
+ *    data written to them).
+ *-------------------------------------------------------------------*/
+
+static void
+write_checkpoint( int            status_fd,
+                  File_State_T * fs,
+                  int            num_files,
+                  int            file_flags )
+{
+    int dfl_sigs[ ] = { SIGQUIT, SIGILL, SIGABRT, SIGFPE, SIGSEGV,
+                        SIGPIPE, SIGTERM, SIGBUS };
+    int ign_sigs[ ] = { SIGHUP, SIGINT, SIGUSR1, SIGUSR2, SIGALRM,
+                        SIGVTALRM };
+
+
+    /* Get rid of the signal handlers of the experiment process, deadly
+       signals should just kill us. Also close the pipes to the parent, we
+       don't want to keep the parent from noticing the experiment died. */
+
+    for ( size_t i = 0; i < NUM_ELEMS( dfl_sigs ); i++ )
+        signal( dfl_sigs[ i ], SIG_DFL );
+    for ( size_t i = 0; i < NUM_ELEMS( ign_sigs ); i++ )
+        signal( ign_sigs[ i ], SIG_IGN );
+
+    close( Comm.pd[ READ ] );
+    close( Comm.pd[ WRITE ] );
+
+    /* Make sure the data files are on the disk */
+
+    for ( int i = 0; i < num_files; i++ )
+    {
+        int fd;
+
+        if ( fs[ i ].is_open && ( fd = open( fs[ i ].name, O_RDONLY ) ) >= 0 )
+        {
+            fsync( fd );
+            close( fd );
+        }
+    }
+
+    if ( ( Out_Fd = open( Ckpt_Tmp_Name, O_WRONLY | O_CREAT | O_TRUNC,
+                          S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH ) ) < 0 )
+        _exit( EXIT_FAILURE );
+
+    Out_Failed = false;
+    Out_Len = 0;
+
+    /* Header */
+
+    unsigned char sizes[ 2 ] = { sizeof( long ), sizeof( double ) };
+
+    out_data( CKPT_MAGIC, CKPT_MAGIC_LEN );
+    out_data( sizes, sizeof sizes );
+    out_long( CKPT_VERSION );
+    out_long( exp_is_compiled( ) );
+    out_long( EDL.file_count );
+    for ( size_t i = 0; i < EDL.file_count; i++ )
+        out_long( EDL.files[ i ].mod_date );
+    out_long( EDL.prg_length );
+    out_long( EDL.cur_prg_token - EDL.prg_token );
+
+    /* Loops */
+
+    for ( long i = 0; i < EDL.prg_length; i++ )
+    {
+        Prg_Token_T *tok = EDL.prg_token + i;
+
+        if ( tok->counter == 0 )
+            continue;
+
+        out_long( i );
+        out_long( tok->token );
+        out_long( tok->counter );
+
+        if ( tok->token == REPEAT_TOK )
+        {
+            out_long( tok->count.repl.max );
+            out_long( tok->count.repl.act );
+        }
+        else if ( tok->token == FOR_TOK )
+        {
+            out_simp_var( &tok->count.forl.end );
+            out_simp_var( &tok->count.forl.incr );
+        }
+    }
+
+    out_long( -1 );
+
+    /* Variables */
+
+    for ( Var_T *v = EDL.Var_List; v; v = v->next )
+        if ( v->name && v->type & RHS_TYPES )
+        {
+            out_str( v->name );
+            out_var( v );
+        }
+
+    out_str( NULL );
+
+    /* Files */
+
+    out_long( file_flags );
+    out_long( num_files );
+
+    for ( int i = 0; i < num_files; i++ )
+    {
+        out_str( fs[ i ].name );
+        out_long( fs[ i ].is_open );
+        out_long( fs[ i ].gzip );
+        out_long( fs[ i ].binary );
+        out_long( fs[ i ].offset );
+        out_long( fs[ i ].crc );
+        out_long( fs[ i ].size );
+    }
+
+    out_write( Out_Buf, Out_Len );
+
+    if (    Out_Failed
+         || fsync( Out_Fd ) == -1
+         || close( Out_Fd ) == -1
+         || rename( Ckpt_Tmp_Name, Ckpt_Name ) == -1 )
+    {
+        unlink( Ckpt_Tmp_Name );
+        _exit( EXIT_FAILURE );
+    }
+
+    _exit( write( status_fd, "", 1 ) == 1 ? EXIT_SUCCESS : EXIT_FAILURE );
+}
+
+
+/*----------------------------------------------------------------*
+ * Writes out the type, dimension, length, flags and values of a
+ * variable. For matrices the sub-matrices are written recursively,
+ * with just a type of UNDEF_VAR for sub-matrices that don't exist.
+ *----------------------------------------------------------------*/
+
+static void
+out_var( Var_T * v )
+{
+    out_long( v->type );
+    out_long( v->dim );
+    out_long( v->len );
+    out_long( v->flags & CKPT_VAR_FLAGS );
+
+    switch ( v->type )
+    {
+        case INT_VAR :
+            out_long( v->val.lval );
+            break;
+
+        case FLOAT_VAR :
+            out_double( v->val.dval );
+            break;
+
+        case INT_ARR :
+            out_data( v->val.lpnt, v->len * sizeof *v->val.lpnt );
+            break;
+
+        case FLOAT_ARR :
+            out_data( v->val.dpnt, v->len * sizeof *v->val.dpnt );
+            break;
+
+        case INT_REF : case FLOAT_REF :
+            for ( ssize_t i = 0; i < v->len; i++ )
+                if ( v->val.vptr[ i ] )
+                    out_var( v->val.vptr[ i ] );
+                else
+                    out_long( UNDEF_VAR );
+            break;
+
+        default :
+            break;
+    }
+}
+
+
+/*----------------------------------------------------*
+ * Writes out a value of a FOR loop (end or increment)
+ *----------------------------------------------------*/
+
+static void
+out_simp_var( Simp_Var_T * sv )
+{
+    out_long( sv->type );
+    out_long( sv->lval );
+    out_double( sv->dval );
+}
+
+
+/*--------------------------------------------------------------*
+ * Writes out a string, preceded by its length (-1 for no string)
+ *--------------------------------------------------------------*/
+
+static void
+out_str( const char * str )
+{
+    if ( ! str )
+    {
+        out_long( -1 );
+        return;
+    }
+
+    size_t len = strlen( str );
+
+    out_long( len );
+    out_data( str, len );
+}
+
+
+/*--------------------------------------*
+ *--------------------------------------*/
+
+static void
+out_long( long val )
+{
+    out_data( &val, sizeof val );
+}
+
+
+/*--------------------------------------*
+ *--------------------------------------*/
+
+static void
+out_double( double val )
+{
+    out_data( &val, sizeof val );
+}
+
+
+/*---------------------------------------------------------------*
+ * Appends data to the output buffer, which gets written out when
+ * it's full. Large amounts of data (i.e. arrays) are written out
+ * directly.
+ *---------------------------------------------------------------*/
+
+static void
+out_data( const void * data,
+          size_t       len )
+{
+    if ( Out_Len + len > CKPT_BUF_SIZE )
+    {
+        out_write( Out_Buf, Out_Len );
+        Out_Len = 0;
+    }
+
+    if ( len >= CKPT_BUF_SIZE )
+        out_write( data, len );
+    else
+    {
+        memcpy( Out_Buf + Out_Len, data, len );
+        Out_Len += len;
+    }
+}
+
+
+/*--------------------------------------------------------------*
+ * Writes data to the checkpoint file, on failure just a flag is
+ * set and everything else is skipped.
+ *--------------------------------------------------------------*/
+
+static void
+out_write( const void * data,
+           size_t       len )
+{
+    const char *p = data;
+
+
+    while ( len > 0 && ! Out_Failed )
+    {
+        ssize_t count = write( Out_Fd, p, len );
+
+        if ( count == -1 )
+        {
+            if ( errno != EINTR )
+                Out_Failed = true;
+            continue;
+        }
+
+        p   += count;
+        len -= count;
+    }
+}
+
+
+/*-------------------------------------------------------------------*
+ * Restores the state of the experiment from the checkpoint file.
+ * This requires that neither the EDL script nor one of the files it
+ * includes have been changed since the checkpoint was taken and that
+ * the EXPERIMENT section is also again either compiled or interpreted.
+ *-------------------------------------------------------------------*/
+
+static void
+resume( void )
+{
+    if ( ! ( In_Fp = fopen( Ckpt_Name, "r" ) ) )
+    {
+        print( FATAL, "Can't open checkpoint file '%s' for resuming the "
+               "experiment.\n", Ckpt_Name );
+        THROW( EXCEPTION );
+    }
+
+    TRY
+    {
+        in_header( );
+        in_loops( );
+        in_vars( );
+        in_files( );
+        TRY_SUCCESS;
+    }
+    OTHERWISE
+    {
+        fclose( In_Fp );
+        RETHROW;
+    }
+
+    fclose( In_Fp );
+
+    print( NO_ERROR, "Resuming experiment from checkpoint at %s:%ld.\n",
+           EDL.cur_prg_token->Fname, EDL.cur_prg_token->Lc );
+    print( WARN, "Data displayed before the checkpoint can't be restored, "
+           "the display only shows new data.\n" );
+}
+
+
+/*-------------------------------------------------------------------*
+ * Reads the header of the checkpoint file and checks that it fits
+ * the EDL script, then sets the token the experiment continues with.
+ *-------------------------------------------------------------------*/
+
+static void
+in_header( void )
+{
+    char magic[ CKPT_MAGIC_LEN ];
+    unsigned char sizes[ 2 ];
+
+
+    in_data( magic, CKPT_MAGIC_LEN );
+    in_data( sizes, sizeof sizes );
+
+    if (    memcmp( magic, CKPT_MAGIC, CKPT_MAGIC_LEN )
+         || sizes[ 0 ] != sizeof( long )
+         || sizes[ 1 ] != sizeof( double )
+         || in_long( ) != CKPT_VERSION )
+    {
+        print( FATAL, "'%s' isn't a checkpoint file that can be used with "
+               "this version of fsc2.\n", Ckpt_Name );
+        THROW( EXCEPTION );
+    }
+
+    if ( in_long( ) != exp_is_compiled( ) )
+    {
+        print( FATAL, "Checkpoint was taken %s the '-noBytecode' option, "
+               "%s for resuming.\n",
+               exp_is_compiled( ) ? "with" : "without",
+               exp_is_compiled( ) ? "it's also needed" : "it can't be used" );
+        THROW( EXCEPTION );
+    }
+
+    bool is_changed = in_long( ) != ( long ) EDL.file_count;
+
+    for ( size_t i = 0; ! is_changed && i < EDL.file_count; i++ )
+        is_changed = in_long( ) != ( long ) EDL.files[ i ].mod_date;
+
+    if ( is_changed || in_long( ) != EDL.prg_length )
+    {
+        print( FATAL, "EDL script has been changed since the checkpoint "
+               "was taken, can't resume.\n" );
+        THROW( EXCEPTION );
+    }
+
+    long pos = in_long( );
+
+    if ( pos < 0 || pos >= EDL.prg_length )
+        corrupted( );
+
+    EDL.cur_prg_token = EDL.prg_token + pos;
+}
+
+
+/*-------------------------------------------------------------------*
+ * Restores the state of the loops that were being run. For a FOR
+ * loop also the pointer to the loop variable needs to be set since
+ * it isn't set up again when the loop is already running.
+ *-------------------------------------------------------------------*/
+
+static void
+in_loops( void )
+{
+    long pos;
+
+
+    while ( ( pos = in_long( ) ) != -1 )
+    {
+        if ( pos < 0 || pos >= EDL.prg_length )
+            corrupted( );
+
+        Prg_Token_T *tok = EDL.prg_token + pos;
+
+        if ( in_long( ) != tok->token )
+            corrupted( );
+
+        tok->counter = in_long( );
+
+        if ( tok->token == REPEAT_TOK )
+        {
+            tok->count.repl.max = in_long( );
+            tok->count.repl.act = in_long( );
+        }
+        else if ( tok->token == FOR_TOK )
+        {
+            tok->count.forl.act = ( tok + 1 )->tv.vptr;
+            in_simp_var( &tok->count.forl.end );
+            in_simp_var( &tok->count.forl.incr );
+        }
+    }
+}
+
+
+/*-------------------------------------------------------------------*
+ * Restores the values of all variables, the variables themselves
+ * (but not sub-matrices) must already exist since the script didn't
+ * change.
+ *-------------------------------------------------------------------*/
+
+static void
+in_vars( void )
+{
+    char *name;
+
+
+    while ( ( name = in_str( ) ) != NULL )
+    {
+        Var_T *v = vars_get( name );
+
+        T_free( name );
+
+        long type = in_long( );
+
+        if ( ! v || ! ( type & RHS_TYPES ) )
+            corrupted( );
+
+        clear_var( v );
+        in_var( v, type );
+    }
+}
+
+
+/*-------------------------------------------------------------------*
+ * Reads the dimension, length, flags and values of a variable (its
+ * type has already been read), for matrices the sub-matrices get
+ * created as they would when assigning to the matrix.
+ *-------------------------------------------------------------------*/
+
+static void
+in_var( Var_T * v,
+        long    type )
+{
+    v->type = type;
+    v->dim  = in_long( );
+
+    ssize_t len = in_long( );
+
+    v->flags &= ~ CKPT_VAR_FLAGS;
+    v->flags |= in_long( ) & CKPT_VAR_FLAGS;
+
+    if ( len < 0 )
+        corrupted( );
+
+    switch ( type )
+    {
+        case INT_VAR :
+            v->val.lval = in_long( );
+            break;
+
+        case FLOAT_VAR :
+            v->val.dval = in_double( );
+            break;
+
+        case INT_ARR :
+            if ( len == 0 )
+                break;
+            v->val.lpnt = T_malloc( len * sizeof *v->val.lpnt );
+            v->len = len;
+            in_data( v->val.lpnt, len * sizeof *v->val.lpnt );
+            break;
+
+        case FLOAT_ARR :
+            if ( len == 0 )
+                break;
+            v->val.dpnt = T_malloc( len * sizeof *v->val.dpnt );
+            v->len = len;
+            in_data( v->val.dpnt, len * sizeof *v->val.dpnt );
+            break;
+
+        case INT_REF : case FLOAT_REF :
+            if ( len == 0 )
+                break;
+
+            v->val.vptr = T_malloc( len * sizeof *v->val.vptr );
+            for ( ssize_t i = 0; i < len; i++ )
+                v->val.vptr[ i ] = NULL;
+            v->len = len;
+
+            for ( ssize_t i = 0; i < len; i++ )
+            {
+                long sub_type = in_long( );
+
+                if ( sub_type == UNDEF_VAR )
+                    continue;
+
+                if ( ! ( sub_type & RHS_TYPES ) )
+                    corrupted( );
+
+                Var_T *vd = v->val.vptr[ i ] = vars_new( NULL );
+                vd->from = v;
+                vd->flags &= ~ NEW_VARIABLE;
+                in_var( vd, sub_type );
+            }
+            break;
+
+        default :
+            corrupted( );
+    }
+}
+
+
+/*-------------------------------------------------------------------*
+ * Gets rid of the data of an array or matrix (including all of its
+ * sub-matrices) before new values are read in.
+ *-------------------------------------------------------------------*/
+
+static void
+clear_var( Var_T * v )
+{
+    switch ( v->type )
+    {
+        case INT_ARR :
+            if ( v->len != 0 )
+                v->val.lpnt = T_free( v->val.lpnt );
+            break;
+
+        case FLOAT_ARR :
+            if ( v->len != 0 )
+                v->val.dpnt = T_free( v->val.dpnt );
+            break;
+
+        case INT_REF : case FLOAT_REF :
+            if ( v->len == 0 )
+                break;
+            if ( ! ( v->flags & DONT_RECURSE ) )
+                for ( ssize_t i = 0; i < v->len; i++ )
+                    if ( v->val.vptr[ i ] )
+                        vars_free( v->val.vptr[ i ], true );
+            v->val.vptr = T_free( v->val.vptr );
+            break;
+
+        default :
+            break;
+    }
+
+    v->len = 0;
+}
+
+
+/*-------------------------------------------------------------------*
+ * Reads the list of files the script had opened and reopens them.
+ *-------------------------------------------------------------------*/
+
+static void
+in_files( void )
+{
+    int file_flags = in_long( );
+    long num_files = in_long( );
+    File_State_T fs;
+
+
+    if ( num_files < 0 || num_files > INT_MAX - 2 )
+        corrupted( );
+
+    for ( long i = 0; i < num_files; i++ )
+    {
+        fs.name    = in_str( );
+        fs.is_open = in_long( );
+        fs.gzip    = in_long( );
+        fs.binary  = in_long( );
+        fs.offset  = in_long( );
+        fs.crc     = in_long( );
+        fs.size    = in_long( );
+
+        TRY
+        {
+            if ( fs.is_open && ( ! fs.name || fs.offset < 0 ) )
+                corrupted( );
+            restore_file( &fs );
+            TRY_SUCCESS;
+        }
+        OTHERWISE
+        {
+            T_free( fs.name );
+            RETHROW;
+        }
+
+        T_free( fs.name );
+    }
+
+    restore_file_flags( file_flags );
+}
+
+
+/*-------------------------------------------------------*
+ * Reads a value of a FOR loop (end or increment value)
+ *-------------------------------------------------------*/
+
+static void
+in_simp_var( Simp_Var_T * sv )
+{
+    sv->type = in_long( );
+    sv->lval = in_long( );
+    sv->dval = in_double( );
+}
+
+
+/*-----------------------------------------------------------------*
+ * Reads a string, returns it in allocated memory or NULL if there
+ * was no string.
+ *-----------------------------------------------------------------*/
+
+static char *
+in_str( void )
+{
+    long len = in_long( );
+
+
+    if ( len == -1 )
+        return NULL;
+
+    if ( len < 0 || len > PATH_MAX )
+        corrupted( );
+
+    char *str = T_malloc( len + 1 );
+
+    TRY
+    {
+        in_data( str, len );
+        TRY_SUCCESS;
+    }
+    OTHERWISE
+    {
+        T_free( str );
+        RETHROW;
+    }
+
+    str[ len ] = '\0';
+    return str;
+}
+
+
+/*--------------------------------------*
+ *--------------------------------------*/
+
+static long
+in_long( void )
+{
+    long val;
+
+
+    in_data( &val, sizeof val );
+    return val;
+}
+
+
+/*--------------------------------------*
+ *--------------------------------------*/
+
+static double
+in_double( void )
+{
+    double val;
+
+
+    in_data( &val, sizeof val );
+    return val;
+}
+
+
+/*--------------------------------------*
+ *--------------------------------------*/
+
+static void
+in_data( void * data,
+         size_t len )
+{
+    if ( len > 0 && fread( data, 1, len, In_Fp ) != len )
+        corrupted( );
+}
+
+
+/*--------------------------------------*
+ *--------------------------------------*/
+
+static void
+corrupted( void )
+{
+    print( FATAL, "Checkpoint file '%s' is corrupted.\n", Ckpt_Name );
+    THROW( EXCEPTION );
+}
+
+
+/*
+ * Local variables:
+ * tags-file-name: "../TAGS"
+ * tab-width: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,53 @@
+/*
+ *  Copyright (C) 1999-2014 Jens Thoms Toerring
+ *
+ *  This file is part of fsc2.
+ *
+ *  Fsc2 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3, or (at your option)
+ *  any later version.
+ *
+ *  Fsc2 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+#if ! defined CHECKPOINT_HEADER
+#define CHECKPOINT_HEADER
+
+
+#include "fsc2.h"
+
+
+/* Tells if checkpoints are to be written while the experiment is running
+   (only the child process running the experiment ever writes them) */
+
+#define CHECKPOINTING  ( Fsc2_Internals.checkpoint_interval > 0 )
+
+
+void checkpoint_init( void );
+
+bool checkpoint_due( void );
+
+void checkpoint_write( void );
+
+void checkpoint_done( bool /* ok */ );
+
+
+#endif   /* ! CHECKPOINT_HEADER */
+
+
+/*
+ * Local variables:
+ * tags-file-name: "../TAGS"
+ * tab-width: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -136,7 +136,8 @@ setup_comm( void )
        memory buffers with the data the parent is supposed to display. */
 
     if ( ( Comm.MQ = ( Message_Queue_T * ) get_shm( &Comm.MQ_ID,
-                                                  sizeof *Comm.MQ ) ) == NULL )
+                                                    sizeof *Comm.MQ,
+                                                    true ) ) == NULL )
     {
         Comm.MQ_ID = -1;
         for ( int i = 0; i < 4; i++ )
@@ -151,6 +152,15 @@ setup_comm( void )
     for ( int i = 0; i < QUEUE_SIZE; i++ )
         Comm.MQ->slot[ i ].shm_id = -1;
 
+    /* The data the child sends get written into a ring buffer in shared
+       memory that's set up here once for the whole experiment (if this
+       fails each data set gets passed in a segment of its own). */
+
+    Comm.MQ->ring_used = Comm.MQ->ring_freed = 0;
+    if ( ( Comm.data_ring = get_shm( &Comm.data_ring_ID, DATA_RING_SIZE,
+                                     false ) ) == NULL )
+        Comm.data_ring_ID = -1;
+
     /* Beside the pipes and the key buffer we need a semaphore which allows
        the parent to control when the child is allowed to send data and
        messages. Its size has to be at least by one element smaller than the
@@ -315,14 +325,66 @@ new_data_handler( void )
 }
 
 
-/*-------------------------------------------------------------*
- * Called whenever the child needs to send data to the parent.
- *-------------------------------------------------------------*/
+/*----------------------------------------------------------------------*
+ * Called by the child to get a buffer of 'len' bytes for data to be
+ * send to the parent. Normally the buffer is in the ring buffer, where
+ * the parent releases the space for the data in the same order as they
+ * were sent, so the space still in use is always the part between the
+ * number of bytes ever used and ever released by the parent. If there
+ * isn't enough room left the child waits until the parent has caught
+ * up. A data set that doesn't fit at the end of the ring buffer starts
+ * at its beginning instead, with the bytes skipped at the end being
+ * accounted for as part of the data set. Nothing gets marked as used
+ * before send_data() is called, so a buffer that never gets send (e.g.
+ * due to an exception) doesn't need to be released. Returns NULL if no
+ * shared memory segment could be obtained for a large data set.
+ *----------------------------------------------------------------------*/
+
+void *
+get_data_buffer( Data_Buffer_T * db,
+                 long            len )
+{
+    /* Round up to a multiple of the size of a double */
+
+    unsigned long size = ( len + sizeof( double ) - 1 )
+                         & ~ ( sizeof( double ) - 1 );
+
+    db->shm_id = -1;
+    db->offset = db->size = 0;
+
+    if ( Comm.data_ring == NULL || size > DATA_RING_SIZE / 2 )
+        return db->buf = get_shm( &db->shm_id, len, true );
+
+    unsigned long pos = Comm.MQ->ring_used & ( DATA_RING_SIZE - 1 );
+    unsigned long skip = pos + size > DATA_RING_SIZE ?
+                         DATA_RING_SIZE - pos : 0;
+
+    while (   DATA_RING_SIZE
+            - ( Comm.MQ->ring_used - Comm.MQ->ring_freed ) < skip + size )
+        fsc2_usleep( 1000, true );
+
+    db->offset = ( pos + skip ) & ( DATA_RING_SIZE - 1 );
+    db->size = skip + size;
+
+    return db->buf = Comm.data_ring + db->offset;
+}
+
+
+/*------------------------------------------------------------------*
+ * Called whenever the child needs to send data to the parent. For
+ * data 'db' describes the buffer obtained from get_data_buffer()
+ * the data were written to, for a REQUEST it's not used.
+ *------------------------------------------------------------------*/
 
 void
-send_data( int type,
-           int shm_id )
+send_data( int             type,
+           Data_Buffer_T * db )
 {
+    /* The child doesn't need a separate segment for data anymore */
+
+    if ( type != REQUEST && db->shm_id >= 0 )
+        detach_shm( db->buf, NULL );
+
     /* Wait until parent can accept more data */
 
     sema_wait( Comm.mq_semaphore );
@@ -330,19 +392,83 @@ send_data( int type,
     /* Put the type of the data (DATA_1D, DATA_2D or REQUEST) into the type
        field of the next free slot */
 
-    Comm.MQ->slot[ Comm.MQ->high ].type = type;
+    Slot_T * slot = Comm.MQ->slot + Comm.MQ->high;
+
+    slot->type = type;
 
-    /* For DATA pass parent the ID of shared memory segment with the data */
+    /* For DATA pass parent the ID of shared memory segment with the data
+       or where in the ring buffer they are */
 
     if ( type != REQUEST )
-        Comm.MQ->slot[ Comm.MQ->high ].shm_id = shm_id;
+    {
+        slot->shm_id = db->shm_id;
+        slot->offset = db->offset;
+        slot->size = db->size;
+        Comm.MQ->ring_used += db->size;
+    }
 
-    /* Increment the high mark pointer (wraps around) */
+    /* Make sure everything is in memory before the parent can see the new
+       entry, then increment the high mark pointer (wraps around) */
 
+    __sync_synchronize( );
     Comm.MQ->high = ( Comm.MQ->high + 1 ) % QUEUE_SIZE;
 }
 
 
+/*-----------------------------------------------------------------*
+ * Called by the parent to get at the data for an entry of the
+ * message queue, returns NULL if a segment for the data couldn't
+ * be attached to.
+ *-----------------------------------------------------------------*/
+
+const char *
+fetch_data( Slot_T * slot )
+{
+    if ( slot->shm_id >= 0 )
+        return attach_shm( slot->shm_id );
+
+    __sync_synchronize( );
+    return Comm.data_ring + slot->offset;
+}
+
+
+/*-------------------------------------------------------------------*
+ * Called by the parent when it just had a look at the data for an
+ * entry of the message queue but will fetch them again later, so,
+ * in contrast to release_data(), the data must be kept.
+ *-------------------------------------------------------------------*/
+
+void
+unfetch_data( const char * buf,
+              Slot_T     * slot )
+{
+    if ( slot->shm_id >= 0 )
+        detach_shm( buf, NULL );
+}
+
+
+/*-------------------------------------------------------------------*
+ * Called by the parent when done with the data for an entry of the
+ * message queue, either deleting the segment they were passed in or
+ * giving the space in the ring buffer back to the child.
+ *-------------------------------------------------------------------*/
+
+void
+release_data( const char * buf,
+              Slot_T     * slot )
+{
+    if ( slot->shm_id >= 0 )
+    {
+        detach_shm( buf, &slot->shm_id );
+        return;
+    }
+
+    __sync_synchronize( );
+    Comm.MQ->ring_freed += slot->size;
+    slot->size = 0;
+}
+
+
 /*----------------------------------------------------------------------*
  * This function handles the reading from the pipe for both the parent
  * and the child process. In each case a message is started by a header
@@ -920,7 +1046,7 @@ writer( int type,
        waits for data. */
 
     if ( Fsc2_Internals.I_am == CHILD )
-        send_data( REQUEST, -1 );
+        send_data( REQUEST, NULL );
 
     header.type = type;
 
@@ -34,6 +34,13 @@
 #define QUEUE_SIZE 256
 
 
+/* Size of the ring buffer in shared memory the child writes the data to be
+   displayed to (must be a power of 2). Data sets that don't fit into half
+   of it are passed in a shared memory segment of their own. */
+
+#define DATA_RING_SIZE  ( 1UL << 23 )
+
+
 enum {
     C_EPRINT = 0,
     C_SHOW_MESSAGE,
@@ -131,6 +138,7 @@ enum {
 typedef struct Comm_Struct Comm_Struct_T;
 typedef struct Slot Slot_T;
 typedef struct Message_Queue Message_Queue_T;
+typedef struct Data_Buffer Data_Buffer_T;
 
 
 struct Comm_Struct {
@@ -148,17 +156,31 @@ struct Comm_Struct {
 
 struct Slot {
     int type;
-    int shm_id;
+    int shm_id;                 /* segment with the data or -1 if the data */
+    unsigned long offset;       /* are at 'offset' in the ring buffer,     */
+    unsigned long size;         /* using up 'size' bytes of it */
 };
 
 
 struct Message_Queue {
     int low;
     int high;
+    unsigned long ring_used;    /* bytes of the ring buffer ever used (only
+                                   changed by the child) */
+    unsigned long ring_freed;   /* bytes of the ring buffer ever released
+                                   (only changed by the parent) */
     Slot_T slot[ QUEUE_SIZE ];
 };
 
 
+struct Data_Buffer {
+    void * buf;                 /* where the data get written to */
+    int shm_id;
+    unsigned long offset;
+    unsigned long size;
+};
+
+
 enum {
     DATA_1D = 1,
     DATA_2D = 2,
@@ -177,8 +199,19 @@ bool reader( void * /* ret */ );
 bool writer( int /* type */,
              ...             );
 
-void send_data( int /* type   */,
-                int /* shm_id */  );
+void * get_data_buffer( Data_Buffer_T * /* db  */,
+                        long            /* len */  );
+
+void send_data( int             /* type */,
+                Data_Buffer_T * /* db   */  );
+
+const char * fetch_data( Slot_T * /* slot */ );
+
+void unfetch_data( const char * /* buf  */,
+                   Slot_T     * /* slot */  );
+
+void release_data( const char * /* buf  */,
+                   Slot_T     * /* slot */  );
 
 
 #endif  /* ! COMM_HEADER */
@@ -23,21 +23,55 @@
 #include <X11/Xmd.h>
 
 
+/* PNG encoded pictures of the 1D- and 2D-display and the cross section
+   window, they're kept until the window gets redrawn */
+
+typedef struct {
+    unsigned char * data;
+    size_t          len;
+    bool            is_valid;
+} Picture_T;
+
+static Picture_T Pictures[ 3 ];
+
+
+/* Position and width of the bits for a color in a TrueColor pixel */
+
+typedef struct {
+    int shift;
+    int bits;
+} Color_Bits_T;
+
+
+static bool window_is_shown( int type );
+static XImage * get_window_image( int type );
 static Pixmap get_1d_window( unsigned int * width,
                              unsigned int * height );
 static Pixmap get_2d_window( unsigned int * width,
                              unsigned int * height );
 static Pixmap get_cut_window( unsigned int * width,
                               unsigned int * height );
-static void dump_as_ppm( FILE   * dp,
-                         XImage * image );
+static void image_to_rgb( XImage        * image,
+                          unsigned char * buf,
+                          size_t          stride );
+static void get_color_bits( unsigned long  mask,
+                            Color_Bits_T * cb );
+static unsigned char color_value( unsigned long  pixel,
+                                  Color_Bits_T * cb );
+static const unsigned char * pixel_rgb( unsigned long pixel );
+static void encode_png( XImage    * image,
+                        Picture_T * pic );
+static unsigned char * png_chunk( unsigned char       * p,
+                                  const char          * type,
+                                  const unsigned char * data,
+                                  size_t                len );
 
 
 /*------------------------------------------------------------------------*
  * Writes a graphic with the 1D- or 2D-display (if type equals 1 or 2) or
- * the cross section window (for type equal to 2) to the file descriptor
- * passed to the function - the function may throw an exception (instead
- * of returning an error code).
+ * the cross section window (for type equal to 3) in PPM format to the
+ * file descriptor passed to the function - the function may throw an
+ * exception (instead of returning an error code).
  *------------------------------------------------------------------------*/
 
 void
@@ -45,43 +79,158 @@ dump_window( int type,
              int fd )
 {
     XImage *image;
-    unsigned int w, h;
-    Pixmap pm;
     FILE *fp;
+    unsigned char * volatile buf = NULL;
 
 
-    /* With no graphics or without a working hash for the colors no pictures
-       can be send */
-
-    if ( ! G.is_init || ! G.is_fully_drawn || G.color_hash == NULL )
-        THROW( EXCEPTION );
-
     /* We need a stream because write(2) is horribly slow due to it not being
        buffered */
 
     if ( ( fp = fdopen( fd, "w" ) ) == NULL )
         THROW( EXCEPTION );
 
+    image = get_window_image( type );
+
+    /* Write out the image in PPM format - the web server will have to take
+       care of converting it to a more appropriate format. */
+
+    TRY
+    {
+        size_t stride = 3 * image->width;
+
+        buf = T_malloc( stride * image->height );
+        image_to_rgb( image, buf, stride );
+
+        fprintf( fp, "P6\n%d %d\n255\n", image->width, image->height );
+        fwrite( buf, stride, image->height, fp );
+        TRY_SUCCESS;
+    }
+    OTHERWISE
+    {
+        T_free( buf );
+        XDestroyImage( image );
+        RETHROW;
+    }
+
+    T_free( buf );
+    XDestroyImage( image );
+    fclose( fp );
+}
+
+
+/*--------------------------------------------------------------------*
+ * Returns a PNG encoded picture of the 1D- or 2D-display or the cross
+ * section window (if type equals 1, 2 or 3) and its length. The data
+ * belong to this module and stay valid until the function gets called
+ * again. Encoding is only done when the window got redrawn since the
+ * last call. The function throws an exception on failure.
+ *--------------------------------------------------------------------*/
+
+const unsigned char *
+dump_window_png( int      type,
+                 size_t * len )
+{
+    Picture_T *pic = Pictures + type - 1;
+
+
+    if ( ! window_is_shown( type ) )
+        THROW( EXCEPTION );
+
+    if ( ! pic->is_valid )
+    {
+        XImage *image = get_window_image( type );
+
+        TRY
+        {
+            encode_png( image, pic );
+            TRY_SUCCESS;
+        }
+        OTHERWISE
+        {
+            XDestroyImage( image );
+            RETHROW;
+        }
+
+        XDestroyImage( image );
+        pic->is_valid = true;
+    }
+
+    *len = pic->len;
+    return pic->data;
+}
+
+
+/*-------------------------------------------------------------------*
+ * To be called whenever one of the pixmaps of the 1D- or 2D-display
+ * or the cross section window (if type equals 1, 2 or 3) got redrawn,
+ * so that a new picture for it has to be created when asked for.
+ *-------------------------------------------------------------------*/
+
+void
+dump_window_changed( int type )
+{
+    Pictures[ type - 1 ].is_valid = false;
+}
+
+
+/*------------------------------------------------------------*
+ * Returns if the 1D- or 2D-display (if type equals 1 or 2) or
+ * the cross section window (for type equal to 3) is shown.
+ *------------------------------------------------------------*/
+
+static bool
+window_is_shown( int type )
+{
+    if ( ! G.is_init || ! G.is_fully_drawn )
+        return false;
+
+    switch ( type )
+    {
+        case 1 :
+            return G.dim & 1;
+
+        case 2 :
+            return G.dim & 2;
+
+        case 3 :
+            return G.dim & 2 && G_2d.is_cut;
+    }
+
+    return false;
+}
+
+
+/*-----------------------------------------------------------------*
+ * Returns an XImage with the 1D- or 2D-display (if type equals 1 or
+ * 2) or the cross section window (for type equal to 3), throws an
+ * exception if the window isn't shown.
+ *-----------------------------------------------------------------*/
+
+static XImage *
+get_window_image( int type )
+{
+    XImage *image;
+    unsigned int w, h;
+    Pixmap pm;
+
+
+    if ( ! window_is_shown( type ) )
+        THROW( EXCEPTION );
+
     /* Get a pixmap with the graphic we are supposed to send and convert it
        to an XImage */
 
     switch ( type )
     {
         case 1 :
-            if ( ! ( G.dim & 1 ) )
-                THROW( EXCEPTION );
             pm = get_1d_window( &w, &h );
             break;
 
         case 2 :
-            if ( ! ( G.dim & 2 ) )
-                THROW( EXCEPTION );
             pm = get_2d_window( &w, &h );
             break;
 
         case 3 :
-            if ( ! ( G.dim & 2 ) || ! G_2d.is_cut )
-                THROW( EXCEPTION );
             pm = get_cut_window( &w, &h );
             break;
 
@@ -93,18 +242,9 @@ dump_window( int type,
     XFreePixmap( G.d, pm );
 
     if ( image == NULL )
-    {
-        XDestroyImage( image );
         THROW( EXCEPTION );
-    }
 
-    /* Write out the image in PPM format - the web server will have to take
-       care of converting it to a more appropriate format. */
-
-    dump_as_ppm( fp, image );
-
-    XDestroyImage( image );
-    fclose( fp );
+    return image;
 }
 
 
@@ -276,59 +416,253 @@ get_cut_window( unsigned int * width,
 }
 
 
-/*----------------------------------------------------------------*
- * This function determines the pixel values of an image and uses
- * a hash created earlier to figure out the color of the points.
- * It then writes out the colors as three rgb byte values to a
- * file.
- * The part for determining the pixel values (instead of using
- * XGetPixel(), which would be much slower) includes some ideas
- * from the xv program (notably xvgrab.c) by John Bradley, which
- * in turn seems to be based on 'xwdtopnm.c', which is part of
- * the pbmplus package written by Jef Poskanzer.
- *----------------------------------------------------------------*/
+/*---------------------------------------------------------------------*
+ * Converts an XImage to rows of rgb byte values, the row for the y-th
+ * line of the image starts at 'buf + y * stride'. For TrueColor type
+ * images (the normal case) the colors are directly extracted from the
+ * pixel values, working on whole lines of the image data. Otherwise
+ * the pixel values are determined with XGetPixel() and the colors are
+ * looked up in the hash created earlier. Some of the ideas used here
+ * come from the xv program (notably xvgrab.c) by John Bradley, which
+ * in turn seems to be based on 'xwdtopnm.c', which is part of the
+ * pbmplus package written by Jef Poskanzer.
+ *---------------------------------------------------------------------*/
 
 static void
-dump_as_ppm( FILE   * fp,
-             XImage * image )
+image_to_rgb( XImage        * image,
+              unsigned char * buf,
+              size_t          stride )
 {
-    G_Hash_Entry_T * hash = G.color_hash;
-    unsigned int  hash_size = G.color_hash_size;
+    int bytes = image->bits_per_pixel / 8;
+
+
+    if (    image->red_mask && image->green_mask && image->blue_mask
+         && ( bytes == 2 || bytes == 3 || bytes == 4 )
+         && image->bits_per_pixel % 8 == 0 )
+    {
+        Color_Bits_T cb[ 3 ];
+
+        get_color_bits( image->red_mask,   cb + RED );
+        get_color_bits( image->green_mask, cb + GREEN );
+        get_color_bits( image->blue_mask,  cb + BLUE );
+
+        for ( int i = 0; i < image->height; i++ )
+        {
+            const unsigned char *src = ( const unsigned char * ) image->data
+                                       + i * image->bytes_per_line;
+            unsigned char *dest = buf + i * stride;
 
-    fprintf( fp, "P6\n%d %d\n255\n", image->width, image->height );
+            for ( int j = 0; j < image->width; src += bytes, j++ )
+            {
+                unsigned long pixel = 0;
+
+                if ( image->byte_order == LSBFirst )
+                    for ( int k = bytes - 1; k >= 0; k-- )
+                        pixel = ( pixel << 8 ) | src[ k ];
+                else
+                    for ( int k = 0; k < bytes; k++ )
+                        pixel = ( pixel << 8 ) | src[ k ];
+
+                *dest++ = color_value( pixel, cb + RED );
+                *dest++ = color_value( pixel, cb + GREEN );
+                *dest++ = color_value( pixel, cb + BLUE );
+            }
+        }
+
+        return;
+    }
+
+    if ( G.color_hash == NULL )
+        THROW( EXCEPTION );
 
     for ( int i = 0; i < image->height; i++ )
-        for ( int j = 0; j < image->width; j++ )
+    {
+        unsigned char *dest = buf + i * stride;
+        unsigned long last_pixel = 0;
+        const unsigned char *rgb = NULL;
+
+        for ( int j = 0; j < image->width; dest += 3, j++ )
         {
             unsigned long pixel = XGetPixel( image, j, i );
-            int key = pixel % hash_size;
 
-            if ( ! hash[ key ].is_used )
+            /* Neighbouring pixels mostly have the same color */
+
+            if ( rgb == NULL || pixel != last_pixel )
             {
-                // This can happen due to TTF anti-alializing! Not
-                // a clean solution (since it expects a certain way
-                // the color is coded into the pxiel) but better than
-                // nothing for the time being...
-
-                hash[ key ].rgb[ RED   ] = pixel >> 16 & 0xFF;
-                hash[ key ].rgb[ GREEN ] = pixel >> 16 & 0xFF;
-                hash[ key ].rgb[ BLUE  ] =  pixel      & 0xFF;
+                rgb = pixel_rgb( pixel );
+                last_pixel = pixel;
             }
-            else
-                while ( hash[ key ].pixel != pixel )
-                {
-                    key = ( key + 1 ) % hash_size;
-                    if ( ! hash[ key ].is_used )
-                    {
-                        hash[ key ].rgb[ RED   ] = pixel >> 16 & 0xFF;
-                        hash[ key ].rgb[ GREEN ] = pixel >> 16 & 0xFF;
-                        hash[ key ].rgb[ BLUE  ] =  pixel      & 0xFF;
-                        break;
-                    }
-                }
-
-            fwrite( hash[ key ].rgb, 1, 3, fp );
+
+            memcpy( dest, rgb, 3 );
         }
+    }
+}
+
+
+/*--------------------------------------------------------------*
+ * Determines from the mask for a color in a TrueColor pixel by
+ * how many bits the pixel must be shifted to the right and how
+ * many bits are used for the color.
+ *--------------------------------------------------------------*/
+
+static void
+get_color_bits( unsigned long  mask,
+                Color_Bits_T * cb )
+{
+    for ( cb->shift = 0; ! ( mask & 1 ); mask >>= 1 )
+        cb->shift++;
+
+    for ( cb->bits = 0; mask & 1; mask >>= 1 )
+        cb->bits++;
+}
+
+
+/*------------------------------------------------------------*
+ * Returns the value (in the range from 0 to 255) of a color
+ * in a TrueColor pixel.
+ *------------------------------------------------------------*/
+
+static unsigned char
+color_value( unsigned long  pixel,
+             Color_Bits_T * cb )
+{
+    unsigned long v = ( pixel >> cb->shift ) & ( ( 1UL << cb->bits ) - 1 );
+
+    if ( cb->bits >= 8 )
+        return v >> ( cb->bits - 8 );
+    return v * 255 / ( ( 1UL << cb->bits ) - 1 );
+}
+
+
+/*-----------------------------------------------------------------*
+ * Looks up the rgb values for a pixel value in the color hash. If
+ * it isn't in the hash (this can happen due to the anti-aliasing
+ * of TTF fonts) the colors are taken from the pixel value itself
+ * and stored in the hash - not a clean solution since it expects
+ * a certain way the color is coded into the pixel, but better than
+ * nothing for the time being.
+ *-----------------------------------------------------------------*/
+
+static const unsigned char *
+pixel_rgb( unsigned long pixel )
+{
+    G_Hash_Entry_T *hash = G.color_hash;
+    unsigned int key = pixel % G.color_hash_size;
+
+
+    while ( hash[ key ].is_used )
+    {
+        if ( hash[ key ].pixel == pixel )
+            return hash[ key ].rgb;
+        key = ( key + 1 ) % G.color_hash_size;
+    }
+
+    hash[ key ].rgb[ RED   ] = ( pixel >> 16 ) & 0xFF;
+    hash[ key ].rgb[ GREEN ] = ( pixel >>  8 ) & 0xFF;
+    hash[ key ].rgb[ BLUE  ] =   pixel         & 0xFF;
+
+    return hash[ key ].rgb;
+}
+
+
+/*------------------------------------------------------------------*
+ * Encodes an XImage as a PNG image (8-bit RGB, no interlacing) and
+ * stores it in 'pic', replacing what was stored there before.
+ *------------------------------------------------------------------*/
+
+static void
+encode_png( XImage    * image,
+            Picture_T * pic )
+{
+    static const unsigned char signature[ 8 ] =
+                               { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    size_t stride = 3 * image->width + 1;
+    size_t raw_len = stride * image->height;
+    unsigned char * volatile raw = NULL;
+    unsigned char * volatile png = NULL;
+
+
+    TRY
+    {
+        /* Get the rgb values of all lines, each preceeded by a byte for
+           the filter type (0, i.e. no filtering) */
+
+        raw = T_malloc( raw_len );
+        for ( int i = 0; i < image->height; i++ )
+            raw[ i * stride ] = 0;
+        image_to_rgb( image, raw + 1, stride );
+
+        /* The compressed data get written directly to where they belong in
+           the PNG image, after the signature (8 bytes), the IHDR chunk (25
+           bytes) and the length and type fields of the IDAT chunk (8 bytes),
+           the IEND chunk (12 bytes) comes after the IDAT CRC (4 bytes) */
+
+        uLongf zlen = compressBound( raw_len );
+        png = T_malloc( zlen + 57 );
+
+        if ( compress2( png + 41, &zlen, raw, raw_len,
+                        Z_DEFAULT_COMPRESSION ) != Z_OK )
+            THROW( EXCEPTION );
+
+        raw = T_free( raw );
+
+        unsigned char ihdr[ 13 ] = { image->width >> 24, image->width >> 16,
+                                     image->width >> 8, image->width,
+                                     image->height >> 24, image->height >> 16,
+                                     image->height >> 8, image->height,
+                                     8, 2, 0, 0, 0 };
+        unsigned char *p = png;
+
+        memcpy( p, signature, sizeof signature );
+        p = png_chunk( p + sizeof signature, "IHDR", ihdr, sizeof ihdr );
+        p = png_chunk( p, "IDAT", p + 8, zlen );
+        p = png_chunk( p, "IEND", NULL, 0 );
+
+        T_free( pic->data );
+        pic->data = png;
+        pic->len = p - png;
+
+        TRY_SUCCESS;
+    }
+    OTHERWISE
+    {
+        T_free( raw );
+        T_free( png );
+        RETHROW;
+    }
+}
+
+
+/*---------------------------------------------------------------*
+ * Writes a PNG chunk (length, type, data and CRC) to 'p' and
+ * returns where the next chunk starts. The data may already be
+ * where they belong in the chunk.
+ *---------------------------------------------------------------*/
+
+static unsigned char *
+png_chunk( unsigned char       * p,
+           const char          * type,
+           const unsigned char * data,
+           size_t                len )
+{
+    p[ 0 ] = len >> 24;
+    p[ 1 ] = len >> 16;
+    p[ 2 ] = len >> 8;
+    p[ 3 ] = len;
+    memcpy( p + 4, type, 4 );
+
+    if ( len > 0 && data != p + 8 )
+        memcpy( p + 8, data, len );
+
+    uLong crc = crc32( crc32( 0, NULL, 0 ), p + 4, len + 4 );
+
+    p += len + 8;
+    p[ 0 ] = crc >> 24;
+    p[ 1 ] = crc >> 16;
+    p[ 2 ] = crc >> 8;
+    p[ 3 ] = crc;
+
+    return p + 4;
 }
 
 
@@ -26,6 +26,11 @@
 void dump_window( int /* type */,
                   int /* fd   */  );
 
+const unsigned char * dump_window_png( int      /* type */,
+                                       size_t * /* len  */  );
+
+void dump_window_changed( int /* type */ );
+
 void create_color_hash( void );
 
 
@@ -29,15 +29,6 @@ extern int explex_destroy( void );
 
 #define PRG_CHUNK_SIZE 16384
 
-/* Number of tokens to be parsed before forms are rechecked for user input -
-   too small a number slows down the program quite a lot (and even moderately
-   short EDL files may produce an appreciable number of tokens to be parsed
-   when e.g. running in loops), while making it too large makes it difficult
-   for the user to stop the interpreter. */
-
-#define CHECK_FORMS_AFTER   8192
-
-
 Token_Val_T Exp_Val;                      /* also used by exp_lexer.l */
 
 
@@ -188,6 +179,11 @@ store_exp( FILE * in )
        will be found immediately instead after a long test run. */
 
     exp_syntax_check( );
+
+    /* Finally translate the program into code that can be executed much
+       faster than by parsing the tokens again and again */
+
+    compile_exp( );
 }
 
 
@@ -490,6 +486,8 @@ forget_prg( void )
 {
     EDL.On_Stop_Pos = -1;
 
+    forget_compiled_exp( );
+
     /* Check if anything has to be done at all */
 
     if ( EDL.prg_token == NULL )
@@ -969,6 +967,8 @@ exp_test_run( void )
         EDL.cur_prg_token = EDL.prg_token;
         Token_count = 0;
 
+        bool is_compiled = exp_is_compiled( );
+
         while (    EDL.cur_prg_token != NULL
                 && EDL.cur_prg_token < EDL.prg_token + EDL.prg_length )
         {
@@ -1000,10 +1000,15 @@ exp_test_run( void )
                 EDL.do_quit = false;
             }
 
-            /* Now deal with the token at hand - the function only returns
-               when control structure tokens are found */
+            /* Now either run the compiled code (which only returns at the
+               end of the program or when 'do_quit' got set) or deal with the
+               token at hand - the function only returns when control
+               structure tokens are found */
 
-            deal_with_token_in_test( );
+            if ( is_compiled )
+                run_compiled_exp( true );
+            else
+                deal_with_token_in_test( );
         }
 
         tools_clear( );
@@ -1033,6 +1038,35 @@ exp_test_run( void )
 }
 
 
+/*-------------------------------------------------------------------*
+ * Called instead of exp_test_run() when the test run can be skipped
+ * because the very same program already passed it. Only the test
+ * hooks of the modules get run, some of them store their state for
+ * their experiment hook to restore it.
+ *-------------------------------------------------------------------*/
+
+void
+exp_skip_test_run( void )
+{
+    EDL.Fname = T_free( EDL.Fname );
+    Fsc2_Internals.mode = TEST;
+
+    TRY
+    {
+        run_test_hooks( );
+        TRY_SUCCESS;
+    }
+    OTHERWISE
+    {
+        delete_devices( );                       /* run the exit hooks ! */
+        Fsc2_Internals.mode = PREPARATION;
+        RETHROW;
+    }
+
+    Fsc2_Internals.mode = PREPARATION;
+}
+
+
 /*----------------------------------------------------------------*
  *----------------------------------------------------------------*/
 
@@ -1163,8 +1197,6 @@ exp_runlex( void )
     EDL.Fname = EDL.cur_prg_token->Fname;
     EDL.Lc    = EDL.cur_prg_token->Lc;
 
-    Var_T *ret, *from, *next, *prev;
-
     switch ( EDL.cur_prg_token->token )
     {
         case WHILE_TOK :
@@ -1187,28 +1219,8 @@ exp_runlex( void )
             break;
 
         case E_FUNC_TOKEN :
-            ret = vars_push( INT_VAR, 0L );
-            from = ret->from;
-            next = ret->next;
-            prev = ret->prev;
-            memcpy( ret, EDL.cur_prg_token->tv.vptr, sizeof *ret );
-            ret->name = T_strdup( ret->name );
-            ret->from = from;
-            ret->next = next;
-            ret->prev = prev;
-            exp_runlval.vptr = ret;
-            break;
-
         case E_VAR_REF :
-            ret = vars_push( INT_VAR, 0L );
-            from = ret->from;
-            next = ret->next;
-            prev = ret->prev;
-            memcpy( ret, EDL.cur_prg_token->tv.vptr, sizeof *ret );
-            ret->from = from;
-            ret->next = next;
-            ret->prev = prev;
-            exp_runlval.vptr = ret;
+            exp_runlval.vptr = push_token_var( EDL.cur_prg_token );
             break;
 
         default :
@@ -1239,10 +1251,6 @@ conditionlex( void )
     EDL.Lc    = EDL.cur_prg_token->Lc;
 
     int token;
-    Var_T *ret,
-          *from,
-          *next,
-          *prev;
 
     switch ( EDL.cur_prg_token->token )
     {
@@ -1272,31 +1280,9 @@ conditionlex( void )
             return E_STR_TOKEN;
 
         case E_FUNC_TOKEN :
-            ret = vars_push( INT_VAR, 0L );
-            from = ret->from;
-            next = ret->next;
-            prev = ret->prev;
-            memcpy( ret, EDL.cur_prg_token->tv.vptr, sizeof *ret );
-            ret->name = T_strdup( ret->name );
-            ret->from = from;
-            ret->next = next;
-            ret->prev = prev;
-            conditionlval.vptr = ret;
-            EDL.cur_prg_token++;
-            return E_FUNC_TOKEN;
-
         case E_VAR_REF :
-            ret = vars_push( INT_VAR, 0L );
-            from = ret->from;
-            next = ret->next;
-            prev = ret->prev;
-            memcpy( ret, EDL.cur_prg_token->tv.vptr, sizeof *ret );
-            ret->from = from;
-            ret->next = next;
-            ret->prev = prev;
-            conditionlval.vptr = ret;
-            EDL.cur_prg_token++;
-            return E_VAR_REF;
+            conditionlval.vptr = push_token_var( EDL.cur_prg_token );
+            return EDL.cur_prg_token++->token;
 
         case '=' :
             print( FATAL, "For comparisons '==' must be used ('=' is for "
@@ -1313,6 +1299,35 @@ conditionlex( void )
 }
 
 
+/*----------------------------------------------------------------------*
+ * Pushes a copy of the variable stored with a function token or a
+ * variable reference token onto the variable stack (function tokens
+ * share the function name with the token) and returns a pointer to
+ * it. Used by the lexers as well as the compiled program.
+ *----------------------------------------------------------------------*/
+
+Var_T *
+push_token_var( Prg_Token_T * cur )
+{
+    Var_T * ret = vars_push( INT_VAR, 0L );
+    Var_T * from = ret->from;
+    Var_T * next = ret->next;
+    Var_T * prev = ret->prev;
+
+    /* The name of a function variable doesn't get copied but is shared with
+       the token, vars_pop() knows not to free it */
+
+    memcpy( ret, cur->tv.vptr, sizeof *ret );
+    if ( cur->token == E_FUNC_TOKEN )
+        ret->flags |= SHARED_NAME;
+    ret->from = from;
+    ret->next = next;
+    ret->prev = prev;
+
+    return ret;
+}
+
+
 /*--------------------------------------------------------------------*
  * Function tests the condition of a WHILE, UNTIL, FOR or REPEAT loop
  * or an IF or UNLESS construct.
@@ -1336,9 +1351,23 @@ test_condition( Prg_Token_T * cur )
         THROW( EXCEPTION );
     }
 
+    return check_condition( cur, EDL.Var_Stack );
+}
+
+
+/*------------------------------------------------------------------*
+ * Function checks the value a condition of a WHILE, UNTIL, FOR or
+ * REPEAT loop or an IF or UNLESS construct evaluated to, removes it
+ * from the stack and returns if the condition is met.
+ *------------------------------------------------------------------*/
+
+bool
+check_condition( Prg_Token_T * cur,
+                 Var_T       * v )
+{
     /* Make sure returned value is either integer or float */
 
-    if ( ! ( EDL.Var_Stack->type & ( INT_VAR | FLOAT_VAR | STR_VAR ) ) )
+    if ( ! ( v->type & ( INT_VAR | FLOAT_VAR | STR_VAR ) ) )
     {
         eprint( FATAL, false, "%s:%ld: Invalid condition for %s.\n",
                 cur->Fname, cur->Lc, get_construct_name( cur->token ) );
@@ -1349,14 +1378,14 @@ test_condition( Prg_Token_T * cur )
 
     bool condition;
 
-    if ( EDL.Var_Stack->type == INT_VAR )
-        condition = EDL.Var_Stack->val.lval;
-    else if ( EDL.Var_Stack->type == FLOAT_VAR )
-        condition = EDL.Var_Stack->val.dval;
-    else                            /* if ( EDL.Var_Stack->type == STR_VAR ) */
-        condition = EDL.Var_Stack->val.sptr[ 0 ] != '\0';
+    if ( v->type == INT_VAR )
+        condition = v->val.lval;
+    else if ( v->type == FLOAT_VAR )
+        condition = v->val.dval;
+    else                                        /* if ( v->type == STR_VAR ) */
+        condition = v->val.sptr[ 0 ] != '\0';
 
-    vars_pop( EDL.Var_Stack );
+    vars_pop( v );
     return ( cur->token != UNLESS_TOK ) ? condition : ! condition;
 }
 
@@ -1372,9 +1401,24 @@ get_max_repeat_count( Prg_Token_T * cur )
     conditionparse( );                           /* get the value */
     fsc2_assert( EDL.Var_Stack->next == NULL );  /* Paranoia as usual... */
 
+    set_max_repeat_count( cur, EDL.Var_Stack );
+    EDL.cur_prg_token++;                   /* skip the '{' */
+}
+
+
+/*-------------------------------------------------------------*
+ * Sets the repeat count for a REPEAT loop from the value the
+ * expression after the REPEAT keyword evaluated to and removes
+ * the value from the stack.
+ *-------------------------------------------------------------*/
+
+void
+set_max_repeat_count( Prg_Token_T * cur,
+                      Var_T       * v )
+{
     /* Make sure the repeat count is either int or float */
 
-    if ( ! ( EDL.Var_Stack->type & ( INT_VAR | FLOAT_VAR ) ) )
+    if ( ! ( v->type & ( INT_VAR | FLOAT_VAR ) ) )
     {
         cur++;
         eprint( FATAL, false, "%s:%ld: Invalid counter for REPEAT loop.\n",
@@ -1384,20 +1428,18 @@ get_max_repeat_count( Prg_Token_T * cur )
 
     /* Set the repeat count - warn if value is float an convert to integer */
 
-    if ( EDL.Var_Stack->type == INT_VAR )
-        cur->count.repl.max = EDL.Var_Stack->val.lval;
+    if ( v->type == INT_VAR )
+        cur->count.repl.max = v->val.lval;
     else
     {
         eprint( WARN, false, "%s:%ld: WARNING: Floating point value used as "
                 "maximum count in REPEAT loop.\n",
                 ( cur + 1 )->Fname, ( cur + 1 )->Lc );
-        cur->count.repl.max = lrnd( EDL.Var_Stack->val.dval );
+        cur->count.repl.max = lrnd( v->val.dval );
     }
 
-    vars_pop( EDL.Var_Stack );
+    vars_pop( v );
     cur->count.repl.act = 0;
-    EDL.cur_prg_token++;                   /* skip the '{' */
-    return;
 }
 
 
@@ -1426,18 +1468,78 @@ get_for_cond( Prg_Token_T * cur )
         THROW( EXCEPTION );
     }
 
+    set_for_var( cur, EDL.cur_prg_token->tv.vptr );
+
+    /* Now get start value to be assigned to loop variable */
+
+    EDL.cur_prg_token +=2;                    /* skip variable and '=' token */
+    In_for_lex = true;                        /* allow ':' as separator */
+    conditionparse( );                        /* get start value */
+    In_for_lex = false;
+    fsc2_assert( EDL.Var_Stack->next == NULL );   /* Paranoia as usual... */
+
+    /* Make sure there is at least one more token, i.e. the loops end value */
+
+    if ( EDL.cur_prg_token->token != ':' )
+    {
+        cur++;
+        eprint( FATAL, false, "%s:%ld: Missing end value in FOR loop.\n",
+                cur->Fname, cur->Lc );
+        THROW( EXCEPTION );
+    }
+
+    set_for_start( cur, EDL.Var_Stack );
+
+    /* Get FOR loop end value */
+
+    EDL.cur_prg_token++;                           /* skip the ':' */
+    In_for_lex = true;
+    conditionparse( );                             /* get end value */
+    In_for_lex = false;
+    fsc2_assert( EDL.Var_Stack->next == NULL );    /* Paranoia as usual... */
+
+    set_for_end( cur, EDL.Var_Stack );
+
+    /* Set the increment */
+
+    if ( EDL.cur_prg_token->token != ':' )      /* no increment given, use 1 */
+        set_for_incr( cur, NULL );
+    else                                        /* get for loop increment */
+    {
+        EDL.cur_prg_token++;                    /* skip the ':' */
+        In_for_lex = true;
+        conditionparse( );                      /* get increment value */
+        In_for_lex = false;
+        fsc2_assert( EDL.Var_Stack->next == NULL ); /* Paranoia as usual... */
+
+        set_for_incr( cur, EDL.Var_Stack );
+    }
+
+    EDL.cur_prg_token++;                /* skip the '{' */
+}
+
+
+/*---------------------------------------------------------------*
+ * Sets up the loop variable of a FOR loop, giving it a type if
+ * it's a new variable and checking that it is either an integer
+ * or a floating point variable.
+ *---------------------------------------------------------------*/
+
+void
+set_for_var( Prg_Token_T * cur,
+             Var_T       * v )
+{
     /* If loop variable is new set its type */
 
-    if ( EDL.cur_prg_token->tv.vptr->type == UNDEF_VAR )
+    if ( v->type == UNDEF_VAR )
     {
-        EDL.cur_prg_token->tv.vptr->type =
-                                        VAR_TYPE( EDL.cur_prg_token->tv.vptr );
-        EDL.cur_prg_token->tv.vptr->flags &= ~ NEW_VARIABLE;
+        v->type = VAR_TYPE( v );
+        v->flags &= ~ NEW_VARIABLE;
     }
 
     /* Make sure the loop variable is either an integer or a float */
 
-    if ( ! ( EDL.cur_prg_token->tv.vptr->type & ( INT_VAR | FLOAT_VAR ) ) )
+    if ( ! ( v->type & ( INT_VAR | FLOAT_VAR ) ) )
     {
         cur++;
         eprint( FATAL, false, "%s:%ld: FOR loop variable must be integer or "
@@ -1447,32 +1549,24 @@ get_for_cond( Prg_Token_T * cur )
 
     /* Store pointer to loop variable */
 
-    cur->count.forl.act = EDL.cur_prg_token->tv.vptr;
-
-    /* Now get start value to be assigned to loop variable */
+    cur->count.forl.act = v;
+}
 
-    EDL.cur_prg_token +=2;                    /* skip variable and '=' token */
-    In_for_lex = true;                        /* allow ':' as separator */
-    conditionparse( );                        /* get start value */
-    fsc2_assert( EDL.Var_Stack->next == NULL );   /* Paranoia as usual... */
 
-    /* Make sure there is at least one more token, i.e. the loops end value */
-
-    if ( EDL.cur_prg_token->token != ':' )
-    {
-        cur++;
-        In_for_lex = false;
-        eprint( FATAL, false, "%s:%ld: Missing end value in FOR loop.\n",
-                cur->Fname, cur->Lc );
-        THROW( EXCEPTION );
-    }
+/*-------------------------------------------------------------*
+ * Assigns the start value to the loop variable of a FOR loop
+ * and removes the value from the stack.
+ *-------------------------------------------------------------*/
 
+void
+set_for_start( Prg_Token_T * cur,
+               Var_T       * v )
+{
     /* Make sure the returned value is either integer or float */
 
-    if ( ! ( EDL.Var_Stack->type & ( INT_VAR | FLOAT_VAR ) ) )
+    if ( ! ( v->type & ( INT_VAR | FLOAT_VAR ) ) )
     {
         cur++;
-        In_for_lex = false;
         eprint( FATAL, false, "%s:%ld: Invalid start value in FOR loop.\n",
                 cur->Fname, cur->Lc );
         THROW( EXCEPTION );
@@ -1480,12 +1574,12 @@ get_for_cond( Prg_Token_T * cur )
 
     /* Set start value of loop variable */
 
-    if ( EDL.Var_Stack->type == INT_VAR )
+    if ( v->type == INT_VAR )
     {
         if ( cur->count.forl.act->type == INT_VAR )
-            cur->count.forl.act->val.lval = EDL.Var_Stack->val.lval;
+            cur->count.forl.act->val.lval = v->val.lval;
         else
-            cur->count.forl.act->val.dval = ( double ) EDL.Var_Stack->val.lval;
+            cur->count.forl.act->val.dval = ( double ) v->val.lval;
     }
     else
     {
@@ -1495,26 +1589,30 @@ get_for_cond( Prg_Token_T * cur )
                     "assignment to integer FOR loop variable %s.\n",
                     ( cur + 1 )->Fname,
                     ( cur + 1 )->Lc, cur->count.forl.act->name );
-            cur->count.forl.act->val.lval = lrnd( EDL.Var_Stack->val.dval );
+            cur->count.forl.act->val.lval = lrnd( v->val.dval );
         }
         else
-            cur->count.forl.act->val.dval = EDL.Var_Stack->val.dval;
+            cur->count.forl.act->val.dval = v->val.dval;
     }
 
-    vars_pop( EDL.Var_Stack );
+    vars_pop( v );
+}
 
-    /* Get FOR loop end value */
 
-    EDL.cur_prg_token++;                           /* skip the ':' */
-    conditionparse( );                             /* get end value */
-    fsc2_assert( EDL.Var_Stack->next == NULL );    /* Paranoia as usual... */
+/*-------------------------------------------------------*
+ * Sets the end value of a FOR loop and removes the value
+ * from the stack.
+ *-------------------------------------------------------*/
 
+void
+set_for_end( Prg_Token_T * cur,
+             Var_T       * v )
+{
     /* Make sure end value is either integer or float */
 
-    if ( ! ( EDL.Var_Stack->type & ( INT_VAR | FLOAT_VAR ) ) )
+    if ( ! ( v->type & ( INT_VAR | FLOAT_VAR ) ) )
     {
         cur++;
-        In_for_lex = false;
         eprint( FATAL, false, "%s:%ld: Invalid end value in FOR loop.\n",
                 cur->Fname, cur->Lc );
         THROW( EXCEPTION );
@@ -1522,11 +1620,9 @@ get_for_cond( Prg_Token_T * cur )
 
     /* If loop variable is integer 'end' must also be integer */
 
-    if (    cur->count.forl.act->type == INT_VAR
-         && EDL.Var_Stack->type == FLOAT_VAR )
+    if ( cur->count.forl.act->type == INT_VAR && v->type == FLOAT_VAR )
     {
         cur++;
-        In_for_lex = false;
         eprint( FATAL, false, "%s:%ld: End value in FOR loop is floating "
                 "point value while loop variable is an integer.\n",
                 cur->Fname, cur->Lc );
@@ -1535,17 +1631,27 @@ get_for_cond( Prg_Token_T * cur )
 
     /* Set end value of loop */
 
-    cur->count.forl.end.type = EDL.Var_Stack->type;
-    if ( EDL.Var_Stack->type == INT_VAR )
-        cur->count.forl.end.lval = EDL.Var_Stack->val.lval;
+    cur->count.forl.end.type = v->type;
+    if ( v->type == INT_VAR )
+        cur->count.forl.end.lval = v->val.lval;
     else
-        cur->count.forl.end.dval = EDL.Var_Stack->val.dval;
+        cur->count.forl.end.dval = v->val.dval;
 
-    vars_pop( EDL.Var_Stack );
+    vars_pop( v );
+}
 
-    /* Set the increment */
 
-    if ( EDL.cur_prg_token->token != ':' )      /* no increment given, use 1 */
+/*------------------------------------------------------------------*
+ * Sets the increment of a FOR loop and removes the value from the
+ * stack. If 'v' is NULL (i.e. no increment was given) an increment
+ * of 1 is used.
+ *------------------------------------------------------------------*/
+
+void
+set_for_incr( Prg_Token_T * cur,
+              Var_T       * v )
+{
+    if ( v == NULL )                            /* no increment given, use 1 */
     {
         if ( cur->count.forl.act->type == INT_VAR )
         {
@@ -1558,71 +1664,58 @@ get_for_cond( Prg_Token_T * cur )
             cur->count.forl.incr.dval = 1.0;
         }
 
+        return;
     }
-    else                                        /* get for loop increment */
+
+    /* Make sure the increment is either an integer or a float */
+
+    if ( ! ( v->type & ( INT_VAR | FLOAT_VAR ) ) )
     {
-        EDL.cur_prg_token++;                    /* skip the ':' */
-        conditionparse( );                      /* get end value */
-        In_for_lex = false;
-        fsc2_assert( EDL.Var_Stack->next == NULL ); /* Paranoia as usual... */
+        cur++;
+        eprint( FATAL, false, "%s:%ld: Invalid increment for FOR loop.\n",
+                cur->Fname, cur->Lc );
+        THROW( EXCEPTION );
+    }
 
-        /* Make sure the increment is either an integer or a float */
+    /* If loop variable is an integer, 'incr' must also be integer */
 
-        if ( ! ( EDL.Var_Stack->type & ( INT_VAR | FLOAT_VAR ) ) )
+    if ( cur->count.forl.act->type == INT_VAR && v->type == FLOAT_VAR )
+    {
+        cur++;
+        eprint( FATAL, false, "%s:%ld: FOR loop increment is floating "
+                "point value while loop variable is an integer.\n",
+                cur->Fname, cur->Lc );
+        THROW( EXCEPTION );
+    }
+
+    cur->count.forl.incr.type = v->type;
+
+    /* Check that increment isn't zero */
+
+    if ( v->type == INT_VAR )
+    {
+        if ( v->val.lval == 0 )
         {
             cur++;
-            eprint( FATAL, false, "%s:%ld: Invalid increment for FOR loop.\n",
+            eprint( FATAL, false, "%s:%ld: Zero increment in FOR loop.\n",
                     cur->Fname, cur->Lc );
             THROW( EXCEPTION );
         }
-
-        /* If loop variable is an integer, 'incr' must also be integer */
-
-        if (    cur->count.forl.act->type == INT_VAR
-             && EDL.Var_Stack->type == FLOAT_VAR )
+        cur->count.forl.incr.lval = v->val.lval;
+    }
+    else
+    {
+        if ( v->val.dval == 0 )
         {
             cur++;
-            In_for_lex = false;
-            eprint( FATAL, false, "%s:%ld: FOR loop increment is floating "
-                    "point value while loop variable is an integer.\n",
+            eprint( FATAL, false, "%s:%ld: Zero increment for FOR loop.\n",
                     cur->Fname, cur->Lc );
             THROW( EXCEPTION );
         }
-
-        cur->count.forl.incr.type = EDL.Var_Stack->type;
-
-        /* Check that increment isn't zero */
-
-        if ( EDL.Var_Stack->type == INT_VAR )
-        {
-            if ( EDL.Var_Stack->val.lval == 0 )
-            {
-                cur++;
-                eprint( FATAL, false, "%s:%ld: Zero increment in FOR loop.\n",
-                        cur->Fname, cur->Lc );
-                THROW( EXCEPTION );
-            }
-            cur->count.forl.incr.lval = EDL.Var_Stack->val.lval;
-        }
-        else
-        {
-            if ( EDL.Var_Stack->val.dval == 0 )
-            {
-                cur++;
-                eprint( FATAL, false, "%s:%ld: Zero increment for FOR loop.\n",
-                        cur->Fname, cur->Lc );
-                THROW( EXCEPTION );
-            }
-            cur->count.forl.incr.dval = EDL.Var_Stack->val.dval;
-        }
-
-        vars_pop( EDL.Var_Stack );
+        cur->count.forl.incr.dval = v->val.dval;
     }
 
-    In_for_lex = false;
-    EDL.cur_prg_token++;                /* skip the '{' */
-    return;
-
+    vars_pop( v );
 }
 
 
@@ -1633,60 +1726,40 @@ get_for_cond( Prg_Token_T * cur )
 bool
 test_for_cond( Prg_Token_T * cur )
 {
-    bool sign = false;
+    Var_T *act = cur->count.forl.act;
 
 
-    /* If this isn't the very first call, increment the loop variable */
+    /* Fast path for the most common case of an integer loop variable (the
+       end value and the increment then are integers as well, that's taken
+       care of when they're set) */
 
-    if ( cur->counter != 0 )
+    if ( act->type == INT_VAR )
     {
-        if ( cur->count.forl.act->type == INT_VAR )
-                cur->count.forl.act->val.lval += cur->count.forl.incr.lval;
-        else
-            cur->count.forl.act->val.dval +=
-                cur->count.forl.incr.type == INT_VAR ?
-                    cur->count.forl.incr.lval : cur->count.forl.incr.dval;
+        long incr = cur->count.forl.incr.lval;
+
+        if ( cur->counter != 0 )
+            act->val.lval += incr;
+
+        return incr > 0 ? act->val.lval <= cur->count.forl.end.lval
+                        : act->val.lval >= cur->count.forl.end.lval;
     }
 
-    /* Get sign of increment */
+    /* Otherwise the loop variable is a float. If this isn't the very first
+       call, increment it */
 
-    if (    (    cur->count.forl.incr.type == INT_VAR
-              && cur->count.forl.incr.lval < 0 )
-         || (    cur->count.forl.incr.type == FLOAT_VAR
-              && cur->count.forl.incr.dval < 0 ) )
-        sign = true;
+    double incr = cur->count.forl.incr.type == INT_VAR ?
+                  cur->count.forl.incr.lval : cur->count.forl.incr.dval;
+    double end = cur->count.forl.end.type == INT_VAR ?
+                 cur->count.forl.end.lval : cur->count.forl.end.dval;
+
+    if ( cur->counter != 0 )
+        act->val.dval += incr;
 
     /* If the increment is positive test if loop variable is less or equal to
        the end value, if increment is negative if loop variable is larger or
        equal to the end value. Return the result. */
 
-    if ( cur->count.forl.act->type == INT_VAR )
-    {
-        if ( ! sign )     /* 'incr' has positive sign */
-            return cur->count.forl.act->val.lval <= cur->count.forl.end.lval;
-        else              /* 'incr' has negative sign */
-            return cur->count.forl.act->val.lval >= cur->count.forl.end.lval;
-    }
-    else
-    {
-        if ( ! sign )     /* 'incr' has positive sign */
-            return cur->count.forl.act->val.dval <=
-                       ( cur->count.forl.end.type == INT_VAR ?
-                         cur->count.forl.end.lval : cur->count.forl.end.dval );
-        else              /* 'incr' has negative sign */
-            return cur->count.forl.act->val.dval >=
-                       ( cur->count.forl.end.type == INT_VAR ?
-                         cur->count.forl.end.lval : cur->count.forl.end.dval );
-    }
-
-    /* We can't end up here... */
-
-#ifndef NDEBUG
-    eprint( FATAL, false, "Internal error at %s:%d.\n", __FILE__, __LINE__ );
-#endif
-
-    THROW( EXCEPTION );
-    return false;
+    return incr > 0 ? act->val.dval <= end : act->val.dval >= end;
 }
 
 
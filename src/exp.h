@@ -23,6 +23,16 @@
 #define EXP_HEADER
 
 
+/* Number of tokens to be parsed (or instructions to be executed when the
+   program has been compiled) before forms are rechecked for user input -
+   too small a number slows down the program quite a lot (and even moderately
+   short EDL files may produce an appreciable number of tokens to be parsed
+   when e.g. running in loops), while making it too large makes it difficult
+   for the user to stop the interpreter. */
+
+#define CHECK_FORMS_AFTER   8192
+
+
 /* This typedef MUST be identical to the YYSTYPE union defined in
    `exp_run_parser.h' which in turn results from `exp_run_parser.y' !! */
 
@@ -103,16 +113,38 @@ int exp_testlex( void );
 
 void exp_test_run( void );
 
+void exp_skip_test_run( void );
+
 int exp_runlex( void );
 
 int conditionlex( void );
 
+Var_T * push_token_var( Prg_Token_T * /* cur */ );
+
 bool test_condition( Prg_Token_T * /* cur */ );
 
+bool check_condition( Prg_Token_T * /* cur */,
+                      Var_T *       /* v   */  );
+
 void get_max_repeat_count( Prg_Token_T * /* cur */ );
 
+void set_max_repeat_count( Prg_Token_T * /* cur */,
+                           Var_T *       /* v   */  );
+
 void get_for_cond( Prg_Token_T * /* cur */ );
 
+void set_for_var( Prg_Token_T * /* cur */,
+                  Var_T *       /* v   */  );
+
+void set_for_start( Prg_Token_T * /* cur */,
+                    Var_T *       /* v   */  );
+
+void set_for_end( Prg_Token_T * /* cur */,
+                  Var_T *       /* v   */  );
+
+void set_for_incr( Prg_Token_T * /* cur */,
+                   Var_T *       /* v   */  );
+
 bool test_for_cond( Prg_Token_T * /* cur */ );
 
 bool check_result( Var_T * /* v */ );
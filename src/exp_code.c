@@ -0,0 +1,2034 @@
+/*
+ *  Copyright (C) 1999-2014 Jens Thoms Toerring
+ *
+ *  This file is part of fsc2.
+ *
+ *  Fsc2 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3, or (at your option)
+ *  any later version.
+ *
+ *  Fsc2 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*---------------------------------------------------------------------------*
+ * Once the EXPERIMENT section has been stored and passed the syntax check
+ * the program tokens are translated into a simple stack machine code that
+ * then gets executed in the test run and the experiment instead of feeding
+ * the tokens again and again through the parsers in exp_run_parser.y and
+ * condition_parser.y. All jump targets (for loops, IF-ELSE constructs,
+ * BREAK and NEXT as well as for the short-cut evaluation of AND, OR and the
+ * '?:' operator) are resolved at compile time. The instructions call the
+ * very same functions as the parsers do, so the results (and also the
+ * error messages) are identical. For function calls it's also checked in
+ * advance if the function accepts the number of arguments it's called
+ * with, only if it doesn't the arguments get counted (and complained
+ * about) at run time.
+ *
+ * Everything that the compiler doesn't understand (typically constructs
+ * that are bound to result in an error at run time anyway) makes it give
+ * up silently, in which case the program is executed the old way, i.e.
+ * via the parsers. The same happens if fsc2 was started with the
+ * '-noBytecode' option, which is mainly useful for comparing results and
+ * speed of both methods.
+ *
+ * While compiling, operations on constants get evaluated right away, i.e.
+ * things like '2 * 3.1415926 * 9.4e9' end up as a single number. This also
+ * includes simple variables that never get assigned a new value within the
+ * EXPERIMENT section, they can only have been set in one of the preceding
+ * sections and thus won't ever change. A constant condition of an IF,
+ * UNLESS, WHILE or UNTIL construct (or of the '?:' operator) doesn't get
+ * tested at all and no code is created for the branches that never can be
+ * reached. The operations are done by the same functions as at run time,
+ * so the results can't differ. Anything that might raise an error (like a
+ * division by zero) is left alone, it has to happen when the program is
+ * run. With the '-dumpBytecode' option the resulting code is printed out.
+ *---------------------------------------------------------------------------*/
+
+
+#include "fsc2.h"
+#include "exp_parser_common.h"
+
+
+/* Number of instructions to be allocated as a chunk */
+
+#define CODE_CHUNK_SIZE  4096
+
+/* Precedence of the operand of unary '+', '-' and '!' */
+
+#define UNARY_OPERAND_PREC  8
+
+
+enum {
+    OP_STMT,                   /* start of a statement or control structure */
+    OP_END,                    /* end of program */
+    OP_JUMP,                   /* '}' and NEXT */
+    OP_SKIP,                   /* jump within an expression */
+    OP_IF,                     /* also used for UNLESS */
+    OP_WHILE,
+    OP_UNTIL,
+    OP_REPEAT_ENTER,
+    OP_REPEAT_SET,
+    OP_REPEAT_TEST,
+    OP_FOR_ENTER,
+    OP_FOR_START,
+    OP_FOR_END,
+    OP_FOR_INCR,
+    OP_FOR_TEST,
+    OP_FOREVER,
+    OP_BREAK,
+    OP_PUSH_INT,
+    OP_PUSH_FLOAT,
+    OP_PUSH_STR,
+    OP_CAT_STR,
+    OP_PUSH_VAR,
+    OP_PUSH_TOKEN_VAR,         /* function and variable reference tokens */
+    OP_LHS_VAR,
+    OP_ARR_START,
+    OP_NO_INDEX,
+    OP_RANGE,
+    OP_ARR_RHS,
+    OP_ARR_LHS,
+    OP_CALL,
+    OP_CALL_STMT,
+    OP_P_GET,
+    OP_P_SET,
+    OP_P_SET_OP,
+    OP_ASSIGN,
+    OP_ASSIGN_OP,
+    OP_ADD,
+    OP_SUB,
+    OP_MULT,
+    OP_DIV,
+    OP_MOD,
+    OP_POW,
+    OP_COMP,
+    OP_NEG,
+    OP_LNEG,
+    OP_AND,
+    OP_OR,
+    OP_TERN
+};
+
+
+static Exp_Instr_T * Code = NULL;      /* the compiled program */
+static long Code_len = 0;              /* number of instructions */
+static long Code_size = 0;             /* number of allocated instructions */
+static long * Tok_to_instr = NULL;     /* instruction index for tokens */
+static Var_T ** Regs = NULL;           /* stack of intermediate results */
+static long Stack_depth;               /* used to determine size of Regs */
+static long Max_stack_depth;
+static Prg_Token_T * Cur;              /* token compiler is dealing with */
+static Prg_Token_T * Prg_end;
+static bool In_condition;              /* set while compiling a condition */
+static long Fold_start;                /* first instruction that is no jump
+                                          target and thus may get folded */
+static Var_T ** Assigned_vars = NULL;  /* sorted list of variables that get
+                                          assigned to in the program */
+static long Num_assigned_vars;
+static Prg_Token_T ** Skip_to = NULL;  /* where to continue at an ELSE
+                                          that can never be reached */
+
+
+static void not_compilable( void );
+static int token_at( Prg_Token_T * t );
+static Exp_Instr_T * emit( int           op,
+                           Prg_Token_T * tok,
+                           long          delta );
+static void emit_jump( int           op,
+                       Prg_Token_T * tok,
+                       Prg_Token_T * target,
+                       long          delta );
+static void compile_program( void );
+static void compile_condition( int op );
+static void compile_repeat( void );
+static void compile_for( void );
+static void compile_condition_expr( void );
+static void compile_statement( void );
+static void compile_expr( int min_prec );
+static void compile_operand( void );
+static void emit_binary( Prg_Token_T * op );
+static void compile_const_tern( int prec );
+static long compile_index_list( void );
+static long compile_arg_list( void );
+static int precedence( int token );
+static int assignment_op( int token );
+static int pulse_property( int token );
+static void resolve_jumps( void );
+static void find_assigned_vars( void );
+static int var_ptr_cmp( const void * a,
+                        const void * b );
+static bool is_const_var( Var_T * v );
+static bool is_const( long i );
+static bool const_is_true( long i );
+static Var_T * const_to_var( long i );
+static void var_to_const( long    i,
+                          Var_T * v );
+static bool fold_binary( int  op,
+                         int  sub,
+                         long n );
+static bool fold_unary( int op );
+static void set_jump_target( long i );
+static void dump_code( void );
+static Var_T * arith( int     op,
+                      Var_T * v1,
+                      Var_T * v2 );
+
+
+/*--------------------------------------------------------------------*
+ * Translates the stored program tokens into code for the stack machine
+ * run by run_compiled_exp(). If this fails for whatever reason all
+ * memory is released again and the program will later on be executed
+ * by the parsers.
+ *--------------------------------------------------------------------*/
+
+void
+compile_exp( void )
+{
+    forget_compiled_exp( );
+
+    if (    EDL.prg_token == NULL
+         || ( Fsc2_Internals.cmdline_flags & NO_BYTECODE ) )
+        return;
+
+    TRY
+    {
+        Tok_to_instr = T_malloc( ( EDL.prg_length + 1 )
+                                 * sizeof *Tok_to_instr );
+        Skip_to = T_malloc( EDL.prg_length * sizeof *Skip_to );
+        for ( long i = 0; i < EDL.prg_length; i++ )
+        {
+            Tok_to_instr[ i ] = -1;
+            Skip_to[ i ] = NULL;
+        }
+        Tok_to_instr[ EDL.prg_length ] = -1;
+
+        Stack_depth = Max_stack_depth = 0;
+        Fold_start = 0;
+        Cur = EDL.prg_token;
+        Prg_end = EDL.prg_token + EDL.prg_length;
+        In_condition = false;
+
+        find_assigned_vars( );
+        compile_program( );
+
+        Tok_to_instr[ EDL.prg_length ] = Code_len;
+        emit( OP_END, Prg_end - 1, 0 );
+
+        resolve_jumps( );
+
+        /* The ON_STOP label must be at the start of a statement */
+
+        if (    EDL.On_Stop_Pos >= 0
+             && Tok_to_instr[ EDL.On_Stop_Pos ] < 0 )
+            not_compilable( );
+
+        Regs = T_malloc( ( Max_stack_depth + 1 ) * sizeof *Regs );
+        Skip_to = T_free( Skip_to );
+        Assigned_vars = T_free( Assigned_vars );
+        TRY_SUCCESS;
+    }
+    CATCH( EXCEPTION )
+        forget_compiled_exp( );
+    OTHERWISE
+    {
+        forget_compiled_exp( );
+        RETHROW;
+    }
+
+    if ( Fsc2_Internals.cmdline_flags & DUMP_BYTECODE )
+        dump_code( );
+}
+
+
+/*-------------------------------------------------*
+ * Releases all memory used for the compiled code.
+ *-------------------------------------------------*/
+
+void
+forget_compiled_exp( void )
+{
+    Code = T_free( Code );
+    Code_len = Code_size = 0;
+    Tok_to_instr = T_free( Tok_to_instr );
+    Regs = T_free( Regs );
+    Skip_to = T_free( Skip_to );
+    Assigned_vars = T_free( Assigned_vars );
+}
+
+
+/*------------------------------------------------------------*
+ * Returns if there's compiled code for the current program.
+ *------------------------------------------------------------*/
+
+bool
+exp_is_compiled( void )
+{
+    return Code != NULL;
+}
+
+
+/*-----------------------------------------------------------------------*
+ * Executes the compiled program, starting with the statement the global
+ * variable EDL.cur_prg_token points to. Like the parser the function
+ * returns at the start of the next statement when the 'do_quit' flag
+ * got set (and we're supposed to react to it) with EDL.cur_prg_token
+ * pointing to the statement. At the end of the program EDL.cur_prg_token
+ * is set to point to the (non-existing) token after the last one.
+ *-----------------------------------------------------------------------*/
+
+void
+run_compiled_exp( bool in_test )
+{
+    Exp_Instr_T * ip = Code + Tok_to_instr[   EDL.cur_prg_token
+                                            - EDL.prg_token ];
+    Var_T ** sp = Regs;
+    Prg_Token_T * on_stop = EDL.On_Stop_Pos >= 0 ?
+                            EDL.prg_token + EDL.On_Stop_Pos : NULL;
+    bool check_forms =    in_test
+                       && ! ( Fsc2_Internals.cmdline_flags & TEST_ONLY )
+                       && ! ( Fsc2_Internals.cmdline_flags & NO_GUI_RUN );
+    bool profiling = ! in_test && PROFILING;
+    bool checkpointing = ! in_test && CHECKPOINTING;
+    long count = 0;
+    Var_T * v;
+    Var_T * lhs;
+
+    fsc2_assert( ip >= Code );
+
+    while ( true )
+    {
+        EDL.Fname = ip->tok->Fname;
+        EDL.Lc    = ip->tok->Lc;
+        count++;
+
+        switch ( ip->op )
+        {
+            case OP_STMT :
+                fsc2_assert( EDL.Var_Stack == NULL );
+                EDL.cur_prg_token = ip->tok;
+
+                if ( profiling )
+                    profile_stmt( ip->tok );
+
+                if ( in_test )
+                {
+                    /* Give the 'Stop Test' button a chance to get tested */
+
+                    if ( check_forms && count >= CHECK_FORMS_AFTER )
+                    {
+                        fl_check_only_forms( );
+                        count = 0;
+                    }
+
+                    if ( EDL.do_quit )
+                        return;
+                }
+                else
+                {
+                    if ( EDL.do_quit && EDL.react_to_do_quit )
+                        return;
+
+                    /* Don't react to STOP button anymore after ON_STOP label
+                       has been reached */
+
+                    if ( ip->tok == on_stop )
+                        EDL.react_to_do_quit = EDL.do_quit = false;
+
+                    if ( checkpointing && checkpoint_due( ) )
+                        checkpoint_write( );
+                }
+
+                ip++;
+                break;
+
+            case OP_END :
+                EDL.cur_prg_token = EDL.prg_token + EDL.prg_length;
+                return;
+
+            case OP_JUMP :
+            case OP_SKIP :
+                ip = Code + ip->arg.target;
+                break;
+
+            case OP_IF :
+                v = *--sp;
+                ip = check_condition( ip->tok, v ) ?
+                     ip + 1 : Code + ip->arg.target;
+                break;
+
+            case OP_WHILE :
+                v = *--sp;
+                if ( check_condition( ip->tok, v ) )
+                {
+                    ip->tok->counter = 1;
+                    ip++;
+                }
+                else
+                {
+                    ip->tok->counter = 0;
+                    ip = Code + ip->arg.target;
+                }
+                break;
+
+            case OP_UNTIL :
+                v = *--sp;
+                if ( ! check_condition( ip->tok, v ) )
+                {
+                    ip->tok->counter = 1;
+                    ip++;
+                }
+                else
+                {
+                    ip->tok->counter = 0;
+                    ip = Code + ip->arg.target;
+                }
+                break;
+
+            case OP_REPEAT_ENTER :
+                ip = ip->tok->counter == 0 ? ip + 1 : Code + ip->arg.target;
+                break;
+
+            case OP_REPEAT_SET :
+                set_max_repeat_count( ip->tok, *--sp );
+                ip++;
+                break;
+
+            case OP_REPEAT_TEST :
+                if ( ++ip->tok->count.repl.act <= ip->tok->count.repl.max )
+                {
+                    ip->tok->counter++;
+                    ip++;
+                }
+                else
+                {
+                    ip->tok->counter = 0;
+                    ip = Code + ip->arg.target;
+                }
+                break;
+
+            case OP_FOR_ENTER :
+                if ( ip->tok->counter != 0 )
+                    ip = Code + ip->arg.target;
+                else
+                {
+                    set_for_var( ip->tok, ( ip->tok + 1 )->tv.vptr );
+                    ip++;
+                }
+                break;
+
+            case OP_FOR_START :
+                set_for_start( ip->tok, *--sp );
+                ip++;
+                break;
+
+            case OP_FOR_END :
+                set_for_end( ip->tok, *--sp );
+                ip++;
+                break;
+
+            case OP_FOR_INCR :
+                set_for_incr( ip->tok, ip->n ? *--sp : NULL );
+                ip++;
+                break;
+
+            case OP_FOR_TEST :
+                if ( test_for_cond( ip->tok ) )
+                {
+                    ip->tok->counter = 1;
+                    ip++;
+                }
+                else
+                {
+                    ip->tok->counter = 0;
+                    ip = Code + ip->arg.target;
+                }
+                break;
+
+            case OP_FOREVER :
+                if ( ! in_test )
+                    ip++;
+                else if ( ip->tok->counter )
+                {
+                    ip->tok->counter = 0;
+                    ip++;
+                }
+                else                        /* get out of infinite loop! */
+                {
+                    ip->tok->counter = 0;
+                    ip = Code + ip->arg.target;
+                }
+                break;
+
+            case OP_BREAK :
+                ip->tok->start->counter = 0;
+                ip = Code + ip->arg.target;
+                break;
+
+            case OP_PUSH_INT :
+                *sp++ = vars_push( INT_VAR, ip->arg.lval );
+                ip++;
+                break;
+
+            case OP_PUSH_FLOAT :
+                *sp++ = vars_push( FLOAT_VAR, ip->arg.dval );
+                ip++;
+                break;
+
+            case OP_PUSH_STR :
+                *sp++ = vars_push( STR_VAR, ip->arg.sptr );
+                ip++;
+                break;
+
+            case OP_CAT_STR :
+                v = vars_push( STR_VAR, ip->arg.sptr );
+                sp[ -1 ] = vars_add( sp[ -1 ], v );
+                ip++;
+                break;
+
+            case OP_PUSH_VAR :
+                *sp++ = vars_push_copy( ip->arg.vptr );
+                ip++;
+                break;
+
+            case OP_PUSH_TOKEN_VAR :
+                *sp++ = push_token_var( ip->tok );
+                ip++;
+                break;
+
+            case OP_LHS_VAR :
+                *sp++ = ip->arg.vptr;
+                ip++;
+                break;
+
+            case OP_ARR_START :
+                vars_arr_start( ip->arg.vptr );
+                ip++;
+                break;
+
+            case OP_NO_INDEX :
+                *sp++ = vars_push( UNDEF_VAR );
+                ip++;
+                break;
+
+            case OP_RANGE :
+                vars_push( STR_VAR, ":" );
+                ip++;
+                break;
+
+            case OP_ARR_RHS :
+                v = vars_arr_rhs( sp[ -1 ] );
+                sp -= ip->n;
+                *sp++ = v;
+                ip++;
+                break;
+
+            case OP_ARR_LHS :
+                v = vars_arr_lhs( sp[ -1 ] );
+                sp -= ip->n;
+                *sp++ = v;
+                ip++;
+                break;
+
+            case OP_CALL :              /* 'sub' is set if already checked */
+                v = ip->sub ? func_call_bound( sp[ - ip->n - 1 ] ) :
+                              func_call( sp[ - ip->n - 1 ] );
+                sp -= ip->n + 1;
+                *sp++ = v;
+                ip++;
+                break;
+
+            case OP_CALL_STMT :
+                vars_pop( ip->sub ? func_call_bound( sp[ - ip->n - 1 ] ) :
+                                    func_call( sp[ - ip->n - 1 ] ) );
+                sp -= ip->n + 1;
+                ip++;
+                break;
+
+            case OP_P_GET :
+                *sp++ = p_get_by_num( ip->n, ip->sub );
+                ip++;
+                break;
+
+            case OP_P_SET :
+                p_set( ip->n, ip->sub, *--sp );
+                ip++;
+                break;
+
+            case OP_P_SET_OP :
+                v = *--sp;
+                p_set( ip->n, ip->sub,
+                       arith( ip->arg.lval,
+                              p_get_by_num( ip->n, ip->sub ), v ) );
+                ip++;
+                break;
+
+            case OP_ASSIGN :
+                v = *--sp;
+                lhs = *--sp;
+                if ( v->type == STR_VAR )
+                {
+                    print( FATAL, "A string can't be assigned to a "
+                           "variable.\n" );
+                    THROW( EXCEPTION );
+                }
+                vars_assign( v, lhs );
+                ip++;
+                break;
+
+            case OP_ASSIGN_OP :
+                v = *--sp;
+                lhs = *--sp;
+                vars_assign( arith( ip->sub, lhs, v ), lhs );
+                ip++;
+                break;
+
+            case OP_ADD :
+                v = *--sp;
+                sp[ -1 ] = vars_add( sp[ -1 ], v );
+                ip++;
+                break;
+
+            case OP_SUB :
+                v = *--sp;
+                sp[ -1 ] = vars_sub( sp[ -1 ], v );
+                ip++;
+                break;
+
+            case OP_MULT :
+                v = *--sp;
+                sp[ -1 ] = vars_mult( sp[ -1 ], v );
+                ip++;
+                break;
+
+            case OP_DIV :
+                v = *--sp;
+                sp[ -1 ] = vars_div( sp[ -1 ], v );
+                ip++;
+                break;
+
+            case OP_MOD :
+                v = *--sp;
+                sp[ -1 ] = vars_mod( sp[ -1 ], v );
+                ip++;
+                break;
+
+            case OP_POW :
+                v = *--sp;
+                sp[ -1 ] = vars_pow( sp[ -1 ], v );
+                ip++;
+                break;
+
+            case OP_COMP :                  /* 'n' is set for '>' and '>=' */
+                v = *--sp;
+                sp[ -1 ] = ip->n ? vars_comp( ip->sub, v, sp[ -1 ] ) :
+                                   vars_comp( ip->sub, sp[ -1 ], v );
+                ip++;
+                break;
+
+            case OP_NEG :
+                sp[ -1 ] = vars_negate( sp[ -1 ] );
+                ip++;
+                break;
+
+            case OP_LNEG :
+                sp[ -1 ] = vars_lnegate( sp[ -1 ] );
+                ip++;
+                break;
+
+            case OP_AND :
+                if ( check_result( sp[ -1 ] ) )
+                    ip++;
+                else
+                {
+                    vars_pop( sp[ -1 ] );
+                    sp[ -1 ] = vars_push( INT_VAR, 0L );
+                    ip = Code + ip->arg.target;
+                }
+                break;
+
+            case OP_OR :
+                if ( ! check_result( sp[ -1 ] ) )
+                    ip++;
+                else
+                {
+                    vars_pop( sp[ -1 ] );
+                    sp[ -1 ] = vars_push( INT_VAR, 1L );
+                    ip = Code + ip->arg.target;
+                }
+                break;
+
+            case OP_TERN :
+                v = *--sp;
+                if ( check_result( v ) )
+                {
+                    vars_pop( v );
+                    ip++;
+                }
+                else
+                {
+                    vars_pop( v );
+                    ip = Code + ip->arg.target;
+                }
+                break;
+
+            default :
+                fsc2_impossible( );
+        }
+    }
+}
+
+
+/*------------------------------------------------------------------*
+ * Called whenever the compiler finds something it can't deal with.
+ *------------------------------------------------------------------*/
+
+static void
+not_compilable( void )
+{
+    THROW( EXCEPTION );
+}
+
+
+/*------------------------------------------------------------------*
+ * Returns the type of a program token or 0 if it is past the end of
+ * the program.
+ *------------------------------------------------------------------*/
+
+static int
+token_at( Prg_Token_T * t )
+{
+    return t < Prg_end ? t->token : 0;
+}
+
+
+/*-----------------------------------------------------------------------*
+ * Appends a new instruction to the code and returns a pointer to it
+ * (only valid until the next instruction is added). 'delta' is the
+ * change of the number of intermediate results the instruction creates
+ * when executed and is used to find out how large the register stack
+ * has to be.
+ *-----------------------------------------------------------------------*/
+
+static Exp_Instr_T *
+emit( int           op,
+      Prg_Token_T * tok,
+      long          delta )
+{
+    if ( Code_len == Code_size )
+    {
+        Code = T_realloc( Code, ( Code_size + CODE_CHUNK_SIZE )
+                                * sizeof *Code );
+        Code_size += CODE_CHUNK_SIZE;
+    }
+
+    Exp_Instr_T * ip = Code + Code_len++;
+
+    ip->op       = op;
+    ip->sub      = 0;
+    ip->n        = 0;
+    ip->tok      = tok;
+    ip->arg.lval = 0;
+
+    if ( ( Stack_depth += delta ) > Max_stack_depth )
+        Max_stack_depth = Stack_depth;
+
+    return ip;
+}
+
+
+/*-----------------------------------------------------------------------*
+ * Appends an instruction that jumps to the code for a program token (or
+ * to the end of the program if 'target' is NULL). Since the code for the
+ * target token might not exist yet the token index gets stored for the
+ * moment and will be replaced by the instruction index by resolve_jumps().
+ *-----------------------------------------------------------------------*/
+
+static void
+emit_jump( int           op,
+           Prg_Token_T * tok,
+           Prg_Token_T * target,
+           long          delta )
+{
+    emit( op, tok, delta )->arg.target =
+                    target != NULL ? target - EDL.prg_token : EDL.prg_length;
+}
+
+
+/*----------------------------------------------------------------------*
+ * Compiles the whole program, statement by statement and control flow
+ * token by control flow token, recording for each of them the index of
+ * the instruction the code for it starts with.
+ *----------------------------------------------------------------------*/
+
+static void
+compile_program( void )
+{
+    while ( Cur < Prg_end )
+    {
+        Tok_to_instr[ Cur - EDL.prg_token ] = Code_len;
+
+        switch ( Cur->token )
+        {
+            case ELSE_TOK :                 /* needs no code of its own */
+                if ( Skip_to[ Cur - EDL.prg_token ] != NULL )
+                    Cur = Skip_to[ Cur - EDL.prg_token ];
+                else if ( token_at( ++Cur ) == '{' )
+                    Cur++;
+                break;
+
+            case '}' :
+                emit( OP_STMT, Cur, 0 );
+                emit_jump( OP_JUMP, Cur, Cur->end, 0 );
+                Cur++;
+                break;
+
+            case NEXT_TOK :
+                emit( OP_STMT, Cur, 0 );
+                emit_jump( OP_JUMP, Cur, Cur->start, 0 );
+                Cur++;
+                break;
+
+            case BREAK_TOK :
+                emit( OP_STMT, Cur, 0 );
+                emit_jump( OP_BREAK, Cur, Cur->start->end, 0 );
+                Cur++;
+                break;
+
+            case IF_TOK :
+            case UNLESS_TOK :
+                compile_condition( OP_IF );
+                break;
+
+            case WHILE_TOK :
+                compile_condition( OP_WHILE );
+                break;
+
+            case UNTIL_TOK :
+                compile_condition( OP_UNTIL );
+                break;
+
+            case REPEAT_TOK :
+                compile_repeat( );
+                break;
+
+            case FOR_TOK :
+                compile_for( );
+                break;
+
+            case FOREVER_TOK :
+            {
+                Prg_Token_T * hdr = Cur;
+
+                emit( OP_STMT, hdr, 0 );
+                if ( token_at( ++Cur ) != '{' )
+                    not_compilable( );
+                emit_jump( OP_FOREVER, hdr, hdr->end, 0 );
+                if ( hdr->start != ++Cur )
+                    not_compilable( );
+                break;
+            }
+
+            default :
+                emit( OP_STMT, Cur, 0 );
+                if ( Cur->token != ';' )
+                    compile_statement( );
+
+                if ( Stack_depth != 0 )
+                    not_compilable( );
+
+                /* A statement may also be ended by the closing brace of a
+                   block, which then gets dealt with on its own */
+
+                if ( token_at( Cur ) == ';' )
+                    Cur++;
+                else if ( token_at( Cur ) != '}' )
+                    not_compilable( );
+                break;
+        }
+    }
+}
+
+
+/*-------------------------------------------------------------------*
+ * Compiles the condition of an IF, UNLESS, WHILE or UNTIL construct.
+ * If the condition is a constant no code for testing it is needed.
+ * When the block can never be entered it gets skipped completely, and
+ * if it's always entered for an IF or UNLESS an ELSE part gets marked
+ * to be skipped (the closing '}' of the block already jumps over it).
+ *-------------------------------------------------------------------*/
+
+static void
+compile_condition( int op )
+{
+    Prg_Token_T * hdr = Cur++;
+    long stmt = Code_len;
+
+    emit( OP_STMT, hdr, 0 );
+    compile_condition_expr( );
+    if ( token_at( Cur ) != '{' )
+        not_compilable( );
+
+    if ( Code_len != stmt + 2 || ! is_const( stmt + 1 ) )
+    {
+        emit_jump( op, hdr, hdr->end, -1 );
+        if ( hdr->start != ++Cur )
+            not_compilable( );
+        return;
+    }
+
+    bool enter = const_is_true( stmt + 1 ) == ( hdr->token != UNLESS_TOK );
+
+    Code_len--;
+    Stack_depth--;
+
+    if ( op == OP_UNTIL )
+        enter = ! enter;
+
+    if ( ! enter )
+    {
+        Cur = hdr->end != NULL ? hdr->end : Prg_end;
+        return;
+    }
+
+    if ( op == OP_IF && token_at( hdr->end ) == ELSE_TOK )
+    {
+        Prg_Token_T * after = ( hdr->end - 1 )->end;
+
+        Skip_to[ hdr->end - EDL.prg_token ] = after != NULL ? after : Prg_end;
+    }
+
+    if ( hdr->start != ++Cur )
+        not_compilable( );
+}
+
+
+/*-------------------------------------*
+ * Compiles the head of a REPEAT loop.
+ *-------------------------------------*/
+
+static void
+compile_repeat( void )
+{
+    Prg_Token_T * hdr = Cur++;
+
+    emit( OP_STMT, hdr, 0 );
+
+    long enter = Code_len;
+    emit( OP_REPEAT_ENTER, hdr, 0 );
+
+    compile_condition_expr( );
+    if ( token_at( Cur ) != '{' )
+        not_compilable( );
+    emit( OP_REPEAT_SET, hdr, -1 );
+
+    Code[ enter ].arg.target = Code_len;
+    emit_jump( OP_REPEAT_TEST, hdr, hdr->end, 0 );
+    if ( hdr->start != ++Cur )
+        not_compilable( );
+}
+
+
+/*----------------------------------*
+ * Compiles the head of a FOR loop.
+ *----------------------------------*/
+
+static void
+compile_for( void )
+{
+    Prg_Token_T * hdr = Cur++;
+
+    emit( OP_STMT, hdr, 0 );
+
+    if ( token_at( Cur ) != E_VAR_TOKEN || token_at( Cur + 1 ) != '=' )
+        not_compilable( );
+
+    long enter = Code_len;
+    emit( OP_FOR_ENTER, hdr, 0 );
+
+    Cur += 2;
+    compile_condition_expr( );
+    if ( token_at( Cur ) != ':' )
+        not_compilable( );
+    emit( OP_FOR_START, hdr, -1 );
+
+    Cur++;
+    compile_condition_expr( );
+    emit( OP_FOR_END, hdr, -1 );
+
+    if ( token_at( Cur ) != ':' )
+        emit( OP_FOR_INCR, hdr, 0 );
+    else
+    {
+        Cur++;
+        compile_condition_expr( );
+        emit( OP_FOR_INCR, hdr, -1 )->n = 1;
+    }
+
+    if ( token_at( Cur ) != '{' )
+        not_compilable( );
+
+    Code[ enter ].arg.target = Code_len;
+    emit_jump( OP_FOR_TEST, hdr, hdr->end, 0 );
+    if ( hdr->start != ++Cur )
+        not_compilable( );
+}
+
+
+/*---------------------------------------------------------------------*
+ * Compiles an expression in a loop or IF condition. The only difference
+ * to other expressions is that the condition parser doesn't allow
+ * ranges in array indices.
+ *---------------------------------------------------------------------*/
+
+static void
+compile_condition_expr( void )
+{
+    In_condition = true;
+    compile_expr( 1 );
+    In_condition = false;
+}
+
+
+/*------------------------------------------------------------*
+ * Compiles a statement, i.e. an assignment or function call.
+ *------------------------------------------------------------*/
+
+static void
+compile_statement( void )
+{
+    Prg_Token_T * t = Cur;
+    Prg_Token_T * ass;
+    Exp_Instr_T * ip;
+    long n;
+    int aop;
+
+    switch ( t->token )
+    {
+        case E_VAR_TOKEN :
+            if ( token_at( t + 1 ) == '[' )
+            {
+                emit( OP_ARR_START, t, 0 )->arg.vptr = t->tv.vptr;
+                Cur += 2;
+                n = compile_index_list( );
+                emit( OP_ARR_LHS, t, 1 - n )->n = n;
+            }
+            else
+            {
+                emit( OP_LHS_VAR, t, 1 )->arg.vptr = t->tv.vptr;
+                Cur++;
+            }
+
+            ass = Cur++;
+            aop = assignment_op( token_at( ass ) );
+            compile_expr( 1 );
+
+            if ( aop == OP_ASSIGN )
+                emit( OP_ASSIGN, ass, -2 );
+            else
+                emit( OP_ASSIGN_OP, ass, -2 )->sub = aop;
+            break;
+
+        case E_FUNC_TOKEN :
+            if ( token_at( t + 1 ) != '(' )
+                not_compilable( );
+            emit( OP_PUSH_TOKEN_VAR, t, 1 );
+            Cur += 2;
+            n = compile_arg_list( );
+            ip = emit( OP_CALL_STMT, t, - n - 1 );
+            ip->n = n;
+            ip->sub = func_args_ok( t->tv.vptr, n );
+            break;
+
+        case E_PPOS :
+        case E_PLEN :
+        case E_PDPOS :
+        case E_PDLEN :
+            ass = ++Cur;
+            Cur++;
+            aop = assignment_op( token_at( ass ) );
+            compile_expr( 1 );
+
+            ip = emit( aop == OP_ASSIGN ? OP_P_SET : OP_P_SET_OP, ass, -1 );
+            ip->n = t->tv.lval;
+            ip->sub = pulse_property( t->token );
+            ip->arg.lval = aop;
+            break;
+
+        default :
+            not_compilable( );
+    }
+}
+
+
+/*---------------------------------------------------------------------*
+ * Compiles an expression by precedence climbing, stopping at the first
+ * operator with a lower precedence than 'min_prec'. The precedences
+ * and associativities are the same as in the parsers:
+ *  1: ?:                     (left associative)
+ *  2: AND OR XOR             (left associative)
+ *  3: == != < <= > >=        (left associative)
+ *  4: + -                    (left associative)
+ *  5: * /                    (left associative)
+ *  6: %                      (left associative)
+ *  7: unary + - !
+ *  8: ^                      (right associative)
+ *---------------------------------------------------------------------*/
+
+static void
+compile_expr( int min_prec )
+{
+    compile_operand( );
+
+    while ( true )
+    {
+        Prg_Token_T * op = Cur;
+        int prec = precedence( token_at( op ) );
+        long skip;
+        long skip2;
+        int sub;
+
+        if ( prec == 0 || prec < min_prec )
+            return;
+
+        Cur++;
+
+        switch ( op->token )
+        {
+            case '?' :
+                if ( is_const( Code_len - 1 ) )
+                {
+                    compile_const_tern( prec );
+                    break;
+                }
+
+                skip = Code_len;
+                emit( OP_TERN, op, -1 );
+                compile_expr( 1 );
+                if ( token_at( Cur ) != ':' )
+                    not_compilable( );
+                Cur++;
+
+                skip2 = Code_len;
+                emit( OP_SKIP, op, -1 );
+                set_jump_target( skip );
+                compile_expr( prec + 1 );
+                set_jump_target( skip2 );
+                break;
+
+            case E_AND :
+            case E_OR :
+                sub = op->token == E_AND ? COMP_AND : COMP_OR;
+
+                /* If the left hand side is a constant that already decides
+                   the result the right hand side never gets evaluated, so
+                   its code is thrown away again. Otherwise the result just
+                   depends on the right hand side. */
+
+                if ( is_const( Code_len - 1 ) )
+                {
+                    long left = Code_len - 1;
+                    bool is_true = const_is_true( left );
+
+                    if ( is_true == ( sub == COMP_OR ) )
+                    {
+                        long depth = Stack_depth;
+                        long fold_start = Fold_start;
+
+                        compile_expr( prec + 1 );
+                        Code_len = left + 1;
+                        Stack_depth = depth;
+                        Fold_start = fold_start;
+                        Code[ left ].op = OP_PUSH_INT;
+                        Code[ left ].arg.lval = is_true ? 1 : 0;
+                    }
+                    else
+                    {
+                        compile_expr( prec + 1 );
+                        if ( ! fold_binary( OP_COMP, sub, 0 ) )
+                            emit( OP_COMP, op, -1 )->sub = sub;
+                    }
+                    break;
+                }
+
+                skip = Code_len;
+                emit( op->token == E_AND ? OP_AND : OP_OR, op, 0 );
+                compile_expr( prec + 1 );
+                emit( OP_COMP, op, -1 )->sub = sub;
+                set_jump_target( skip );
+                break;
+
+            case '^' :
+                compile_expr( prec );
+                emit( OP_POW, op, -1 );
+                break;
+
+            default :
+                compile_expr( prec + 1 );
+                emit_binary( op );
+                break;
+        }
+    }
+}
+
+
+/*-------------------------------------------------------------------*
+ * Compiles an operand, i.e. a number, string, variable, array slice,
+ * function call, pulse property, expression in parentheses or the
+ * operand of a unary operator.
+ *-------------------------------------------------------------------*/
+
+static void
+compile_operand( void )
+{
+    Prg_Token_T * t = Cur;
+    Exp_Instr_T * ip;
+    long n;
+
+    switch ( token_at( t ) )
+    {
+        case E_INT_TOKEN :
+            emit( OP_PUSH_INT, t, 1 )->arg.lval = t->tv.lval;
+            Cur++;
+            break;
+
+        case E_FLOAT_TOKEN :
+            emit( OP_PUSH_FLOAT, t, 1 )->arg.dval = t->tv.dval;
+            Cur++;
+            break;
+
+        case E_STR_TOKEN :              /* adjacent strings get concatenated */
+            emit( OP_PUSH_STR, t, 1 )->arg.sptr = t->tv.sptr;
+            while ( token_at( ++Cur ) == E_STR_TOKEN )
+                emit( OP_CAT_STR, Cur, 0 )->arg.sptr = Cur->tv.sptr;
+            break;
+
+        case E_VAR_TOKEN :
+            if ( token_at( t + 1 ) == '[' )
+            {
+                emit( OP_ARR_START, t, 0 )->arg.vptr = t->tv.vptr;
+                Cur += 2;
+                n = compile_index_list( );
+                emit( OP_ARR_RHS, t, 1 - n )->n = n;
+            }
+            else if ( token_at( t + 1 ) == '(' )
+                not_compilable( );
+            else
+            {
+                if ( ! is_const_var( t->tv.vptr ) )
+                    emit( OP_PUSH_VAR, t, 1 )->arg.vptr = t->tv.vptr;
+                else if ( t->tv.vptr->type == INT_VAR )
+                    emit( OP_PUSH_INT, t, 1 )->arg.lval = t->tv.vptr->INT;
+                else
+                    emit( OP_PUSH_FLOAT, t, 1 )->arg.dval = t->tv.vptr->FLOAT;
+                Cur++;
+            }
+            break;
+
+        case E_VAR_REF :
+            emit( OP_PUSH_TOKEN_VAR, t, 1 );
+            Cur++;
+            break;
+
+        case E_FUNC_TOKEN :
+            if ( token_at( t + 1 ) != '(' )
+                not_compilable( );
+            emit( OP_PUSH_TOKEN_VAR, t, 1 );
+            Cur += 2;
+            n = compile_arg_list( );
+            ip = emit( OP_CALL, t, - n );
+            ip->n = n;
+            ip->sub = func_args_ok( t->tv.vptr, n );
+            break;
+
+        case E_PPOS :
+        case E_PLEN :
+        case E_PDPOS :
+        case E_PDLEN :
+            ip = emit( OP_P_GET, t, 1 );
+            ip->n = t->tv.lval;
+            ip->sub = pulse_property( t->token );
+            Cur++;
+            break;
+
+        case '+' :
+            Cur++;
+            compile_expr( UNARY_OPERAND_PREC );
+            break;
+
+        case '-' :
+            Cur++;
+            compile_expr( UNARY_OPERAND_PREC );
+            if ( ! fold_unary( OP_NEG ) )
+                emit( OP_NEG, t, 0 );
+            break;
+
+        case E_NOT :
+            Cur++;
+            compile_expr( UNARY_OPERAND_PREC );
+            if ( ! fold_unary( OP_LNEG ) )
+                emit( OP_LNEG, t, 0 );
+            break;
+
+        case '(' :
+            Cur++;
+            compile_expr( 1 );
+            if ( token_at( Cur ) != ')' )
+                not_compilable( );
+            Cur++;
+            break;
+
+        default :
+            not_compilable( );
+    }
+}
+
+
+/*------------------------------------------------------------*
+ * Emits the instruction for a binary arithmetic or comparison
+ * operator (except '^', AND and OR) unless both operands are
+ * constants and the operation can be done right away.
+ *------------------------------------------------------------*/
+
+static void
+emit_binary( Prg_Token_T * op )
+{
+    int code = OP_COMP;
+    int sub = 0;
+    long n = 0;
+
+    switch ( op->token )
+    {
+        case '+' :
+            code = OP_ADD;
+            break;
+
+        case '-' :
+            code = OP_SUB;
+            break;
+
+        case '*' :
+            code = OP_MULT;
+            break;
+
+        case '/' :
+            code = OP_DIV;
+            break;
+
+        case '%' :
+            code = OP_MOD;
+            break;
+
+        case E_XOR :
+            sub = COMP_XOR;
+            break;
+
+        case E_EQ :
+            sub = COMP_EQUAL;
+            break;
+
+        case E_NE :
+            sub = COMP_UNEQUAL;
+            break;
+
+        case E_LT :
+            sub = COMP_LESS;
+            break;
+
+        case E_GT :
+            sub = COMP_LESS;
+            n = 1;
+            break;
+
+        case E_LE :
+            sub = COMP_LESS_EQUAL;
+            break;
+
+        case E_GE :
+            sub = COMP_LESS_EQUAL;
+            n = 1;
+            break;
+
+        default :
+            not_compilable( );
+    }
+
+    if ( fold_binary( code, sub, n ) )
+        return;
+
+    Exp_Instr_T * ip = emit( code, op, -1 );
+
+    ip->sub = sub;
+    ip->n = n;
+}
+
+
+/*--------------------------------------------------------------------*
+ * Compiles the rest of a '?:' expression with a constant condition.
+ * The condition gets removed and only the code for the alternative
+ * that is going to be used is kept. Its code is put where the code
+ * for the condition was, so it may get folded with what comes before.
+ *--------------------------------------------------------------------*/
+
+static void
+compile_const_tern( int prec )
+{
+    long cond = Code_len - 1;
+    bool is_true = const_is_true( cond );
+    long depth = --Stack_depth;
+    long fold_start = Fold_start;
+
+    Code_len--;
+
+    compile_expr( 1 );
+    if ( token_at( Cur ) != ':' )
+        not_compilable( );
+    Cur++;
+
+    if ( is_true )
+    {
+        cond = Code_len;
+        depth = Stack_depth;
+        fold_start = Fold_start;
+    }
+    else
+    {
+        Code_len = cond;
+        Stack_depth = depth;
+        Fold_start = fold_start;
+    }
+
+    compile_expr( prec + 1 );
+
+    if ( is_true )
+    {
+        Code_len = cond;
+        Stack_depth = depth;
+        Fold_start = fold_start;
+    }
+}
+
+
+/*-----------------------------------------------------------------------*
+ * Compiles the list of indices of an array (the opening '[' has already
+ * been dealt with, the closing ']' gets removed) and returns the number
+ * of intermediate results it produces.
+ *-----------------------------------------------------------------------*/
+
+static long
+compile_index_list( void )
+{
+    if ( token_at( Cur ) == ']' )
+    {
+        emit( OP_NO_INDEX, Cur++, 1 );
+        return 1;
+    }
+
+    long n = 0;
+
+    while ( true )
+    {
+        compile_expr( 1 );
+        n++;
+
+        if ( token_at( Cur ) == ':' )
+        {
+            if ( In_condition )
+                not_compilable( );
+            emit( OP_RANGE, Cur++, 0 );
+            compile_expr( 1 );
+            n++;
+        }
+
+        if ( token_at( Cur ) == ']' )
+        {
+            Cur++;
+            return n;
+        }
+
+        if ( token_at( Cur ) != ',' )
+            not_compilable( );
+        Cur++;
+    }
+}
+
+
+/*------------------------------------------------------------------*
+ * Compiles the list of arguments of a function call (the opening
+ * '(' has already been dealt with, the closing ')' gets removed)
+ * and returns the number of arguments.
+ *------------------------------------------------------------------*/
+
+static long
+compile_arg_list( void )
+{
+    if ( token_at( Cur ) == ')' )
+    {
+        Cur++;
+        return 0;
+    }
+
+    long n = 0;
+
+    while ( true )
+    {
+        compile_expr( 1 );
+        n++;
+
+        if ( token_at( Cur ) == ')' )
+        {
+            Cur++;
+            return n;
+        }
+
+        if ( token_at( Cur ) != ',' )
+            not_compilable( );
+        Cur++;
+    }
+}
+
+
+/*--------------------------------------------------------------*
+ * Returns the precedence of a binary operator token or 0 if the
+ * token isn't a binary operator.
+ *--------------------------------------------------------------*/
+
+static int
+precedence( int token )
+{
+    switch ( token )
+    {
+        case '?' :
+            return 1;
+
+        case E_AND : case E_OR : case E_XOR :
+            return 2;
+
+        case E_EQ : case E_NE : case E_LT : case E_LE : case E_GT : case E_GE :
+            return 3;
+
+        case '+' : case '-' :
+            return 4;
+
+        case '*' : case '/' :
+            return 5;
+
+        case '%' :
+            return 6;
+
+        case '^' :
+            return 8;
+    }
+
+    return 0;
+}
+
+
+/*-----------------------------------------------------------------*
+ * Returns the instruction code for the arithmetic operation of a
+ * compound assignment operator or OP_ASSIGN for a plain assignment.
+ *-----------------------------------------------------------------*/
+
+static int
+assignment_op( int token )
+{
+    switch ( token )
+    {
+        case '=' :
+            return OP_ASSIGN;
+
+        case E_PLSA :
+            return OP_ADD;
+
+        case E_MINA :
+            return OP_SUB;
+
+        case E_MULA :
+            return OP_MULT;
+
+        case E_DIVA :
+            return OP_DIV;
+
+        case E_MODA :
+            return OP_MOD;
+
+        case E_EXPA :
+            return OP_POW;
+    }
+
+    not_compilable( );
+    return -1;
+}
+
+
+/*------------------------------------------------------*
+ * Returns the pulse property for a pulse property token
+ *------------------------------------------------------*/
+
+static int
+pulse_property( int token )
+{
+    switch ( token )
+    {
+        case E_PPOS :
+            return P_POS;
+
+        case E_PLEN :
+            return P_LEN;
+
+        case E_PDPOS :
+            return P_DPOS;
+
+        case E_PDLEN :
+            return P_DLEN;
+    }
+
+    not_compilable( );
+    return -1;
+}
+
+
+/*------------------------------------------------------------------*
+ * Replaces the token indices stored as targets of jumps to program
+ * tokens by the indices of the instructions the code for the tokens
+ * starts with. A jump from the end of the block of a FOR or REPEAT
+ * loop (or a NEXT) back to the loop header, where the loop has been
+ * entered already, goes directly to the instruction testing the loop
+ * condition since only the loop variable or counter has to be updated
+ * and checked, not the values from the loop header.
+ *------------------------------------------------------------------*/
+
+static void
+resolve_jumps( void )
+{
+    for ( Exp_Instr_T * ip = Code; ip < Code + Code_len; ip++ )
+        switch ( ip->op )
+        {
+            case OP_JUMP :
+                if ( ( ip->arg.target = Tok_to_instr[ ip->arg.target ] ) < 0 )
+                    not_compilable( );
+                if (    Code[ ip->arg.target ].op == OP_STMT
+                     && (    Code[ ip->arg.target + 1 ].op == OP_FOR_ENTER
+                          || Code[ ip->arg.target + 1 ].op
+                                                        == OP_REPEAT_ENTER ) )
+                    ip->arg.target = Code[ ip->arg.target + 1 ].arg.target;
+                break;
+
+            case OP_IF :
+            case OP_WHILE :
+            case OP_UNTIL :
+            case OP_REPEAT_TEST :
+            case OP_FOR_TEST :
+            case OP_FOREVER :
+            case OP_BREAK :
+                if ( ( ip->arg.target = Tok_to_instr[ ip->arg.target ] ) < 0 )
+                    not_compilable( );
+                break;
+        }
+}
+
+
+/*--------------------------------------------------------------------*
+ * Creates a sorted list of all variables that get assigned a value
+ * somewhere in the program (this includes the variables of FOR loops).
+ *--------------------------------------------------------------------*/
+
+static void
+find_assigned_vars( void )
+{
+    Prg_Token_T * t;
+
+    Num_assigned_vars = 0;
+
+    for ( int pass = 0; pass < 2; pass++ )
+    {
+        for ( t = EDL.prg_token; t + 1 < Prg_end; t++ )
+        {
+            if ( t->token != E_VAR_TOKEN )
+                continue;
+
+            switch ( ( t + 1 )->token )
+            {
+                case '=' :
+                case E_PLSA :
+                case E_MINA :
+                case E_MULA :
+                case E_DIVA :
+                case E_MODA :
+                case E_EXPA :
+                    if ( pass == 1 )
+                        Assigned_vars[ Num_assigned_vars ] = t->tv.vptr;
+                    Num_assigned_vars++;
+                    break;
+            }
+        }
+
+        if ( pass == 0 )
+        {
+            if ( Num_assigned_vars == 0 )
+                return;
+            Assigned_vars = T_malloc( Num_assigned_vars
+                                      * sizeof *Assigned_vars );
+            Num_assigned_vars = 0;
+        }
+    }
+
+    qsort( Assigned_vars, Num_assigned_vars, sizeof *Assigned_vars,
+           var_ptr_cmp );
+}
+
+
+/*-------------------------------------------------------*
+ * Comparison function for sorting and searching the list
+ * of variables that get assigned to.
+ *-------------------------------------------------------*/
+
+static int
+var_ptr_cmp( const void * a,
+             const void * b )
+{
+    Var_T * const * va = a;
+    Var_T * const * vb = b;
+
+    if ( *va == *vb )
+        return 0;
+    return *va < *vb ? -1 : 1;
+}
+
+
+/*-------------------------------------------------------------------*
+ * Returns if a variable is a simple integer or floating point number
+ * with a value that can't change anymore while the program is run.
+ *-------------------------------------------------------------------*/
+
+static bool
+is_const_var( Var_T * v )
+{
+    if (    ! ( v->type & ( INT_VAR | FLOAT_VAR ) )
+         || v->flags & NEW_VARIABLE )
+        return false;
+
+    return    Num_assigned_vars == 0
+           || bsearch( &v, Assigned_vars, Num_assigned_vars,
+                       sizeof *Assigned_vars, var_ptr_cmp ) == NULL;
+}
+
+
+/*---------------------------------------------------------------------*
+ * Returns if the instruction with index 'i' pushes a constant number
+ * and can be merged with the following ones, i.e. it isn't jumped to.
+ *---------------------------------------------------------------------*/
+
+static bool
+is_const( long i )
+{
+    return    i >= Fold_start
+           && i < Code_len
+           && ( Code[ i ].op == OP_PUSH_INT || Code[ i ].op == OP_PUSH_FLOAT );
+}
+
+
+/*--------------------------------------------------------*
+ * Returns if a constant counts as true in a condition.
+ *--------------------------------------------------------*/
+
+static bool
+const_is_true( long i )
+{
+    if ( Code[ i ].op == OP_PUSH_INT )
+        return Code[ i ].arg.lval != 0;
+    return Code[ i ].arg.dval != 0.0;
+}
+
+
+/*------------------------------------------------------------*
+ * Pushes a variable with the value of a constant on the stack
+ *------------------------------------------------------------*/
+
+static Var_T *
+const_to_var( long i )
+{
+    if ( Code[ i ].op == OP_PUSH_INT )
+        return vars_push( INT_VAR, Code[ i ].arg.lval );
+    return vars_push( FLOAT_VAR, Code[ i ].arg.dval );
+}
+
+
+/*------------------------------------------------------------------*
+ * Makes the instruction with index 'i' push the value of a variable
+ * (which gets popped from the stack).
+ *------------------------------------------------------------------*/
+
+static void
+var_to_const( long    i,
+              Var_T * v )
+{
+    if ( v->type == INT_VAR )
+    {
+        Code[ i ].op = OP_PUSH_INT;
+        Code[ i ].arg.lval = v->INT;
+    }
+    else
+    {
+        Code[ i ].op = OP_PUSH_FLOAT;
+        Code[ i ].arg.dval = v->FLOAT;
+    }
+
+    vars_pop( v );
+}
+
+
+/*---------------------------------------------------------------------*
+ * If the last two instructions push constants the binary operation is
+ * done immediately and both get replaced by an instruction pushing the
+ * result. Returns false if that's not possible. Divisions by zero are
+ * left for the run time to complain about.
+ *---------------------------------------------------------------------*/
+
+static bool
+fold_binary( int  op,
+             int  sub,
+             long n )
+{
+    long i = Code_len - 2;
+
+    if ( ! is_const( i ) || ! is_const( i + 1 ) )
+        return false;
+
+    if ( op == OP_DIV )
+    {
+        if ( ! const_is_true( i + 1 ) )
+            return false;
+        if (    Code[ i ].op == OP_PUSH_INT
+             && Code[ i + 1 ].op == OP_PUSH_INT
+             && Code[ i ].arg.lval == LONG_MIN
+             && Code[ i + 1 ].arg.lval == -1 )
+            return false;
+    }
+
+    Var_T * v1 = const_to_var( i );
+    Var_T * v2 = const_to_var( i + 1 );
+    Var_T * res;
+
+    switch ( op )
+    {
+        case OP_ADD :
+            res = vars_add( v1, v2 );
+            break;
+
+        case OP_SUB :
+            res = vars_sub( v1, v2 );
+            break;
+
+        case OP_MULT :
+            res = vars_mult( v1, v2 );
+            break;
+
+        case OP_DIV :
+            res = vars_div( v1, v2 );
+            break;
+
+        case OP_COMP :
+            res = n ? vars_comp( sub, v2, v1 ) : vars_comp( sub, v1, v2 );
+            break;
+
+        default :
+            vars_pop( v2 );
+            vars_pop( v1 );
+            return false;
+    }
+
+    var_to_const( i, res );
+    Code_len--;
+    Stack_depth--;
+    return true;
+}
+
+
+/*-------------------------------------------------------------*
+ * Applies a unary minus or logical negation directly to the
+ * constant pushed by the last instruction if there's one.
+ *-------------------------------------------------------------*/
+
+static bool
+fold_unary( int op )
+{
+    long i = Code_len - 1;
+
+    if ( ! is_const( i ) )
+        return false;
+
+    Var_T * v = const_to_var( i );
+
+    var_to_const( i, op == OP_NEG ? vars_negate( v ) : vars_lnegate( v ) );
+    return true;
+}
+
+
+/*---------------------------------------------------------------------*
+ * Sets the target of the jump instruction with index 'i' to the next
+ * instruction to be emitted. Since the code jumped to can be reached
+ * in more than one way it's not allowed to merge it with the code
+ * before it.
+ *---------------------------------------------------------------------*/
+
+static void
+set_jump_target( long i )
+{
+    Code[ i ].arg.target = Fold_start = Code_len;
+}
+
+
+/*----------------------------------------------------------------*
+ * Prints out the compiled code, one instruction per line, for
+ * checking what the compiler made out of the EXPERIMENT section.
+ *----------------------------------------------------------------*/
+
+static void
+dump_code( void )
+{
+    static const char * names[ ] = { "STMT", "END", "JUMP", "SKIP", "IF",
+                                     "WHILE", "UNTIL", "REPEAT_ENTER",
+                                     "REPEAT_SET", "REPEAT_TEST",
+                                     "FOR_ENTER", "FOR_START", "FOR_END",
+                                     "FOR_INCR", "FOR_TEST", "FOREVER",
+                                     "BREAK", "PUSH_INT", "PUSH_FLOAT",
+                                     "PUSH_STR", "CAT_STR", "PUSH_VAR",
+                                     "PUSH_TOKEN_VAR", "LHS_VAR", "ARR_START",
+                                     "NO_INDEX", "RANGE", "ARR_RHS",
+                                     "ARR_LHS", "CALL", "CALL_STMT", "P_GET",
+                                     "P_SET", "P_SET_OP", "ASSIGN",
+                                     "ASSIGN_OP", "ADD", "SUB", "MULT", "DIV",
+                                     "MOD", "POW", "COMP", "NEG", "LNEG",
+                                     "AND", "OR", "TERN" };
+    static const char * comps[ ] = { "==", "!=", "<", "<=", "AND", "OR",
+                                     "XOR" };
+
+    if ( Code == NULL )
+    {
+        printf( "EXPERIMENT section isn't compiled, it will be "
+                "interpreted.\n" );
+        return;
+    }
+
+    for ( Exp_Instr_T * ip = Code; ip < Code + Code_len; ip++ )
+    {
+        printf( "%6ld  %s:%-5ld %-15s", ( long ) ( ip - Code ),
+                ip->tok->Fname, ip->tok->Lc, names[ ip->op ] );
+
+        switch ( ip->op )
+        {
+            case OP_JUMP :
+            case OP_SKIP :
+            case OP_IF :
+            case OP_WHILE :
+            case OP_UNTIL :
+            case OP_REPEAT_ENTER :
+            case OP_REPEAT_TEST :
+            case OP_FOR_ENTER :
+            case OP_FOR_TEST :
+            case OP_FOREVER :
+            case OP_BREAK :
+            case OP_AND :
+            case OP_OR :
+            case OP_TERN :
+                printf( " -> %ld", ip->arg.target );
+                break;
+
+            case OP_PUSH_INT :
+                printf( " %ld", ip->arg.lval );
+                break;
+
+            case OP_PUSH_FLOAT :
+                printf( " %#.9g", ip->arg.dval );
+                break;
+
+            case OP_PUSH_STR :
+            case OP_CAT_STR :
+                printf( " \"%s\"", ip->arg.sptr );
+                break;
+
+            case OP_PUSH_VAR :
+            case OP_LHS_VAR :
+            case OP_ARR_START :
+                printf( " %s", ip->arg.vptr->name );
+                break;
+
+            case OP_PUSH_TOKEN_VAR :
+                if ( ip->tok->token == E_FUNC_TOKEN )
+                    printf( " %s()", ip->tok->tv.vptr->name );
+                break;
+
+            case OP_ARR_RHS :
+            case OP_ARR_LHS :
+                printf( " (%ld)", ip->n );
+                break;
+
+            case OP_CALL :
+            case OP_CALL_STMT :
+                printf( " (%ld)%s", ip->n, ip->sub ? "" : " unchecked" );
+                break;
+
+            case OP_COMP :
+                printf( " %s%s", comps[ ip->sub ],
+                        ip->n ? " (swapped)" : "" );
+                break;
+        }
+
+        printf( "\n" );
+    }
+
+    fflush( stdout );
+}
+
+
+/*---------------------------------------------------------------*
+ * Executes one of the arithmetic operations of a compound
+ * assignment
+ *---------------------------------------------------------------*/
+
+static Var_T *
+arith( int     op,
+       Var_T * v1,
+       Var_T * v2 )
+{
+    switch ( op )
+    {
+        case OP_ADD :
+            return vars_add( v1, v2 );
+
+        case OP_SUB :
+            return vars_sub( v1, v2 );
+
+        case OP_MULT :
+            return vars_mult( v1, v2 );
+
+        case OP_DIV :
+            return vars_div( v1, v2 );
+
+        case OP_MOD :
+            return vars_mod( v1, v2 );
+
+        case OP_POW :
+            return vars_pow( v1, v2 );
+    }
+
+    fsc2_impossible( );
+    return NULL;
+}
+
+
+/*
+ * Local variables:
+ * tags-file-name: "../TAGS"
+ * tab-width: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,64 @@
+/*
+ *  Copyright (C) 1999-2014 Jens Thoms Toerring
+ *
+ *  This file is part of fsc2.
+ *
+ *  Fsc2 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3, or (at your option)
+ *  any later version.
+ *
+ *  Fsc2 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+#if ! defined EXP_CODE_HEADER
+#define EXP_CODE_HEADER
+
+
+#include "fsc2.h"
+
+
+typedef struct Exp_Instr Exp_Instr_T;
+
+struct Exp_Instr {
+    int           op;         /* instruction code */
+    int           sub;        /* operator, comparison or pulse property */
+    long          n;          /* argument or index count, pulse number */
+    Prg_Token_T * tok;        /* program token the instruction stems from */
+    union {
+        long     lval;
+        double   dval;
+        char   * sptr;
+        Var_T  * vptr;
+        long     target;      /* index of instruction to jump to */
+    } arg;
+};
+
+
+void compile_exp( void );
+
+void forget_compiled_exp( void );
+
+bool exp_is_compiled( void );
+
+void run_compiled_exp( bool /* in_test */ );
+
+
+#endif   /* ! EXP_CODE_HEADER */
+
+
+/*
+ * Local variables:
+ * tags-file-name: "../TAGS"
+ * tab-width: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -34,6 +34,7 @@ void exp_runparser_init( void );
 /* locally used functions */
 
 static void exp_runerror( const char * s );
+static void profile_next_stmt( void );
 
 
 /* locally used variables */
@@ -119,8 +120,12 @@ input:   /* empty */
 
 eol:     ';'                       { fsc2_assert( EDL.Var_Stack == NULL );
                                      fsc2_assert( Dont_exec == 0 );
-                                     if ( EDL.do_quit )
-                                         YYACCEPT; }
+                                     if (    EDL.do_quit
+                                          || (    CHECKPOINTING
+                                               && checkpoint_due( ) ) )
+                                         YYACCEPT;
+                                     if ( PROFILING )
+                                         profile_next_stmt( ); }
        | '}'                       { fsc2_assert( EDL.Var_Stack == NULL );
                                      fsc2_assert( Dont_exec == 0 );
                                      YYACCEPT; }
@@ -345,6 +350,43 @@ exp_runerror( const char * s  UNUSED_ARG )
 }
 
 
+/*----------------------------------------------------------------*
+ * Called at the end of each statement when profiling to record
+ * the start of the next one, so each statement gets charged with
+ * its own time. Not done for the tokens that make the parser hand
+ * back control to do_measurement() (see exp_runlex()), there the
+ * next statement gets recorded anyway.
+ *----------------------------------------------------------------*/
+
+static void
+profile_next_stmt( void )
+{
+    Prg_Token_T *next = EDL.cur_prg_token;
+
+
+    if ( next == NULL || next >= EDL.prg_token + EDL.prg_length )
+        return;
+
+    switch ( next->token )
+    {
+        case WHILE_TOK :
+        case REPEAT_TOK :
+        case BREAK_TOK :
+        case NEXT_TOK :
+        case FOR_TOK :
+        case FOREVER_TOK :
+        case UNTIL_TOK :
+        case IF_TOK :
+        case UNLESS_TOK :
+        case ELSE_TOK :
+        case '}' :
+            return;
+    }
+
+    profile_stmt( next );
+}
+
+
 /*----------------------------------------------------*
  *----------------------------------------------------*/
 
@@ -293,6 +293,7 @@ globals_init( const char * pname )
     Fsc2_Internals.state = STATE_IDLE;
     Fsc2_Internals.mode = PREPARATION;
     Fsc2_Internals.cmdline_flags = 0;
+    Fsc2_Internals.checkpoint_interval = 0;
     Fsc2_Internals.in_hook = false;
     Fsc2_Internals.I_am = PARENT;
     Fsc2_Internals.exit_hooks_are_run = false;
@@ -343,10 +344,14 @@ globals_init( const char * pname )
     EDL.File_List[ 0 ].fp = stdout;
     setbuf( stdout, NULL );
     EDL.File_List[ 0 ].name = ( char * ) "stdout";
+    EDL.File_List[ 0 ].gzip = EDL.File_List[ 0 ].binary = false;
+    EDL.File_List[ 0 ].wq = NULL;
 
     EDL.File_List[ 1 ].fp = stderr;
     setbuf( stderr, NULL );
     EDL.File_List[ 1 ].name = ( char * ) "stderr";
+    EDL.File_List[ 1 ].gzip = EDL.File_List[ 1 ].binary = false;
+    EDL.File_List[ 1 ].wq = NULL;
 
     /* The list of used devices is still empty */
 
@@ -360,6 +365,8 @@ globals_init( const char * pname )
     Comm.mq_semaphore = -1;
     Comm.MQ = NULL;
     Comm.MQ_ID = -1;
+    Comm.data_ring = NULL;
+    Comm.data_ring_ID = -1;
 
     GUI.is_init = false;
 
@@ -819,6 +826,101 @@ scan_args( int   * argc,
             continue;
         }
 
+        /* Check for '-noBytecode' flag that tells us not to compile the
+           EXPERIMENT section but to always run it via the parsers (also set
+           it immediately in the internal flags so that it's already in effect
+           for a following '-t' option) */
+
+        if ( ! strcmp( argv[ cur_arg ], "-noBytecode" ) )
+        {
+            flags |= NO_BYTECODE;
+            Fsc2_Internals.cmdline_flags |= NO_BYTECODE;
+            for ( int i = cur_arg; i < *argc; i++ )
+                argv[ i ] = argv[ i + 1 ];
+            *argc -= 1;
+            continue;
+        }
+
+        /* Check for '-profile' flag that asks for the times spent in the
+           lines of the EXPERIMENT section and in functions to be measured */
+
+        if ( ! strcmp( argv[ cur_arg ], "-profile" ) )
+        {
+            flags |= DO_PROFILE;
+            Fsc2_Internals.cmdline_flags |= DO_PROFILE;
+            for ( int i = cur_arg; i < *argc; i++ )
+                argv[ i ] = argv[ i + 1 ];
+            *argc -= 1;
+            continue;
+        }
+
+        /* Check for '-forceTest' flag that tells us to always do the test
+           run, even if the program already passed it before */
+
+        if ( ! strcmp( argv[ cur_arg ], "-forceTest" ) )
+        {
+            flags |= FORCE_TEST;
+            Fsc2_Internals.cmdline_flags |= FORCE_TEST;
+            for ( int i = cur_arg; i < *argc; i++ )
+                argv[ i ] = argv[ i + 1 ];
+            *argc -= 1;
+            continue;
+        }
+
+        /* Check for '-checkpoint' flag that asks for the state of the
+           experiment to be saved periodically, the next argument is the
+           number of minutes between checkpoints */
+
+        if ( ! strcmp( argv[ cur_arg ], "-checkpoint" ) )
+        {
+            char * end = NULL;
+            long minutes = 0;
+
+            if ( *argc > cur_arg + 1 )
+                minutes = strtol( argv[ cur_arg + 1 ], &end, 10 );
+
+            if (    minutes <= 0
+                 || minutes > LONG_MAX / 60
+                 || *end != '\0' )
+            {
+                fprintf( stderr, "fsc2: Flag '-checkpoint' needs a positive "
+                         "number of minutes as its argument.\n" );
+                usage( EXIT_FAILURE );
+            }
+
+            Fsc2_Internals.checkpoint_interval = 60 * minutes;
+            for ( int i = cur_arg; i < *argc - 1; i++ )
+                argv[ i ] = argv[ i + 2 ];
+            *argc -= 2;
+            continue;
+        }
+
+        /* Check for '-resume' flag that tells us to continue the experiment
+           from the last checkpoint */
+
+        if ( ! strcmp( argv[ cur_arg ], "-resume" ) )
+        {
+            flags |= DO_RESUME;
+            Fsc2_Internals.cmdline_flags |= DO_RESUME;
+            for ( int i = cur_arg; i < *argc; i++ )
+                argv[ i ] = argv[ i + 1 ];
+            *argc -= 1;
+            continue;
+        }
+
+        /* Check for '-dumpBytecode' flag that asks for the code the
+           EXPERIMENT section got compiled to be printed out */
+
+        if ( ! strcmp( argv[ cur_arg ], "-dumpBytecode" ) )
+        {
+            flags |= DUMP_BYTECODE;
+            Fsc2_Internals.cmdline_flags |= DUMP_BYTECODE;
+            for ( int i = cur_arg; i < *argc; i++ )
+                argv[ i ] = argv[ i + 1 ];
+            *argc -= 1;
+            continue;
+        }
+
         /* Check for '-S' flag that tells us the user wants the EDL script
            (which name has to be the next argument) to be tested and run
            immediately without any further interaction */
@@ -2046,6 +2148,7 @@ clean_up( void )
     /* Delete function list */
 
     functions_exit( );
+    test_cache_forget( );
 
     /* Delete device list */
 
@@ -2205,6 +2308,19 @@ usage( int return_status )
              "  -I FILE    start with main window iconified\n"
              "  -ng FILE   run experiment without any graphics\n"
              "  --delete   delete input file when fsc2 is done with it\n"
+             "  -noBytecode\n"
+             "             don't compile the EXPERIMENT section, interpret "
+             "it instead\n"
+             "  -dumpBytecode\n"
+             "             print the code the EXPERIMENT section got "
+             "compiled to\n"
+             "  -profile   print where the experiment spent its time\n"
+             "  -forceTest always do the test run, even for an unchanged "
+             "script\n"
+             "  -checkpoint minutes\n"
+             "             save the state of the experiment every few "
+             "minutes\n"
+             "  -resume    continue experiment from the last checkpoint\n"
              "  -stopMouseButton Number/Word\n"
              "             mouse button to be used to stop an experiment\n"
              "             1 = \"left\", 2 = \"middle\", 3 = \"right\" "
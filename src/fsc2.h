@@ -98,11 +98,16 @@
 #include "devices.h"              /* load before "loader.h"  */
 #include "func_basic.h"
 #include "func_util.h"
+#include "write_queue.h"
 #include "func_save.h"
 #include "loader.h"
 #include "phases.h"
 #include "pulser.h"
 #include "exp.h"
+#include "exp_code.h"
+#include "profile.h"
+#include "checkpoint.h"
+#include "test_cache.h"
 #include "run.h"
 #include "chld_func.h"
 #include "graphics.h"
@@ -188,6 +193,9 @@ struct Internals {
     int cmdline_flags;           /* stores command line options */
 
     long num_test_runs;          /* number of test runs with '-X' flag */
+    long checkpoint_interval;    /* seconds between checkpoints (set with
+                                    '-checkpoint' flag), 0 if there are
+                                    none */
     long check_return;           /* result of check run, 1 is ok */
 
     int I_am;                    /* indicates if we're running the parent
@@ -285,6 +293,11 @@ struct Communication {
                                     child to the parent process */
     int MQ_ID;                   /* shared memory segment ID of the message
                                     queue */
+
+    char *data_ring;             /* ring buffer for data send from the child
+                                    to the parent process */
+    int data_ring_ID;            /* shared memory segment ID of the ring
+                                    buffer */
 };
 
 
@@ -161,8 +161,10 @@ static Func_T Def_fncts[ ] =                  /* List of built-in functions */
     { "spike_remove",        f_spike_rem,       -3, ACCESS_EXP,  NULL, false },
     { "get_file",            f_getf,            -5, ACCESS_EXP,  NULL, false },
     { "get_gzip_file",       f_getgzf,          -5, ACCESS_EXP,  NULL, false },
+    { "get_binary_file",     f_getbf,           -5, ACCESS_EXP,  NULL, false },
     { "open_file",           f_openf,           -6, ACCESS_EXP,  NULL, false },
     { "open_gzip_file",      f_opengzf,         -6, ACCESS_EXP,  NULL, false },
+    { "open_binary_file",    f_openbf,          -6, ACCESS_EXP,  NULL, false },
     { "clone_file",          f_clonef,           3, ACCESS_EXP,  NULL, false },
     { "clone_gzip_file",     f_clonegzf,         3, ACCESS_EXP,  NULL, false },
     { "reset_file",          f_resetf,          -1, ACCESS_EXP,  NULL, false },
@@ -232,6 +234,9 @@ static int func_cmp1( const void * a,
                       const void * b );
 static int func_cmp2( const void * a,
                       const void * b );
+static Var_T * func_invoke( Var_T * volatile f );
+
+static Call_Stack_T * Free_Call_Frames = NULL;   /* unused call stack entries */
 
 
 /*--------------------------------------------------------------------*
@@ -315,6 +320,14 @@ functions_exit( void )
     while ( call_pop( ) )
         /* empty */ ;
 
+    while ( Free_Call_Frames != NULL )
+    {
+        Call_Stack_T * cs = Free_Call_Frames;
+
+        Free_Call_Frames = cs->next;
+        T_free( cs );
+    }
+
     No_File_Numbers = false;
     Dont_Save = false;
     close_all_files( );
@@ -581,8 +594,64 @@ func_call( Var_T * volatile f )
         }
     }
 
-    /* Now call the function after storing some information about the
-       function on the call stack */
+    return func_invoke( f );
+}
+
+
+/*--------------------------------------------------------------------*
+ * Executes an EDL function for which func_args_ok() already returned
+ * true for the number of arguments on the stack, i.e. without checking
+ * the function variable and counting the arguments again.
+ *--------------------------------------------------------------------*/
+
+Var_T *
+func_call_bound( Var_T * volatile f )
+{
+    return func_invoke( f );
+}
+
+
+/*-----------------------------------------------------------------*
+ * Returns if a function variable refers to a known function and
+ * if the function accepts 'ac' arguments, so that calls of it with
+ * this number of arguments can be done via func_call_bound().
+ *-----------------------------------------------------------------*/
+
+bool
+func_args_ok( Var_T * f,
+              long    ac )
+{
+    if ( f->type != FUNC )
+        return false;
+
+    size_t i;
+    for ( i = 0; i < Num_Func; i++ )
+        if ( Fncts[ i ].fnct == f->val.fnct->fnct )
+            break;
+
+    if ( i >= Num_Func )
+        return false;
+
+    if ( f->dim == INT_MIN )
+        return true;
+
+    return f->dim >= 0 ? ac == f->dim : ac <= - f->dim;
+}
+
+
+/*-------------------------------------------------------------------*
+ * Does the actual call of an EDL function after the checks have been
+ * done, with some information about the function stored on the call
+ * stack during the call. Afterwards the function variable and all
+ * remaining arguments are removed from the variable stack, only the
+ * return value is kept.
+ *-------------------------------------------------------------------*/
+
+static Var_T *
+func_invoke( Var_T * volatile f )
+{
+    Var_T *ap;
+    Profile_Mark_T mark;
 
     if ( call_push( f->val.fnct, NULL,
                     f->val.fnct->device ? f->val.fnct->device->name : NULL,
@@ -590,6 +659,9 @@ func_call( Var_T * volatile f )
          == NULL )
         THROW( OUT_OF_MEMORY_EXCEPTION );
 
+    if ( PROFILING )
+        profile_func_start( f->val.fnct, &mark );
+
     Var_T *ret = NULL;
     TRY
     {
@@ -598,6 +670,9 @@ func_call( Var_T * volatile f )
     }
     OTHERWISE
     {
+        if ( PROFILING )
+            profile_func_end( f->val.fnct, &mark );
+
 #ifndef NDEBUG
         if ( ! vars_exist( f ) )
         {
@@ -639,6 +714,9 @@ func_call( Var_T * volatile f )
     }
 #endif
 
+    if ( PROFILING )
+        profile_func_end( f->val.fnct, &mark );
+
     call_pop( );
 
     /* Finally do the clean up, i.e. remove the variable with the function
@@ -692,8 +770,18 @@ call_push( Func_T     * f,
            int          dev_count )
 {
     const char * t;
+    Call_Stack_T * cs;
+
+    /* Entries get recycled instead of being allocated for each call */
+
+    if ( Free_Call_Frames != NULL )
+    {
+        cs = Free_Call_Frames;
+        Free_Call_Frames = cs->next;
+    }
+    else
+        cs = T_malloc( sizeof *cs );
 
-    Call_Stack_T * cs = T_malloc( sizeof *cs );
     cs->next = EDL.Call_Stack;
     cs->f = f;
 
@@ -751,7 +839,8 @@ call_pop( void )
 
     Cur_Pulser = cs->Cur_Pulser;
 
-    T_free( cs );
+    cs->next = Free_Call_Frames;
+    Free_Call_Frames = cs;
 
     return EDL.Call_Stack;
 }
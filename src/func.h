@@ -95,6 +95,11 @@ Var_T *func_get_long( const char * /* name */,
 
 Var_T *func_call( Var_T * volatile /* f */ );
 
+Var_T *func_call_bound( Var_T * volatile /* f */ );
+
+bool func_args_ok( Var_T * /* f  */,
+                   long    /* ac */  );
+
 void close_all_files( void );
 
 Call_Stack_T *call_push( Func_T     * /* f           */,
@@ -19,6 +19,39 @@
 
 
 #include "fsc2.h"
+#include <stdint.h>
+
+
+/* Binary files start with a magic string and the format version (plus a
+   reserved field), followed by records, each with the type of the data
+   (integer, float or text), the number of dimensions, the sizes of the
+   dimensions and the data themselves (padded to a multiple of 8 bytes).
+   All numbers are in little-endian byte order, integers as 64-bit values
+   and floats as IEEE 754 doubles. The reader in 'utils/fsc2_bin.c' must
+   be kept in sync with this. */
+
+#define BIN_MAGIC        "FSC2BIN\n"
+#define BIN_VERSION      1
+#define BIN_HEADER_SIZE  16
+
+#define BIN_INT          1
+#define BIN_FLOAT        2
+#define BIN_TEXT         3
+
+#define BIN_CHUNK        512   /* values converted at once if necessary */
+
+
+/* Buffer for formatting arrays when writing them as text */
+
+#define SAVE_BUF_SIZE    65536
+#define SAVE_NUM_SIZE    32    /* more than a formatted number plus '\n' */
+
+typedef struct {
+    long   file_num;
+    char * buf;
+    size_t len;            /* number of chars in the buffer */
+    long   count;          /* number of chars written out */
+} Save_Buf_T;
 
 
 /* Both variables are defined in 'func.c' */
@@ -43,10 +76,30 @@ static int get_save_file( Var_T ** /* v */ );
 static Var_T * batch_mode_file_open( char * /* name */,
                                      bool   /* do_compress */ );
 
+static Var_T * open_binary( Var_T * /* nv      */,
+                            int     /* old_len */ );
+
 static long arr_save( const char * sep,
                       long         file_num,
                       Var_T      * v );
 
+static void arr_save_buf( const char * sep,
+                          size_t       sep_len,
+                          Save_Buf_T * sb,
+                          Var_T      * v );
+
+static void save_buf_add( Save_Buf_T * sb,
+                          const char * str,
+                          size_t       len );
+
+static void save_buf_flush( Save_Buf_T * sb );
+
+static char * format_long( char * p,
+                           long   v );
+
+static char * format_double( char * p,
+                             double v );
+
 static void f_format_check( Var_T * v );
 
 static void ff_format_check( Var_T * v );
@@ -63,10 +116,55 @@ static long print_include( int          fid,
                            const char * volatile comment,
                            const char * cur_file );
 
+static bool write_error( File_List_T * /* fl */ );
+
+static void flush_file( File_List_T * /* fl */ );
+
+static void close_file( File_List_T * /* fl */ );
+
 static long T_fprintf( long         fn,
                        const char * fmt,
                        ... );
 
+static long T_fwrite( long         fn,
+                      const void * buf,
+                      size_t       len );
+
+static long bin_arr_save( long    file_num,
+                          Var_T * v );
+
+static bool bin_get_dims( Var_T   * v,
+                          ssize_t * dims );
+
+static bool bin_dims_match( Var_T         * v,
+                            const ssize_t * dims,
+                            int             type );
+
+static long bin_write_arr_values( long    file_num,
+                                  Var_T * v );
+
+static long bin_write_header( long file_num );
+
+static long bin_write_record_header( long            file_num,
+                                     int             type,
+                                     int             ndims,
+                                     const ssize_t * dims );
+
+static long bin_write_values( long         file_num,
+                              int          type,
+                              const void * data,
+                              size_t       count );
+
+static long bin_write_text( long         file_num,
+                            const char * text,
+                            size_t       len );
+
+static void bin_put32( unsigned char * p,
+                       uint32_t        v );
+
+static void bin_put64( unsigned char * p,
+                       uint64_t        v );
+
 static const char * get_name( Var_T * v );
 
 
@@ -215,6 +313,20 @@ f_opengzf( Var_T * v )
 }
 
 
+/*-----------------------------------------------------------------*
+ * Like f_openf(), but the data get written to the file in binary
+ * format (see the description at the start of this file).
+ *-----------------------------------------------------------------*/
+
+Var_T *
+f_openbf( Var_T * v )
+{
+    int old_len = EDL.File_List_Len;
+
+    return open_binary( f_openf_int( v, false ), old_len );
+}
+
+
 static
 Var_T *
 f_openf_int( Var_T         * v,
@@ -330,7 +442,7 @@ f_openf_int( Var_T         * v,
     }
 
     if (    ( ! do_compress && ! ( fp = fopen( fn, "w"    ) ) )
-         || (   do_compress && ! ( gp = gzopen( fn, "wb9" ) ) ) )
+         || (   do_compress && ! ( gp = gzopen( fn, "wT" ) ) ) )
     {
         switch ( errno )
         {
@@ -432,6 +544,8 @@ f_openf_int( Var_T         * v,
         EDL.File_List[ EDL.File_List_Len ].gzip = do_compress;
     }
 
+    EDL.File_List[ EDL.File_List_Len ].binary = false;
+    EDL.File_List[ EDL.File_List_Len ].wq = NULL;
     EDL.File_List[ EDL.File_List_Len ].name = NULL;
     EDL.File_List[ EDL.File_List_Len ].name = T_strdup( fn );
 
@@ -477,6 +591,20 @@ f_getgzf( Var_T * v )
 }
 
 
+/*-----------------------------------------------------------------*
+ * Like f_getf(), but the data get written to the file in binary
+ * format (see the description at the start of this file).
+ *-----------------------------------------------------------------*/
+
+Var_T *
+f_getbf( Var_T * v )
+{
+    int old_len = EDL.File_List_Len;
+
+    return open_binary( f_getf_int( v, false ), old_len );
+}
+
+
 static
 Var_T *
 f_getf_int( Var_T        * v,
@@ -648,7 +776,7 @@ f_getf_int( Var_T        * v,
     }
 
     if (    ( ! do_compress && ! ( fp = fopen( r, "w+"   ) ) )
-         || (   do_compress && ! ( gp = gzopen( r, "wb9" ) ) ) )
+         || (   do_compress && ! ( gp = gzopen( r, "wT" ) ) ) )
     {
         switch( errno )
         {
@@ -739,6 +867,8 @@ f_getf_int( Var_T        * v,
         EDL.File_List[ EDL.File_List_Len ].gzip = do_compress;
     }
 
+    EDL.File_List[ EDL.File_List_Len ].binary = false;
+    EDL.File_List[ EDL.File_List_Len ].wq = NULL;
     EDL.File_List[ EDL.File_List_Len ].name = r;
 
     /* Switch off buffering for normal files so we're sure everything gets
@@ -923,6 +1053,15 @@ f_resetf( Var_T * v )
 
     File_List_T * fl = EDL.File_List + file_num;
 
+    /* Everything still in the write-behind queue must be written out before
+       the file gets truncated */
+
+    flush_file( fl );
+
+    if (    ( ! fl->gzip && ! fl->fp )
+         || (   fl->gzip && ! fl->gp ) )
+        return vars_push( INT_VAR, file_num + FILE_NUMBER_OFFSET );
+
     if ( ! fl->gzip )
     {
         fflush( fl->fp );
@@ -940,15 +1079,23 @@ f_resetf( Var_T * v )
             print( FATAL, "Failed to reset file.\n" );
             THROW( EXCEPTION );
         }
+
+        if ( fl->binary )
+            bin_write_header( file_num + FILE_NUMBER_OFFSET );
     }
     else
     {
         gzclose( fl->gp );
-        if ( ! ( fl->gp = gzopen( fl->name, "wb9" ) ) )
+        if ( ! ( fl->gp = gzopen( fl->name, "wT" ) ) )
         {
+            write_queue_close( fl->wq );
+            fl->wq = NULL;
             print( FATAL, "Failed to reset file.\n" );
             THROW( EXCEPTION );
         }
+
+        if ( fl->wq )
+            write_queue_set_file( fl->wq, NULL, fl->gp );
     }
 
     return vars_push( INT_VAR, file_num + FILE_NUMBER_OFFSET );
@@ -1025,7 +1172,7 @@ batch_mode_file_open( char * name,
                  new_name, name );
 
     if (    ( ! do_compress && ! ( fp = fopen( new_name, "w+"   ) ) )
-         || (   do_compress && ! ( gp = gzopen( new_name, "wb9" ) ) ) )
+         || (   do_compress && ! ( gp = gzopen( new_name, "wT" ) ) ) )
     {
         switch( errno )
         {
@@ -1096,6 +1243,8 @@ batch_mode_file_open( char * name,
     EDL.File_List[ EDL.File_List_Len ].fp = fp;
     EDL.File_List[ EDL.File_List_Len ].gp = gp;
     EDL.File_List[ EDL.File_List_Len ].gzip = do_compress;
+    EDL.File_List[ EDL.File_List_Len ].binary = false;
+    EDL.File_List[ EDL.File_List_Len ].wq = NULL;
     EDL.File_List[ EDL.File_List_Len ].name = new_name;
 
     /* Switch buffering off so we're sure everything gets written to disk
@@ -1108,6 +1257,41 @@ batch_mode_file_open( char * name,
 }
 
 
+/*--------------------------------------------------------------------*
+ * Called with the return value of one of the functions for opening
+ * a file and the length of the file list before it was called. If a
+ * new file got opened it's switched to binary format and the header
+ * gets written. Files that were already open before and stdout and
+ * stderr are left alone.
+ *--------------------------------------------------------------------*/
+
+static
+Var_T *
+open_binary( Var_T * nv,
+             int     old_len )
+{
+    if (    Fsc2_Internals.mode == TEST
+         || Fsc2_Internals.cmdline_flags & DO_CHECK
+         || nv->val.lval == FILE_NUMBER_NOT_OPEN )
+        return nv;
+
+    if ( EDL.File_List_Len == old_len )
+    {
+        if (    nv->val.lval == STDOUT_FILENO
+             || nv->val.lval == STDERR_FILENO )
+            print( WARN, "Binary format can't be used for std%s, data will "
+                   "be written as text.\n",
+                   nv->val.lval == STDOUT_FILENO ? "out" : "err" );
+        return nv;
+    }
+
+    EDL.File_List[ EDL.File_List_Len - 1 ].binary = true;
+    bin_write_header( nv->val.lval );
+
+    return nv;
+}
+
+
 /*-------------------------------------------------------------------*
  * Closes and deletes an open file
  *-------------------------------------------------------------------*/
@@ -1164,19 +1348,11 @@ f_delf( Var_T * v )
     if ( Fsc2_Internals.mode == TEST )
         return vars_push( INT_VAR, 1L );
 
-    File_List_T * fl = EDL.File_List + file_num;
+    /* Data not written yet are of no interest anymore */
 
-    if ( ! fl->gzip && fl->fp )
-    {
-        fclose( fl->fp );
-        fl->fp = NULL;
-    }
-    else if ( fl->gzip && fl->gp )
-    {
-        gzclose( fl->gp );
-        fl->gp = NULL;
-    }
+    File_List_T * fl = EDL.File_List + file_num;
 
+    close_file( fl );
     unlink( fl->name );
 
     return vars_push( INT_VAR, 1L );
@@ -1306,23 +1482,161 @@ close_all_files( void )
     if ( EDL.File_List_Len == 2 )
         return;
 
+    /* When called from the signal handler for deadly signals files with a
+       write-behind queue are left alone: the writer thread may be using
+       them and we can't wait for it. Data still in their queues are lost
+       in this case. */
+
     for ( int i = 2; i < EDL.File_List_Len; i++ )
     {
-        if ( ! EDL.File_List[ i ].gzip && EDL.File_List[ i ].fp )
-            fclose( EDL.File_List[ i ].fp );
-        else if ( EDL.File_List[ i ].gzip && EDL.File_List[ i ].gp )
-            gzclose( EDL.File_List[ i ].gp );
+        File_List_T *fl = EDL.File_List + i;
+
+        if ( fl->wq && Crash.signo != 0 )
+            continue;
 
-        if ( EDL.File_List[ i ].name )
-            T_free( EDL.File_List[ i ].name );
+        flush_file( fl );
+        close_file( fl );
+
+        if ( fl->name )
+            T_free( fl->name );
     }
 
+    if ( Crash.signo == 0 )
+        write_queue_stop( );
+
     EDL.File_List = T_realloc( EDL.File_List, 2 * sizeof *EDL.File_List );
     EDL.File_List_Len = 2;
     STD_Is_Open = false;
 }
 
 
+/*-------------------------------------------------------------------*
+ * Writes out all data still waiting to be written to the files and
+ * returns an array with the state of the files (except stdout and
+ * stderr) for a checkpoint, 'num' is set to its length and 'flags'
+ * to the state of the list of files as a whole. The array must be
+ * freed by the caller, the file names in it are those of the file
+ * list. Files that were deleted in the mean time count as closed.
+ *-------------------------------------------------------------------*/
+
+File_State_T *
+get_file_states( int * num,
+                 int * flags )
+{
+    *num = EDL.File_List_Len - 2;
+    *flags =   ( STD_Is_Open     ? FILES_STD_IS_OPEN     : 0 )
+             | ( No_File_Numbers ? FILES_NO_FILE_NUMBERS : 0 )
+             | ( Dont_Save       ? FILES_DONT_SAVE       : 0 );
+
+    if ( *num == 0 )
+        return NULL;
+
+    File_State_T *fs = T_malloc( *num * sizeof *fs );
+
+    for ( int i = 0; i < *num; i++ )
+    {
+        File_List_T *fl = EDL.File_List + i + 2;
+        struct stat stat_buf;
+
+        flush_file( fl );
+
+        fs[ i ].name    = fl->name;
+        fs[ i ].is_open =    ( fl->fp || fl->gp )
+                          && stat( fl->name, &stat_buf ) != -1;
+        fs[ i ].gzip    = fl->gzip;
+        fs[ i ].binary  = fl->binary;
+        fs[ i ].offset  = fs[ i ].is_open ? stat_buf.st_size : 0;
+        fs[ i ].crc     = fs[ i ].size = 0;
+
+        if ( fs[ i ].is_open && fl->gzip && fl->wq )
+            write_queue_get_gzip_state( fl->wq, &fs[ i ].crc,
+                                        &fs[ i ].size );
+    }
+
+    return fs;
+}
+
+
+/*-------------------------------------------------------------------*
+ * Appends a file from a checkpoint to the file list when resuming
+ * an experiment. If it was open when the checkpoint was taken it
+ * gets reopened, with everything written to it after the checkpoint
+ * removed. For compressed files the gzip stream already in the file
+ * gets continued.
+ *-------------------------------------------------------------------*/
+
+void
+restore_file( const File_State_T * fs )
+{
+    EDL.File_List = T_realloc( EDL.File_List,
+                               ( EDL.File_List_Len + 1 )
+                               * sizeof *EDL.File_List );
+
+    File_List_T *fl = EDL.File_List + EDL.File_List_Len;
+
+    fl->fp     = NULL;
+    fl->gp     = NULL;
+    fl->wq     = NULL;
+    fl->gzip   = fs->gzip;
+    fl->binary = fs->binary;
+    fl->name   = NULL;
+    if ( fs->name )
+        fl->name = T_strdup( fs->name );
+    EDL.File_List_Len++;
+
+    if ( ! fs->is_open )
+        return;
+
+    struct stat stat_buf;
+
+    if ( stat( fl->name, &stat_buf ) == -1 )
+    {
+        if ( fs->offset != 0 )
+        {
+            print( FATAL, "File '%s' has been deleted since the checkpoint "
+                   "was taken.\n", fl->name );
+            THROW( EXCEPTION );
+        }
+    }
+    else if (    stat_buf.st_size < fs->offset
+              || truncate( fl->name, fs->offset ) == -1 )
+    {
+        print( FATAL, "Can't reset file '%s' to its length at the time the "
+               "checkpoint was taken.\n", fl->name );
+        THROW( EXCEPTION );
+    }
+
+    if (    ( ! fl->gzip && ! ( fl->fp = fopen( fl->name, "a"  ) ) )
+         || (   fl->gzip && ! ( fl->gp = gzopen( fl->name, "aT" ) ) ) )
+    {
+        print( FATAL, "Can't reopen file '%s'.\n", fl->name );
+        THROW( EXCEPTION );
+    }
+
+    if ( ! fl->gzip )
+        setbuf( fl->fp, NULL );
+    else if ( fs->offset > 0 )
+    {
+        fl->wq = write_queue_create( NULL, fl->gp );
+        write_queue_set_gzip_state( fl->wq, fs->crc, fs->size );
+    }
+}
+
+
+/*-------------------------------------------------------------------*
+ * Sets the state of the list of files as a whole when resuming an
+ * experiment from a checkpoint.
+ *-------------------------------------------------------------------*/
+
+void
+restore_file_flags( int flags )
+{
+    STD_Is_Open     = flags & FILES_STD_IS_OPEN;
+    No_File_Numbers = flags & FILES_NO_FILE_NUMBERS;
+    Dont_Save       = flags & FILES_DONT_SAVE;
+}
+
+
 /*----------------------------------------------------------------------*
  * Saves data to a file. If 'get_file()' hasn't been called yet it will
  * be called now - in this case the file opened this way is the only
@@ -1330,7 +1644,8 @@ close_all_files( void )
  * to 'save()'. This version of save writes the data in an unformatted
  * way, i.e. each on its own line with the only exception of arrays of
  * more than one dimension where an empty line is put between the
- * slices. It returns the number of characters written.
+ * slices. For binary files each value or array is written as a record.
+ * It returns the number of characters (or bytes) written.
  *----------------------------------------------------------------------*/
 
 Var_T *
@@ -1358,6 +1673,18 @@ f_save( Var_T * v )
         return vars_push( INT_VAR, 0L );
     }
 
+    /* For binary files (not known during the test run) the data get
+       written as records, the layout of the data is stored with them */
+
+    bool binary =    Fsc2_Internals.mode != TEST
+                  && EDL.File_List[ file_num - FILE_NUMBER_OFFSET ].binary;
+
+    if ( binary && sep )
+    {
+        print( WARN, "Separator has no effect with binary files\n" );
+        sep = T_free( sep );
+    }
+
     long count = 0;
 
     do
@@ -1368,13 +1695,25 @@ f_save( Var_T * v )
                 if ( sep )
                     print( WARN, "Separator has no effect with integers "
                            "data\n" );
-                count += T_fprintf( file_num, "%ld\n", v->val.lval );
+                if ( binary )
+                    count +=   bin_write_record_header( file_num, BIN_INT,
+                                                        0, NULL )
+                             + bin_write_values( file_num, BIN_INT,
+                                                 &v->val.lval, 1 );
+                else
+                    count += T_fprintf( file_num, "%ld\n", v->val.lval );
                 break;
 
             case FLOAT_VAR :
                 if ( sep )
                     print( WARN, "Separator has no effect with float data\n" );
-                count += T_fprintf( file_num, "%#.9g\n", v->val.dval );
+                if ( binary )
+                    count +=   bin_write_record_header( file_num, BIN_FLOAT,
+                                                        0, NULL )
+                             + bin_write_values( file_num, BIN_FLOAT,
+                                                 &v->val.dval, 1 );
+                else
+                    count += T_fprintf( file_num, "%#.9g\n", v->val.dval );
                 break;
 
             case STR_VAR :
@@ -1386,7 +1725,10 @@ f_save( Var_T * v )
 
 
             case INT_ARR : case FLOAT_ARR : case INT_REF : case FLOAT_REF :
-                count += arr_save( sep, file_num, v );
+                if ( binary )
+                    count += bin_arr_save( file_num, v );
+                else
+                    count += arr_save( sep, file_num, v );
                 break;
 
             default :
@@ -1405,7 +1747,10 @@ f_save( Var_T * v )
  * Function called when a one- or more-dimensional variable is passed to
  * the 'save()' EDL function. It writes out the array one element per line
  * unless a separator is specified, then a values are separated by this on
- * a line and the newline character only gets appended to the end.
+ * a line and the newline character only gets appended to the end. The
+ * numbers are formatted into a large buffer that gets written out only
+ * when full, which is a lot faster than writing out each number on its
+ * own for large arrays.
  *-------------------------------------------------------------------------*/
 
 static
@@ -1414,50 +1759,385 @@ arr_save( const char * sep,
           long         file_num,
           Var_T      * v )
 {
-    long count = 0;
-    ssize_t i;
+    static char buf[ SAVE_BUF_SIZE ];
+    Save_Buf_T sb = { file_num, buf, 0, 0 };
+
+
+    arr_save_buf( sep, sep ? strlen( sep ) : 0, &sb, v );
+    save_buf_flush( &sb );
 
+    return sb.count;
+}
+
+
+/*---------------------------------------------------------------*
+ * Does the real work for arr_save(), recursively calling itself
+ * for arrays of more than one dimension.
+ *---------------------------------------------------------------*/
+
+static
+void
+arr_save_buf( const char * sep,
+              size_t       sep_len,
+              Save_Buf_T * sb,
+              Var_T      * v )
+{
     switch ( v->type )
     {
-        case INT_ARR :
-            if ( sep )
+        case INT_ARR : case FLOAT_ARR :
+            for ( ssize_t i = 0; i < v->len; i++ )
             {
-                for ( i = 0; i < v->len - 1; i++ )
-                    count += T_fprintf( file_num, "%ld%s",
-                                       v->val.lpnt[ i ], sep );
-                count += T_fprintf( file_num, "%ld\n", v->val.lpnt[ i ] );
-            }
-            else
-                for ( i = 0; i < v->len; i++ )
-                    count += T_fprintf( file_num, "%ld\n", v->val.lpnt[ i ] );
-            break;
+                if ( sb->len > SAVE_BUF_SIZE - SAVE_NUM_SIZE )
+                    save_buf_flush( sb );
 
-        case FLOAT_ARR :
-            if ( sep )
-            {
-                for ( i = 0; i < v->len - 1; i++ )
-                    count += T_fprintf( file_num, "%#.9g%s",
-                                        v->val.dpnt[ i ], sep );
-                count += T_fprintf( file_num, "%#.9g\n", v->val.dpnt[ i ] );
+                char *p = sb->buf + sb->len;
+
+                if ( v->type == INT_ARR )
+                    p = format_long( p, v->val.lpnt[ i ] );
+                else
+                    p = format_double( p, v->val.dpnt[ i ] );
+
+                if ( sep && i < v->len - 1 )
+                {
+                    sb->len = p - sb->buf;
+                    save_buf_add( sb, sep, sep_len );
+                }
+                else
+                {
+                    *p++ = '\n';
+                    sb->len = p - sb->buf;
+                }
             }
-            else
-                for ( i = 0; i < v->len; i++ )
-                    count += T_fprintf( file_num, "%#.9g\n", v->val.dpnt[ i ] );
             break;
 
         case INT_REF : case FLOAT_REF :
-            for ( i = 0; i < v->len; i++ )
+            for ( ssize_t i = 0; i < v->len; i++ )
             {
                 if ( v->val.vptr[ i ] )
-                    count += arr_save( sep, file_num, v->val.vptr[ i ] );
+                    arr_save_buf( sep, sep_len, sb, v->val.vptr[ i ] );
                 if ( i != v->len - 1 && ! sep )
-                    count += T_fprintf( file_num, "\n" );
+                    save_buf_add( sb, "\n", 1 );
             }
             break;
 
         default :
             break;
     }
+}
+
+
+/*------------------------------------------------------------*
+ * Appends a string to the buffer used by arr_save(), writing
+ * out what's already in the buffer if necessary.
+ *------------------------------------------------------------*/
+
+static
+void
+save_buf_add( Save_Buf_T * sb,
+              const char * str,
+              size_t       len )
+{
+    if ( sb->len + len > SAVE_BUF_SIZE )
+        save_buf_flush( sb );
+
+    if ( len <= SAVE_BUF_SIZE )
+    {
+        memcpy( sb->buf + sb->len, str, len );
+        sb->len += len;
+    }
+    else if ( Fsc2_Internals.mode == TEST )
+        sb->count += len;
+    else
+        sb->count += T_fwrite( sb->file_num, str, len );
+}
+
+
+/*-------------------------------------------------------*
+ * Writes out what's in the buffer used by arr_save()
+ * (during the test run only the characters get counted)
+ *-------------------------------------------------------*/
+
+static
+void
+save_buf_flush( Save_Buf_T * sb )
+{
+    if ( sb->len == 0 )
+        return;
+
+    if ( Fsc2_Internals.mode == TEST )
+        sb->count += sb->len;
+    else
+        sb->count += T_fwrite( sb->file_num, sb->buf, sb->len );
+
+    sb->len = 0;
+}
+
+
+/*----------------------------------------------------------------*
+ * Writes an integer in decimal to 'p' (exactly as printf()'s "%ld"
+ * would do) and returns a pointer to the end of what was written.
+ *----------------------------------------------------------------*/
+
+static
+char *
+format_long( char * p,
+             long   v )
+{
+    char digits[ 3 * sizeof v ];
+    int n = 0;
+    unsigned long u = v < 0 ? - ( unsigned long ) v : ( unsigned long ) v;
+
+
+    do
+        digits[ n++ ] = '0' + u % 10;
+    while ( ( u /= 10 ) != 0 );
+
+    if ( v < 0 )
+        *p++ = '-';
+
+    while ( n > 0 )
+        *p++ = digits[ --n ];
+
+    return p;
+}
+
+
+/*---------------------------------------------------------------------*
+ * Writes a floating point number to 'p' in exactly the same way as
+ * printf()'s "%#.9g" would do and returns a pointer to the end of
+ * what was written. The value is scaled by a power of ten (which is
+ * exact for the powers used) to get its 9 significant digits as an
+ * integer, so there's only a single rounding error, which is much
+ * smaller than 1.0e-6. Thus, unless the value is (nearly) halfway
+ * between two integers, rounding it gives the same result as the
+ * exact conversion by printf(). For the few numbers where this isn't
+ * guaranteed (and for very small or large numbers, numbers that get
+ * rounded up to the next power of ten, infinities, NaNs and zero)
+ * sprintf() is used.
+ *---------------------------------------------------------------------*/
+
+static
+char *
+format_double( char * p,
+               double v )
+{
+    static const double pow10[ ] = { 1.0e0,  1.0e1,  1.0e2,  1.0e3,  1.0e4,
+                                     1.0e5,  1.0e6,  1.0e7,  1.0e8,  1.0e9,
+                                     1.0e10, 1.0e11, 1.0e12, 1.0e13, 1.0e14,
+                                     1.0e15, 1.0e16, 1.0e17, 1.0e18, 1.0e19,
+                                     1.0e20, 1.0e21, 1.0e22 };
+    int max_pow = sizeof pow10 / sizeof *pow10 - 1;
+    double a = fabs( v );
+    double s = 0.0;
+    unsigned long m = 0;
+    char digits[ 9 ];
+    int x;
+
+
+    if ( ! isfinite( v ) || a == 0.0 )
+        return p + sprintf( p, "%#.9g", v );
+
+    /* Get an estimate of the decimal exponent from the binary exponent,
+       then scale the value to get 9 digits in front of the decimal point
+       and correct the estimate if it wasn't right. */
+
+    frexp( a, &x );
+    x = floor( ( x - 1 ) * 0.30102999566398120 );
+
+    for ( int tries = 0; ; tries++ )
+    {
+        if ( tries == 3 || x < 8 - max_pow || x > 8 + max_pow )
+            return p + sprintf( p, "%#.9g", v );
+
+        s = x <= 8 ? a * pow10[ 8 - x ] : a / pow10[ x - 8 ];
+
+        double f = floor( s );
+
+        if ( fabs( s - f - 0.5 ) < 1.0e-6 )
+            return p + sprintf( p, "%#.9g", v );
+
+        m = f + ( s - f > 0.5 );
+
+        if ( m < 100000000 )
+            x--;
+        else if ( m >= 1000000000 )
+            x++;
+        else
+            break;
+    }
+
+    if ( m == 100000000 && s < 1.0e8 )
+        return p + sprintf( p, "%#.9g", v );
+
+    for ( int i = 8; i >= 0; m /= 10, i-- )
+        digits[ i ] = '0' + m % 10;
+
+    if ( v < 0.0 )
+        *p++ = '-';
+
+    /* Like printf() use fixed point notation for exponents between -4 and
+       8 and exponential notation otherwise (the '#' flag requires that the
+       decimal point and trailing zeros are always printed) */
+
+    if ( x >= 0 && x < 9 )
+    {
+        memcpy( p, digits, x + 1 );
+        p += x + 1;
+        *p++ = '.';
+        memcpy( p, digits + x + 1, 8 - x );
+        return p + 8 - x;
+    }
+
+    if ( x < 0 && x >= -4 )
+    {
+        *p++ = '0';
+        *p++ = '.';
+        for ( int i = -1; i > x; i-- )
+            *p++ = '0';
+        memcpy( p, digits, 9 );
+        return p + 9;
+    }
+
+    *p++ = digits[ 0 ];
+    *p++ = '.';
+    memcpy( p, digits + 1, 8 );
+    p += 8;
+    *p++ = 'e';
+    *p++ = x < 0 ? '-' : '+';
+    if ( x < 0 )
+        x = - x;
+    if ( x < 10 )
+        *p++ = '0';
+
+    return format_long( p, x );
+}
+
+
+/*---------------------------------------------------------------------*
+ * Writes an array to a binary file. Arrays where all sub-arrays exist
+ * and have the same lengths are written as a single record. For other
+ * arrays the sub-arrays are written one after another, separated by
+ * text records with an empty line, just like arr_save() does it.
+ *---------------------------------------------------------------------*/
+
+static
+long
+bin_arr_save( long    file_num,
+              Var_T * v )
+{
+    long count = 0;
+    ssize_t * volatile dims = T_malloc( v->dim * sizeof *dims );
+
+
+    TRY
+    {
+        if ( bin_get_dims( v, dims ) )
+        {
+            int type = v->type == INT_ARR || v->type == INT_REF ?
+                       BIN_INT : BIN_FLOAT;
+
+            count += bin_write_record_header( file_num, type, v->dim, dims );
+            count += bin_write_arr_values( file_num, v );
+        }
+        else
+            for ( ssize_t i = 0; i < v->len; i++ )
+            {
+                if ( v->val.vptr[ i ] )
+                    count += bin_arr_save( file_num, v->val.vptr[ i ] );
+                if ( i != v->len - 1 )
+                    count += bin_write_text( file_num, "\n", 1 );
+            }
+
+        TRY_SUCCESS;
+    }
+    OTHERWISE
+    {
+        T_free( dims );
+        RETHROW;
+    }
+
+    T_free( dims );
+    return count;
+}
+
+
+/*-------------------------------------------------------------------*
+ * Determines the sizes of all dimensions of an array (from the first
+ * sub-array in each dimension) and stores them in 'dims'. Returns if
+ * the array is "rectangular", i.e. if all other sub-arrays exist and
+ * have the same sizes.
+ *-------------------------------------------------------------------*/
+
+static
+bool
+bin_get_dims( Var_T   * v,
+              ssize_t * dims )
+{
+    Var_T *cv = v;
+    int i = 0;
+
+
+    while ( cv->type == INT_REF || cv->type == FLOAT_REF )
+    {
+        if ( cv->len == 0 || ! cv->val.vptr[ 0 ] )
+            return false;
+        dims[ i++ ] = cv->len;
+        cv = cv->val.vptr[ 0 ];
+    }
+
+    dims[ i ] = cv->len;
+
+    return i == v->dim - 1 && bin_dims_match( v, dims, cv->type );
+}
+
+
+/*---------------------------------------------------------------*
+ * Checks if an array has the sizes of its dimensions as given by
+ * 'dims' and that all its 1-dimensional sub-arrays are of 'type'.
+ *---------------------------------------------------------------*/
+
+static
+bool
+bin_dims_match( Var_T         * v,
+                const ssize_t * dims,
+                int             type )
+{
+    if ( v->len != dims[ 0 ] )
+        return false;
+
+    if ( v->type == INT_ARR || v->type == FLOAT_ARR )
+        return ( int ) v->type == type;
+
+    for ( ssize_t i = 0; i < v->len; i++ )
+        if (    ! v->val.vptr[ i ]
+             || ! bin_dims_match( v->val.vptr[ i ], dims + 1, type ) )
+            return false;
+
+    return true;
+}
+
+
+/*-------------------------------------------------------------*
+ * Writes out all the elements of an array to a binary file,
+ * the last index varying fastest.
+ *-------------------------------------------------------------*/
+
+static
+long
+bin_write_arr_values( long    file_num,
+                      Var_T * v )
+{
+    long count = 0;
+
+
+    if ( v->type == INT_ARR )
+        return bin_write_values( file_num, BIN_INT, v->val.lpnt, v->len );
+
+    if ( v->type == FLOAT_ARR )
+        return bin_write_values( file_num, BIN_FLOAT, v->val.dpnt, v->len );
+
+    for ( ssize_t i = 0; i < v->len; i++ )
+        count += bin_write_arr_values( file_num, v->val.vptr[ i ] );
 
     return count;
 }
@@ -2544,14 +3224,10 @@ f_save_c( Var_T * v )
 
 
 /*--------------------------------------------------------------------*
- * Function that does all the writing to files. It does lots of tests
- * to make sure that really everything got written to the file and
- * tries to handle situations gracefully where there isn't enough
- * space left on a disk by asking for a replacement file and copying
- * everything already written to the file on the full disk into the
- * replacement file. The function returns the number of chars written
- * to the file (but not the copied bytes in case a replacement file
- * had to be used).
+ * Function that does all the formatted writing to files, the actual
+ * writing is done by T_fwrite(). For binary files the text gets
+ * written as a text record. The function returns the number of chars
+ * written to the file.
  *--------------------------------------------------------------------*/
 
 #define BUFFER_SIZE_GUESS 128       /* guess for number of characters needed */
@@ -2645,24 +3321,78 @@ T_fprintf( long         fn,
 
     /* Now we try to write the string to the file */
 
+    long count = fl->binary ? bin_write_text( fn, p, to_write )
+                            : T_fwrite( fn, p, to_write );
+
+    if ( p != initial_buffer )
+        T_free( p );
+
+    return count;
+}
+
+
+/*--------------------------------------------------------------------*
+ * Function that does all the writing to files. It does lots of tests
+ * to make sure that really everything got written to the file and
+ * tries to handle situations gracefully where there isn't enough
+ * space left on a disk by asking for a replacement file and copying
+ * everything already written to the file on the full disk into the
+ * replacement file. The function returns the number of chars written
+ * to the file (but not the copied bytes in case a replacement file
+ * had to be used).
+ *--------------------------------------------------------------------*/
+
+static
+long
+T_fwrite( long         fn,
+          const void * buf,
+          size_t       len )
+{
+    long file_num = fn - FILE_NUMBER_OFFSET;
+    File_List_T *fl = EDL.File_List + file_num;
+    const char *p = buf;
     long count;
     long written = 0;
 
+
+    /* If the file has been closed because of insufficient space just don't
+       write */
+
+    if (    ( ! fl->gzip && ! fl->fp )
+         || (   fl->gzip && ! fl->gp ) )
+        return 0;
+
+    /* Except for stdout and stderr the data are just appended to the file's
+       write-behind queue (created on first use) and the writer thread takes
+       care of writing them. If it failed to write earlier data we only learn
+       about it here and then have to ask the user to make room on the disk
+       before more data can be accepted. */
+
+    if ( file_num > 1 && ! ( Fsc2_Internals.cmdline_flags & DO_CHECK ) )
+    {
+        if ( ! fl->wq )
+            fl->wq = write_queue_create( fl->gzip ? NULL : fl->fp,
+                                         fl->gzip ? fl->gp : NULL );
+
+        while ( true )
+        {
+            written += write_queue_put( fl->wq, p + written, len - written );
+            if ( written == ( long ) len || ! write_error( fl ) )
+                return written;
+        }
+    }
+
  get_repeat_write:
 
-    count = fl->gzip ? gzwrite( fl->gp, p + written, to_write - written)
-                     : ( ssize_t ) fwrite( p + written, 1, to_write - written,
+    count = fl->gzip ? gzwrite( fl->gp, p + written, len - written )
+                     : ( ssize_t ) fwrite( p + written, 1, len - written,
                                            fl->fp );
 
-    if ( count == to_write - written )
-    {
-        if ( p != initial_buffer )
-            T_free( p );
+    if ( count == ( long ) len - written )
         return count + written;
-    }
 
-    /* If less characters than required where written we reduce 'to_write' to
-       the number of characters that still need to be written out. */
+    /* If less characters than required where written we remember how
+       many got written and retry with the remaining ones. */
 
     if ( count > 0 )
         written  += count;
@@ -2675,38 +3405,235 @@ T_fprintf( long         fn,
         print( SEVERE, "Can't write to std%s, if it's redirected to a "
                "file make sure there's enough space on the disk.\n",
                file_num == 0 ? "out" : "err" );
-        if ( p != initial_buffer )
-            T_free( p );
         return written;
     }
 
-    /* Couldn't write as many bytes as needed, disk is probably full.
-       Ask the user to elete some files and try again. */
+    if ( ! write_error( fl ) )
+        return written;
 
+    goto get_repeat_write;
+}
+
+
+/*-------------------------------------------------------------------*
+ * Called when not all data could be written to a file, the disk is
+ * probably full. Asks the user to delete some files. If the user
+ * deleted the file itself it gets closed and false is returned,
+ * otherwise true to indicate that writing should be tried again.
+ *-------------------------------------------------------------------*/
+
+static
+bool
+write_error( File_List_T * fl )
+{
     char * mess = get_string( "Disk full while writing to file\n%s\n"
                               "Please delete some files.", fl->name );
     show_message( mess );
     T_free( mess );
 
-    /* If the user deleted the file we're currently writing to delete it */
+    /* If the user deleted the file we're currently writing to close it */
 
     struct stat stat_buf;
     if ( stat( fl->name, &stat_buf ) == -1 )
     {
-        if ( p != initial_buffer )
-            T_free( p );
+        close_file( fl );
         T_free( fl->name );
         fl->name = NULL;
-        if ( ! fl->gzip && fl->fp )
-            fclose( fl->fp );
-        else if ( fl->gzip && fl->gp )
-            gzclose( fl->gp );
-        fl->fp = NULL;
-        fl->gp = NULL;
-        return written;
+        return false;
     }
 
-    goto get_repeat_write;
+    if ( fl->wq )
+        write_queue_retry( fl->wq );
+
+    return true;
+}
+
+
+/*---------------------------------------------------------------*
+ * Waits until all data in the write-behind queue of a file have
+ * been written out, asking the user to make room on the disk if
+ * necessary.
+ *---------------------------------------------------------------*/
+
+static
+void
+flush_file( File_List_T * fl )
+{
+    while ( fl->wq && ! write_queue_flush( fl->wq ) && write_error( fl ) )
+        /* empty */ ;
+}
+
+
+/*------------------------------------------------------------*
+ * Closes a file, data still in its write-behind queue get
+ * discarded (use flush_file() before if they're needed).
+ *------------------------------------------------------------*/
+
+static
+void
+close_file( File_List_T * fl )
+{
+    /* Compressed files are opened in transparent mode and the write-behind
+       queue creates the gzip stream. If nothing ever got written to the
+       file there's no queue and we have to write an empty stream. */
+
+    if ( fl->gzip && fl->gp && ! fl->wq )
+        gzwrite( fl->gp, "\x1f\x8b\x08\0\0\0\0\0\0\x03"
+                         "\x03\0\0\0\0\0\0\0\0\0", 20 );
+
+    write_queue_close( fl->wq );
+    fl->wq = NULL;
+
+    if ( ! fl->gzip && fl->fp )
+        fclose( fl->fp );
+    else if ( fl->gzip && fl->gp )
+        gzclose( fl->gp );
+
+    fl->fp = NULL;
+    fl->gp = NULL;
+}
+
+
+/*-----------------------------------------------------------*
+ * Writes the header (magic string and format version) at the
+ * start of a binary file.
+ *-----------------------------------------------------------*/
+
+static
+long
+bin_write_header( long file_num )
+{
+    unsigned char buf[ BIN_HEADER_SIZE ] = BIN_MAGIC;
+
+
+    bin_put32( buf + 8, BIN_VERSION );
+    return T_fwrite( file_num, buf, sizeof buf );
+}
+
+
+/*---------------------------------------------------------------*
+ * Writes the start of a record to a binary file, i.e. the type
+ * of the data, the number of dimensions and their sizes.
+ *---------------------------------------------------------------*/
+
+static
+long
+bin_write_record_header( long            file_num,
+                         int             type,
+                         int             ndims,
+                         const ssize_t * dims )
+{
+    unsigned char buf[ 8 ];
+    long count;
+
+
+    bin_put32( buf, type );
+    bin_put32( buf + 4, ndims );
+    count = T_fwrite( file_num, buf, 8 );
+
+    for ( int i = 0; i < ndims; i++ )
+    {
+        bin_put64( buf, dims[ i ] );
+        count += T_fwrite( file_num, buf, 8 );
+    }
+
+    return count;
+}
+
+
+/*-------------------------------------------------------------------*
+ * Writes integer (long) or float (double) values to a binary file.
+ * On little-endian machines with 64-bit longs the data can be written
+ * directly, otherwise they're converted in chunks.
+ *-------------------------------------------------------------------*/
+
+static
+long
+bin_write_values( long         file_num,
+                  int          type,
+                  const void * data,
+                  size_t       count )
+{
+    uint16_t endian_test = 1;
+
+
+    if (    * ( unsigned char * ) &endian_test == 1
+         && ( type == BIN_FLOAT || sizeof( long ) == 8 ) )
+        return T_fwrite( file_num, data, 8 * count );
+
+    unsigned char buf[ 8 * BIN_CHUNK ];
+    long written = 0;
+
+    for ( size_t done = 0; done < count; )
+    {
+        size_t n = count - done < BIN_CHUNK ? count - done : BIN_CHUNK;
+
+        for ( size_t i = 0; i < n; i++ )
+        {
+            uint64_t u;
+
+            if ( type == BIN_FLOAT )
+                memcpy( &u, ( const double * ) data + done + i, 8 );
+            else
+                u = ( int64_t ) ( ( const long * ) data )[ done + i ];
+
+            bin_put64( buf + 8 * i, u );
+        }
+
+        written += T_fwrite( file_num, buf, 8 * n );
+        done += n;
+    }
+
+    return written;
+}
+
+
+/*-------------------------------------------------------------*
+ * Writes a text record to a binary file (with the text padded
+ * with zero bytes to a multiple of 8 bytes)
+ *-------------------------------------------------------------*/
+
+static
+long
+bin_write_text( long         file_num,
+                const char * text,
+                size_t       len )
+{
+    static const unsigned char zeros[ 8 ];
+    ssize_t dims = len;
+
+
+    return   bin_write_record_header( file_num, BIN_TEXT, 1, &dims )
+           + T_fwrite( file_num, text, len )
+           + T_fwrite( file_num, zeros, ( 8 - len % 8 ) % 8 );
+}
+
+
+/*----------------------------------------------------*
+ * Stores a 32-bit value in little-endian byte order
+ *----------------------------------------------------*/
+
+static
+void
+bin_put32( unsigned char * p,
+           uint32_t        v )
+{
+    for ( int i = 0; i < 4; v >>= 8, i++ )
+        p[ i ] = v & 0xFF;
+}
+
+
+/*----------------------------------------------------*
+ * Stores a 64-bit value in little-endian byte order
+ *----------------------------------------------------*/
+
+static
+void
+bin_put64( unsigned char * p,
+           uint64_t        v )
+{
+    for ( int i = 0; i < 8; v >>= 8, i++ )
+        p[ i ] = v & 0xFF;
 }
 
 
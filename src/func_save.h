@@ -30,17 +30,43 @@
 typedef struct File_List File_List_T;
 
 struct File_List {
-    FILE   * fp;
-    gzFile   gp;
-    char   * name;
-    bool     gzip;
+    FILE          * fp;
+    gzFile          gp;
+    char          * name;
+    bool            gzip;
+    bool            binary;
+    Write_Queue_T * wq;        /* write-behind queue, NULL until used */
+};
+
+
+/* State of a file as stored in checkpoints (see checkpoint.c) */
+
+typedef struct {
+    char          * name;
+    bool            is_open;
+    bool            gzip;
+    bool            binary;
+    off_t           offset;    /* length of the file */
+    unsigned long   crc;       /* CRC32 and length of uncompressed data */
+    unsigned long   size;      /* written to a compressed file */
+} File_State_T;
+
+
+/* Flags for the state of the list of files as a whole */
+
+enum {
+    FILES_STD_IS_OPEN     = ( 1 << 0 ),
+    FILES_NO_FILE_NUMBERS = ( 1 << 1 ),
+    FILES_DONT_SAVE       = ( 1 << 2 )
 };
 
 
 Var_T * f_openf(     Var_T * /* v */ );
 Var_T * f_opengzf(   Var_T * /* v */ );
+Var_T * f_openbf(    Var_T * /* v */ );
 Var_T * f_getf(      Var_T * /* v */ );
 Var_T * f_getgzf(    Var_T * /* v */ );
+Var_T * f_getbf(     Var_T * /* v */ );
 Var_T * f_clonef(    Var_T * /* v */ );
 Var_T * f_clonegzf(  Var_T * /* v */ );
 Var_T * f_resetf(    Var_T * /* v */ );
@@ -55,6 +81,13 @@ Var_T * f_file_name( Var_T * /* v */ );
 Var_T * f_path_name( Var_T * /* v */ );
 Var_T * f_delf(      Var_T * /* v */ );
 
+File_State_T * get_file_states( int * /* num   */,
+                                int * /* flags */  );
+
+void restore_file( const File_State_T * /* fs */ );
+
+void restore_file_flags( int /* flags */ );
+
 
 #endif  /* ! FUNC_SAVE_HEADER */
 
@@ -938,7 +938,7 @@ f_dmode( Var_T * v )
 {
     long mode;
     long width = 0;
-    int shm_id;
+    Data_Buffer_T db;
     long len = 0;                    /* total length of message to send */
     void *buf;
     char *ptr;
@@ -1042,16 +1042,16 @@ f_dmode( Var_T * v )
 
     len = sizeof len + sizeof type + sizeof mode + sizeof width;
 
-    /* Now try to get a shared memory segment */
+    /* Now try to get a buffer in shared memory */
 
-    if ( ( buf = get_shm( &shm_id, len ) ) == NULL )
+    if ( ( buf = get_data_buffer( &db, len ) ) == NULL )
     {
         eprint( FATAL, false, "Internal communication problem at %s:%d.\n",
                 __FILE__, __LINE__ );
         THROW( EXCEPTION );
     }
 
-    /* Copy the data to the segment */
+    /* Copy the data to the buffer */
 
     ptr = buf;
 
@@ -1067,14 +1067,10 @@ f_dmode( Var_T * v )
     memcpy( ptr, &width, sizeof width );               /* new width */
     ptr += sizeof width;
 
-    /* Detach from the segment with the data segment */
-
-    detach_shm( buf, NULL );
-
     /* Wait for parent to become ready to accept new data, then store
        identifier and send signal to tell parent about the data */
 
-    send_data( DATA_1D, shm_id );
+    send_data( DATA_1D, &db );
 
     return vars_push( INT_VAR, 1L );
 }
@@ -1131,7 +1127,7 @@ f_cscale_1d( Var_T * v )
     double x_0 = 0.0,                /* new scale settings */
            dx  = 0.0;
     int is_set = 0;                  /* flags, indicating what to change */
-    int shm_id;
+    Data_Buffer_T db;
     long len = 0;                    /* total length of message to send */
     void *buf;
     char *ptr;
@@ -1202,16 +1198,16 @@ f_cscale_1d( Var_T * v )
     len =   sizeof len + sizeof type + sizeof is_set
           + sizeof x_0 + sizeof dx;
 
-    /* Now try to get a shared memory segment */
+    /* Now try to get a buffer in shared memory */
 
-    if ( ( buf = get_shm( &shm_id, len ) ) == NULL )
+    if ( ( buf = get_data_buffer( &db, len ) ) == NULL )
     {
         eprint( FATAL, false, "Internal communication problem at %s:%d.\n",
                 __FILE__, __LINE__ );
         THROW( EXCEPTION );
     }
 
-    /* Copy the data to the segment */
+    /* Copy the data to the buffer */
 
     ptr = buf;
 
@@ -1230,14 +1226,10 @@ f_cscale_1d( Var_T * v )
     memcpy( ptr, &dx, sizeof dx );                     /* new x-increment */
     ptr += sizeof dx;
 
-    /* Detach from the segment with the data segment */
-
-    detach_shm( buf, NULL );
-
     /* Wait for parent to become ready to accept new data, then store
        identifier and send signal to tell parent about the data */
 
-    send_data( DATA_1D, shm_id );
+    send_data( DATA_1D, &db );
 
     return vars_push( INT_VAR, 1L );
 }
@@ -1255,7 +1247,7 @@ f_cscale_2d( Var_T * v )
            dx  = 0.0,
            dy  = 0.0;
     int is_set = 0;                  /* flags, indicating what to change */
-    int shm_id;
+    Data_Buffer_T db;
     long len = 0;                    /* total length of message to send */
     void *buf;
     char *ptr;
@@ -1339,16 +1331,16 @@ f_cscale_2d( Var_T * v )
     len =   sizeof len + sizeof type + sizeof is_set
           + sizeof x_0 + sizeof dx + sizeof y_0 + sizeof dy;
 
-    /* Now try to get a shared memory segment */
+    /* Now try to get a buffer in shared memory */
 
-    if ( ( buf = get_shm( &shm_id, len ) ) == NULL )
+    if ( ( buf = get_data_buffer( &db, len ) ) == NULL )
     {
         eprint( FATAL, false, "Internal communication problem at %s:%d.\n",
                 __FILE__, __LINE__ );
         THROW( EXCEPTION );
     }
 
-    /* Copy the data to the segment */
+    /* Copy the data to the buffer */
 
     ptr = buf;
 
@@ -1373,14 +1365,10 @@ f_cscale_2d( Var_T * v )
     memcpy( ptr, &dy, sizeof dy );                     /* new y-increment */
     ptr += sizeof dy;
 
-    /* Detach from the segment with the data segment */
-
-    detach_shm( buf, NULL );
-
     /* Wait for parent to become ready to accept new data, then store
        identifier and send signal to tell parent about the data */
 
-    send_data( DATA_2D, shm_id );
+    send_data( DATA_2D, &db );
 
     return vars_push( INT_VAR, 1L );
 }
@@ -1431,7 +1419,7 @@ f_vrescale( Var_T * v )
 Var_T *
 f_vrescale_1d( Var_T * v  UNUSED_ARG )
 {
-    int shm_id;
+    Data_Buffer_T db;
     long len = 0;                    /* total length of message to send */
     void *buf;
     char *ptr;
@@ -1476,16 +1464,16 @@ f_vrescale_1d( Var_T * v  UNUSED_ARG )
 
     len = sizeof len + sizeof type;
 
-    /* Now try to get a shared memory segment */
+    /* Now try to get a buffer in shared memory */
 
-    if ( ( buf = get_shm( &shm_id, len ) ) == NULL )
+    if ( ( buf = get_data_buffer( &db, len ) ) == NULL )
     {
         eprint( FATAL, false, "Internal communication problem at %s:%d.\n",
                 __FILE__, __LINE__ );
         THROW( EXCEPTION );
     }
 
-    /* Copy the data to the segment */
+    /* Copy the data to the buffer */
 
     ptr = buf;
 
@@ -1495,14 +1483,10 @@ f_vrescale_1d( Var_T * v  UNUSED_ARG )
     memcpy( ptr, &type, sizeof type );                 /* type indicator  */
     ptr += sizeof type;
 
-    /* Detach from the segment with the data segment */
-
-    detach_shm( buf, NULL );
-
     /* Wait for parent to become ready to accept new data, then store
        identifier and send signal to tell parent about the data */
 
-    send_data( DATA_1D, shm_id );
+    send_data( DATA_1D, &db );
 
     return vars_push( INT_VAR, 1L );
 }
@@ -1514,7 +1498,7 @@ f_vrescale_1d( Var_T * v  UNUSED_ARG )
 Var_T *
 f_vrescale_2d( Var_T * v  UNUSED_ARG )
 {
-    int shm_id;
+    Data_Buffer_T db;
     long len = 0;                    /* total length of message to send */
     void *buf;
     char *ptr;
@@ -1559,16 +1543,16 @@ f_vrescale_2d( Var_T * v  UNUSED_ARG )
 
     len = sizeof len + sizeof type;
 
-    /* Now try to get a shared memory segment */
+    /* Now try to get a buffer in shared memory */
 
-    if ( ( buf = get_shm( &shm_id, len ) ) == NULL )
+    if ( ( buf = get_data_buffer( &db, len ) ) == NULL )
     {
         eprint( FATAL, false, "Internal communication problem at %s:%d.\n",
                 __FILE__, __LINE__ );
         THROW( EXCEPTION );
     }
 
-    /* Copy the data to the segment */
+    /* Copy the data to the buffer */
 
     ptr = buf;
 
@@ -1578,14 +1562,10 @@ f_vrescale_2d( Var_T * v  UNUSED_ARG )
     memcpy( ptr, &type, sizeof type );                 /* type indicator  */
     ptr += sizeof type;
 
-    /* Detach from the segment with the data segment */
-
-    detach_shm( buf, NULL );
-
     /* Wait for parent to become ready to accept new data, then store
        identifier and send signal to tell parent about the data */
 
-    send_data( DATA_2D, shm_id );
+    send_data( DATA_2D, &db );
 
     return vars_push( INT_VAR, 1L );
 }
@@ -1642,7 +1622,7 @@ f_clabel_1d( Var_T * v )
 {
     char *l[ 2 ] = { NULL, NULL };
     long lengths[ 2 ] = { 1, 1 };
-    int shm_id;
+    Data_Buffer_T db;
     long len = 0;                    /* total length of message to send */
     void *buf;
     char *ptr;
@@ -1712,9 +1692,9 @@ f_clabel_1d( Var_T * v )
     for ( i = X; i <= Y; i++ )
         len += sizeof lengths[ i ] + lengths[ i ];
 
-    /* Now try to get a shared memory segment */
+    /* Now try to get a buffer in shared memory */
 
-    if ( ( buf = get_shm( &shm_id, len ) ) == NULL )
+    if ( ( buf = get_data_buffer( &db, len ) ) == NULL )
     {
         eprint( FATAL, false, "Internal communication problem at %s:%d.\n",
                 __FILE__, __LINE__ );
@@ -1723,7 +1703,7 @@ f_clabel_1d( Var_T * v )
         THROW( EXCEPTION );
     }
 
-    /* Copy the data to the segment */
+    /* Copy the data to the buffer */
 
     ptr = buf;
 
@@ -1747,14 +1727,10 @@ f_clabel_1d( Var_T * v )
         ptr += lengths[ i ];
     }
 
-    /* Detach from the segment with the data segment */
-
-    detach_shm( buf, NULL );
-
     /* Wait for parent to become ready to accept new data, then store
        identifier and send signal to tell parent about the data */
 
-    send_data( DATA_1D, shm_id );
+    send_data( DATA_1D, &db );
 
     return vars_push( INT_VAR, 1L );
 }
@@ -1770,7 +1746,7 @@ f_clabel_2d( Var_T * v )
 {
     char *l[ 3 ] = { NULL, NULL, NULL };
     long lengths[ 3 ] = { 1, 1, 1 };
-    int shm_id;
+    Data_Buffer_T db;
     long len = 0;                    /* total length of message to send */
     void *buf;
     char *ptr;
@@ -1847,9 +1823,9 @@ f_clabel_2d( Var_T * v )
     for ( i = X; i <= Z; i++ )
         len += sizeof lengths[ i ] + lengths[ i ];
 
-    /* Now try to get a shared memory segment */
+    /* Now try to get a buffer in shared memory */
 
-    if ( ( buf = get_shm( &shm_id, len ) ) == NULL )
+    if ( ( buf = get_data_buffer( &db, len ) ) == NULL )
     {
         eprint( FATAL, false, "Internal communication problem at %s:%d.\n",
                 __FILE__, __LINE__ );
@@ -1859,7 +1835,7 @@ f_clabel_2d( Var_T * v )
         THROW( EXCEPTION );
     }
 
-    /* Copy the data to the segment */
+    /* Copy the data to the buffer */
 
     ptr = buf;
 
@@ -1883,14 +1859,10 @@ f_clabel_2d( Var_T * v )
         ptr += lengths[ i ];
     }
 
-    /* Detach from the segment with the data segment */
-
-    detach_shm( buf, NULL );
-
     /* Wait for parent to become ready to accept new data, then store
        identifier and send signal to tell parent about the data */
 
-    send_data( DATA_2D, shm_id );
+    send_data( DATA_2D, &db );
 
     return vars_push( INT_VAR, 1L );
 }
@@ -1947,7 +1919,7 @@ Var_T *
 f_rescale_1d( Var_T * v )
 {
     long new_nx;
-    int shm_id;
+    Data_Buffer_T db;
     long len = 0;                    /* total length of message to send */
     void *buf;
     char *ptr;
@@ -2007,16 +1979,16 @@ f_rescale_1d( Var_T * v )
 
     len = sizeof len + sizeof type + sizeof new_nx;
 
-    /* Now try to get a shared memory segment */
+    /* Now try to get a buffer in shared memory */
 
-    if ( ( buf = get_shm( &shm_id, len ) ) == NULL )
+    if ( ( buf = get_data_buffer( &db, len ) ) == NULL )
     {
         eprint( FATAL, false, "Internal communication problem at %s:%d.\n",
                 __FILE__, __LINE__ );
         THROW( EXCEPTION );
     }
 
-    /* Copy the data to the segment */
+    /* Copy the data to the buffer */
 
     ptr = buf;
 
@@ -2029,14 +2001,10 @@ f_rescale_1d( Var_T * v )
     memcpy( ptr, &new_nx, sizeof new_nx );             /* new # of x points */
     ptr += sizeof new_nx;
 
-    /* Detach from the segment with the data segment */
-
-    detach_shm( buf, NULL );
-
     /* Wait for parent to become ready to accept new data, then store
        identifier and send signal to tell parent about the data */
 
-    send_data( DATA_1D, shm_id );
+    send_data( DATA_1D, &db );
 
     return vars_push( INT_VAR, 1L );
 }
@@ -2051,7 +2019,7 @@ Var_T *
 f_rescale_2d( Var_T * v )
 {
     long new_nx, new_ny;
-    int shm_id;
+    Data_Buffer_T db;
     long len = 0;                    /* total length of message to send */
     void *buf;
     char *ptr;
@@ -2118,16 +2086,16 @@ f_rescale_2d( Var_T * v )
 
     len = sizeof len + sizeof type + sizeof new_nx + sizeof new_ny;
 
-    /* Now try to get a shared memory segment */
+    /* Now try to get a buffer in shared memory */
 
-    if ( ( buf = get_shm( &shm_id, len ) ) == NULL )
+    if ( ( buf = get_data_buffer( &db, len ) ) == NULL )
     {
         eprint( FATAL, false, "Internal communication problem at %s:%d.\n",
                 __FILE__, __LINE__ );
         THROW( EXCEPTION );
     }
 
-    /* Copy the data to the segment */
+    /* Copy the data to the buffer */
 
     ptr = buf;
 
@@ -2142,14 +2110,10 @@ f_rescale_2d( Var_T * v )
 
     memcpy( ptr, &new_ny, sizeof new_ny );             /* new # of y points */
 
-    /* Detach from the segment with the data segment */
-
-    detach_shm( buf, NULL );
-
     /* Wait for parent to become ready to accept new data, then store
        identifier and send signal to tell parent about the data */
 
-    send_data( DATA_2D, shm_id );
+    send_data( DATA_2D, &db );
 
     return vars_push( INT_VAR, 1L );
 }
@@ -2203,7 +2167,7 @@ Var_T *
 f_display_1d( Var_T * v )
 {
     dpoint_T *dp;
-    int shm_id;
+    Data_Buffer_T db;
     long len = 0;                     /* total length of message to send */
     void *buf;
     char *ptr;
@@ -2293,9 +2257,9 @@ f_display_1d( Var_T * v )
         }
     }
 
-    /* Now try to get a shared memory segment */
+    /* Now try to get a buffer in shared memory */
 
-    if ( ( buf = get_shm( &shm_id, len ) ) == NULL )
+    if ( ( buf = get_data_buffer( &db, len ) ) == NULL )
     {
         T_free( dp );
         eprint( FATAL, false, "Internal communication problem at %s:%d.\n",
@@ -2303,7 +2267,7 @@ f_display_1d( Var_T * v )
         THROW( EXCEPTION );
     }
 
-    /* Copy the data to the segment */
+    /* Copy the data to the buffer */
 
     ptr = buf;
 
@@ -2358,10 +2322,6 @@ f_display_1d( Var_T * v )
         }
     }
 
-    /* Detach from the segment with the data */
-
-    detach_shm( buf, NULL );
-
     /* Get rid of the array of structures returned by eval_display_args() */
 
     T_free( dp );
@@ -2369,7 +2329,7 @@ f_display_1d( Var_T * v )
     /* Wait for parent to become ready to accept new data, then store
        identifier and send signal to tell parent about the data */
 
-    send_data( DATA_1D, shm_id );
+    send_data( DATA_1D, &db );
 
     return vars_push( INT_VAR, 1L );
 }
@@ -2383,7 +2343,7 @@ Var_T *
 f_display_2d( Var_T * v )
 {
     dpoint_T *dp;
-    int shm_id;
+    Data_Buffer_T db;
     long len = 0;                     /* total length of message to send */
     void *buf;
     char *ptr;
@@ -2484,9 +2444,9 @@ f_display_2d( Var_T * v )
         }
     }
 
-    /* Now try to get a shared memory segment */
+    /* Now try to get a buffer in shared memory */
 
-    if ( ( buf = get_shm( &shm_id, len ) ) == NULL )
+    if ( ( buf = get_data_buffer( &db, len ) ) == NULL )
     {
         T_free( dp );
         eprint( FATAL, false, "Internal communication problem at %s:%d.\n",
@@ -2609,10 +2569,6 @@ f_display_2d( Var_T * v )
         }
     }
 
-    /* Detach from the segment with the data */
-
-    detach_shm( buf, NULL );
-
     /* Get rid of the array of structures returned by eval_display_args() */
 
     T_free( dp );
@@ -2620,7 +2576,7 @@ f_display_2d( Var_T * v )
     /* Wait for parent to become ready to accept new data, then store
        identifier and send signal to tell parent about the data */
 
-    send_data( DATA_2D, shm_id );
+    send_data( DATA_2D, &db );
 
     return vars_push( INT_VAR, 1L );
 }
@@ -2901,7 +2857,7 @@ f_clearcv_1d( Var_T * v )
     long curve;
     long count = 0;
     long *ca = NULL;
-    int shm_id;
+    Data_Buffer_T db;
     long len = 0;                    /* total length of message to send */
     void *buf;
     char *ptr;
@@ -2993,12 +2949,12 @@ f_clearcv_1d( Var_T * v )
 
     fsc2_assert( Fsc2_Internals.I_am == CHILD );
 
-    /* Now try to get a shared memory segment */
+    /* Now try to get a buffer in shared memory */
 
     len =   sizeof len + sizeof type + sizeof count
           + count * sizeof *ca;
 
-    if ( ( buf = get_shm( &shm_id, len ) ) == NULL )
+    if ( ( buf = get_data_buffer( &db, len ) ) == NULL )
     {
         T_free( ca );
         eprint( FATAL, false, "Internal communication problem at %s:%d.\n",
@@ -3006,7 +2962,7 @@ f_clearcv_1d( Var_T * v )
         THROW( EXCEPTION );
     }
 
-    /* Copy all data into the shared memory segment */
+    /* Copy all data into the shared memory buffer */
 
     ptr = buf;
 
@@ -3021,10 +2977,6 @@ f_clearcv_1d( Var_T * v )
 
     memcpy( ptr, ca, count * sizeof *ca );         /* array of curve numbers */
 
-    /* Detach from the segment with the data */
-
-    detach_shm( buf, NULL );
-
     /* Get rid of the array of curve numbers */
 
     T_free( ca );
@@ -3032,7 +2984,7 @@ f_clearcv_1d( Var_T * v )
     /* Wait for parent to become ready to accept new data, then store
        identifier and send signal to tell it about them */
 
-    send_data( DATA_1D, shm_id );
+    send_data( DATA_1D, &db );
 
     /* All the rest has now to be done by the parent process... */
 
@@ -3050,7 +3002,7 @@ f_clearcv_2d( Var_T * v )
     long curve;
     long count = 0;
     long *ca = NULL;
-    int shm_id;
+    Data_Buffer_T db;
     long len = 0;                    /* total length of message to send */
     void *buf;
     char *ptr;
@@ -3142,12 +3094,12 @@ f_clearcv_2d( Var_T * v )
 
     fsc2_assert( Fsc2_Internals.I_am == CHILD );
 
-    /* Now try to get a shared memory segment */
+    /* Now try to get a buffer in shared memory */
 
     len =   sizeof len + sizeof type + sizeof count
           + count * sizeof *ca;
 
-    if ( ( buf = get_shm( &shm_id, len ) ) == NULL )
+    if ( ( buf = get_data_buffer( &db, len ) ) == NULL )
     {
         T_free( ca );
         eprint( FATAL, false, "Internal communication problem at %s:%d.\n",
@@ -3155,7 +3107,7 @@ f_clearcv_2d( Var_T * v )
         THROW( EXCEPTION );
     }
 
-    /* Copy all data into the shared memory segment */
+    /* Copy all data into the shared memory buffer */
 
     ptr = buf;
 
@@ -3170,10 +3122,6 @@ f_clearcv_2d( Var_T * v )
 
     memcpy( ptr, ca, count * sizeof *ca );         /* array of curve numbers */
 
-    /* Detach from the segment with the data */
-
-    detach_shm( buf, NULL );
-
     /* Get rid of the array of curve numbers */
 
     T_free( ca );
@@ -3181,7 +3129,7 @@ f_clearcv_2d( Var_T * v )
     /* Wait for parent to become ready to accept new data, then store
        identifier and send signal to tell it about them */
 
-    send_data( DATA_2D, shm_id );
+    send_data( DATA_2D, &db );
 
     /* All the rest has now to be done by the parent process... */
 
@@ -3241,7 +3189,7 @@ f_setmark_1d( Var_T * v )
     void *buf;
     char *ptr;
     int type = D_SET_MARKER;
-    int shm_id;
+    Data_Buffer_T db;
     const char *colors[ ] = { "WHITE", "RED", "GREEN", "YELLOW",
                               "BLUE", "BLACK", "DELETE" };
     long num_colors = ( long ) NUM_ELEMS( colors );
@@ -3324,18 +3272,18 @@ f_setmark_1d( Var_T * v )
 
     fsc2_assert( Fsc2_Internals.I_am == CHILD );
 
-    /* Now try to get a shared memory segment */
+    /* Now try to get a buffer in shared memory */
 
     len = sizeof len + sizeof type + sizeof position + sizeof color;
 
-    if ( ( buf = get_shm( &shm_id, len ) ) == NULL )
+    if ( ( buf = get_data_buffer( &db, len ) ) == NULL )
     {
         eprint( FATAL, false, "Internal communication problem at %s:%d.\n",
                 __FILE__, __LINE__ );
         THROW( EXCEPTION );
     }
 
-    /* Copy all data into the shared memory segment */
+    /* Copy all data into the shared memory buffer */
 
     ptr = buf;
 
@@ -3350,14 +3298,10 @@ f_setmark_1d( Var_T * v )
 
     memcpy( ptr, &color, sizeof color );
 
-    /* Detach from the segment with the data */
-
-    detach_shm( buf, NULL );
-
     /* Wait for parent to become ready to accept new data, then store
        identifier and send signal to tell it about them */
 
-    send_data( DATA_1D, shm_id );
+    send_data( DATA_1D, &db );
 
     /* All the rest has now to be done by the parent process... */
 
@@ -3380,7 +3324,7 @@ f_setmark_2d( Var_T * v )
     void *buf;
     char *ptr;
     int type = D_SET_MARKER;
-    int shm_id;
+    Data_Buffer_T db;
     const char *colors[ ] = { "WHITE", "RED", "GREEN", "YELLOW",
                               "BLUE", "BLACK", "DELETE" };
     long num_colors = ( long ) NUM_ELEMS( colors );
@@ -3489,19 +3433,19 @@ f_setmark_2d( Var_T * v )
 
     fsc2_assert( Fsc2_Internals.I_am == CHILD );
 
-    /* Now try to get a shared memory segment */
+    /* Now try to get a buffer in shared memory */
 
     len =   sizeof len + sizeof type + sizeof x_pos + sizeof y_pos
           + sizeof color + sizeof curve;
 
-    if ( ( buf = get_shm( &shm_id, len ) ) == NULL )
+    if ( ( buf = get_data_buffer( &db, len ) ) == NULL )
     {
         eprint( FATAL, false, "Internal communication problem at %s:%d.\n",
                 __FILE__, __LINE__ );
         THROW( EXCEPTION );
     }
 
-    /* Copy all data into the shared memory segment */
+    /* Copy all data into the shared memory buffer */
 
     ptr = buf;
 
@@ -3522,14 +3466,10 @@ f_setmark_2d( Var_T * v )
 
     memcpy( ptr, &curve, sizeof curve );
 
-    /* Detach from the segment with the data */
-
-    detach_shm( buf, NULL );
-
     /* Wait for parent to become ready to accept new data, then store
        identifier and send signal to tell it about them */
 
-    send_data( DATA_2D, shm_id );
+    send_data( DATA_2D, &db );
 
     /* All the rest has now to be done by the parent process... */
 
@@ -3587,7 +3527,7 @@ f_clearmark_1d( Var_T * v )
     void *buf;
     char *ptr;
     int type = D_CLEAR_MARKERS;
-    int shm_id;
+    Data_Buffer_T db;
 
 
     if ( Fsc2_Internals.cmdline_flags & NO_GUI_RUN )
@@ -3632,18 +3572,18 @@ f_clearmark_1d( Var_T * v )
 
     fsc2_assert( Fsc2_Internals.I_am == CHILD );
 
-    /* Now try to get a shared memory segment */
+    /* Now try to get a buffer in shared memory */
 
     len = sizeof len + sizeof type;
 
-    if ( ( buf = get_shm( &shm_id, len ) ) == NULL )
+    if ( ( buf = get_data_buffer( &db, len ) ) == NULL )
     {
         eprint( FATAL, false, "Internal communication problem at %s:%d.\n",
                 __FILE__, __LINE__ );
         THROW( EXCEPTION );
     }
 
-    /* Copy all data into the shared memory segment */
+    /* Copy all data into the shared memory buffer */
 
     ptr = buf;
 
@@ -3652,14 +3592,10 @@ f_clearmark_1d( Var_T * v )
 
     memcpy( ptr, &type, sizeof type );             /* type indicator  */
 
-    /* Detach from the segment with the data */
-
-    detach_shm( buf, NULL );
-
     /* Wait for parent to become ready to accept new data, then store
        identifier and send signal to tell it about them */
 
-    send_data( DATA_1D, shm_id );
+    send_data( DATA_1D, &db );
 
     /* All the rest has now to be done by the parent process... */
 
@@ -3678,7 +3614,7 @@ f_clearmark_2d( Var_T * v  UNUSED_ARG )
     void *buf;
     char *ptr;
     int type = D_CLEAR_MARKERS;
-    int shm_id;
+    Data_Buffer_T db;
     int i;
     long curves[ MAX_CURVES ] = { -1L, -1L, -1L, -1L };
 
@@ -3737,18 +3673,18 @@ f_clearmark_2d( Var_T * v  UNUSED_ARG )
 
     fsc2_assert( Fsc2_Internals.I_am == CHILD );
 
-    /* Now try to get a shared memory segment */
+    /* Now try to get a buffer in shared memory */
 
     len = sizeof len + sizeof type + sizeof curves;
 
-    if ( ( buf = get_shm( &shm_id, len ) ) == NULL )
+    if ( ( buf = get_data_buffer( &db, len ) ) == NULL )
     {
         eprint( FATAL, false, "Internal communication problem at %s:%d.\n",
                 __FILE__, __LINE__ );
         THROW( EXCEPTION );
     }
 
-    /* Copy all data into the shared memory segment */
+    /* Copy all data into the shared memory buffer */
 
     ptr = buf;
 
@@ -3760,14 +3696,10 @@ f_clearmark_2d( Var_T * v  UNUSED_ARG )
 
     memcpy( ptr, curves, sizeof curves );
 
-    /* Detach from the segment with the data */
-
-    detach_shm( buf, NULL );
-
     /* Wait for parent to become ready to accept new data, then store
        identifier and send signal to tell it about them */
 
-    send_data( DATA_2D, shm_id );
+    send_data( DATA_2D, &db );
 
     /* All the rest has now to be done by the parent process... */
 
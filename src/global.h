@@ -522,7 +522,12 @@ enum {
     TEST_ONLY     = ( 1 <<  9 ),
     NO_GUI_RUN    = ( 1 << 10 ),
     ICONIFIED_RUN = ( 1 << 11 ),
-    LOCAL_EXEC    = ( 1 << 12 )
+    LOCAL_EXEC    = ( 1 << 12 ),
+    NO_BYTECODE   = ( 1 << 13 ),
+    DUMP_BYTECODE = ( 1 << 14 ),
+    DO_PROFILE    = ( 1 << 15 ),
+    FORCE_TEST    = ( 1 << 16 ),
+    DO_RESUME     = ( 1 << 17 )
 };
 
 
@@ -49,6 +49,7 @@ static void cut_canvas_off( Canvas_T  * c,
 static int cut_form_close_handler( FL_FORM * a,
                                    void    * b );
 static void cut_recalc_XPoints( void );
+static void cut_fs_y_scale( long curve );
 static void cut_integrate_point( long   p_index,
                                  double val );
 static int cut_canvas_handler( FL_OBJECT * obj,
@@ -84,6 +85,8 @@ static bool cut_zoom_x( Canvas_T * c );
 static bool cut_zoom_y( Canvas_T * c );
 static bool cut_zoom_xy( Canvas_T * c );
 static void cut_save_scale_state( void );
+static double * cut_column_points( void );
+static void cut_drop_columns( void );
 
 
 extern FL_resource Xresources[ ];
@@ -99,6 +102,19 @@ static struct {
 static bool is_mapped = false;           /* set while form is mapped */
 
 
+/* The rows of a 2D curve are contiguous in memory but its columns are not,
+   so for cuts in X direction a copy of the curve shown in the cut window
+   with the points of each column stored one after another is kept, which
+   gets updated when new points arrive and only rebuilt when it became too
+   small (or the curve or the scaling of its points changed) */
+
+static double * Col_points = NULL;
+static long Col_stride;                 /* rows 'Col_points' has room for */
+static long Col_width;                  /* columns it has room for */
+static long Col_curve = -1;             /* curve it's for, -1 if invalid */
+static bool Col_is_scaled;              /* if points were already scaled */
+
+
 /*--------------------------------------------------------------------*
  * Function to initialize the minimum sizes of the cut graphic window
  *--------------------------------------------------------------------*/
@@ -443,6 +459,12 @@ G_init_cut_curve( void )
 
     cv->points = NULL;
     cv->xpoints = NULL;
+    cv->xp_ref = NULL;
+    cv->start = 0;
+    cv->needs_recalc = false;
+    cv->xp_count = 0;
+    cv->lod = NULL;
+    cv->lod_size = 0;
 
     /* Create a GC for drawing the curve and set its colour */
 
@@ -544,6 +566,8 @@ cut_form_close( void )
     int i;
 
 
+    cut_drop_columns( );
+
     if ( ! G_cut.is_shown )
         return;
 
@@ -616,6 +640,7 @@ cut_close_callback( FL_OBJECT * a  UNUSED_ARG,
     fl_hide_form( GUI.cut_form->cut );
 
     G_2d.is_cut = is_mapped = false;
+    cut_drop_columns( );
 
     for ( i = 0; i < MAX_CURVES; i++ )
         G_cut.has_been_shown[ i ] = false;
@@ -633,10 +658,8 @@ cut_calc_curve( int  dir,
                 long p_index,
                 bool has_been_shown )
 {
-    long i;
     Curve_1d_T *cv = &G_2d.cut_curve;
     Curve_2d_T *scv = G_2d.curve_2d[ G_2d.active_curve ];
-    Scaled_Point_T *sp, *ssp;
     Marker_2d_T *m;
 
 
@@ -658,11 +681,10 @@ cut_calc_curve( int  dir,
         {
             G_cut.s2d[ G_2d.active_curve ][ X ] = cv->s2d[ X ] =
                                 ( G_2d.cut_canvas.w - 1.0 ) / ( G_cut.nx - 1 );
-            G_cut.s2d[ G_2d.active_curve ][ Y ] = cv->s2d[ Y ] =
-                                                       G_2d.cut_canvas.h - 1.0;
-            G_cut.shift[ G_2d.active_curve ][ X ] =
-                                   G_cut.shift[ G_2d.active_curve ][ Y ] =
-                                         cv->shift[ X ] = cv->shift[ Y ] = 0.0;
+            G_cut.shift[ G_2d.active_curve ][ X ] = cv->shift[ X ] = 0.0;
+            cut_fs_y_scale( G_2d.active_curve );
+            cv->s2d[ Y ] = G_cut.s2d[ G_2d.active_curve ][ Y ];
+            cv->shift[ Y ] = G_cut.shift[ G_2d.active_curve ][ Y ];
 
             G_cut.is_fs[ G_2d.active_curve ] = true;
             fl_set_button( GUI.cut_form->cut_full_scale_button, 1 );
@@ -711,11 +733,10 @@ cut_calc_curve( int  dir,
     {
         G_cut.s2d[ G_2d.active_curve ][ X ] =  cv->s2d[ X ] =
                                 ( G_2d.cut_canvas.w - 1.0 ) / ( G_cut.nx - 1 );
-        G_cut.s2d[ G_2d.active_curve ][ Y ] = cv->s2d[ Y ] =
-                                                       G_2d.cut_canvas.h - 1.0;
-        G_cut.shift[ G_2d.active_curve ][ X ] =
-                                   G_cut.shift[ G_2d.active_curve ][ Y ]
-                                       = cv->shift[ X ] = cv->shift[ Y ] = 0.0;
+        G_cut.shift[ G_2d.active_curve ][ X ] = cv->shift[ X ] = 0.0;
+        cut_fs_y_scale( G_2d.active_curve );
+        cv->s2d[ Y ] = G_cut.s2d[ G_2d.active_curve ][ Y ];
+        cv->shift[ Y ] = G_cut.shift[ G_2d.active_curve ][ Y ];
     }
 
     /* If the index is reasonable store it (if called with an index smaller
@@ -728,28 +749,17 @@ cut_calc_curve( int  dir,
 
     cv->points = T_realloc( cv->points, G_cut.nx * sizeof *cv->points );
     cv->xpoints = T_realloc( cv->xpoints, G_cut.nx * sizeof *cv->xpoints );
+    cv->xp_ref = T_realloc( cv->xp_ref, G_cut.nx * sizeof *cv->xp_ref );
 
-    /* Extract the existing scaled data of the cut from the 2d curve */
+    /* Extract the existing scaled data of the cut from the 2d curve (non-
+       existing points are NaNs in both) */
 
     if ( G_cut.cut_dir == X )
-    {
-        for ( i = 0, sp = cv->points, ssp = scv->points + G_cut.index;
-              i < G_cut.nx; ssp += G_2d.nx, sp++, i++ )
-            if ( ssp->exist )
-                memcpy( sp, ssp, sizeof *sp );
-            else
-                sp->exist = false;
-    }
+        memcpy( cv->points, cut_column_points( ) + G_cut.index * Col_stride,
+                G_cut.nx * sizeof *cv->points );
     else
-    {
-        for ( i = 0, sp = cv->points,
-              ssp = scv->points + G_cut.index * G_2d.nx;
-              i < G_cut.nx; ssp++, sp++, i++ )
-            if ( ssp->exist )
-                memcpy( sp, ssp, sizeof *sp );
-            else
-                sp->exist = false;
-    }
+        memcpy( cv->points, scv->points + G_cut.index * G_2d.nx_max,
+                G_cut.nx * sizeof *cv->points );
 
     delete_all_cut_markers( false );
 
@@ -777,7 +787,7 @@ cut_recalc_XPoints( void )
 {
     long k, j;
     Curve_1d_T *cv = &G_2d.cut_curve;
-    Scaled_Point_T *sp = cv->points;
+    double *sp = cv->points;
     XPoint *xp = cv->xpoints;
 
 
@@ -785,13 +795,13 @@ cut_recalc_XPoints( void )
 
     for ( k = j = 0; j < G_cut.nx; sp++, j++ )
     {
-        if ( ! sp->exist )
+        if ( ! POINT_EXISTS( *sp ) )
             continue;
 
         xp->x = s15rnd( cv->s2d[ X ] * ( j + cv->shift[ X ] ) );
         xp->y = i2s15( G_2d.cut_canvas.h ) - 1 -
-               s15rnd( cv->s2d[ Y ] * ( cv->points[ j ].v + cv->shift[ Y ] ) );
-        sp->xp_ref = k;
+               s15rnd( cv->s2d[ Y ] * ( cv->points[ j ] + cv->shift[ Y ] ) );
+        cv->xp_ref[ j ] = k;
 
         cv->left  |= ( xp->x < 0 );
         cv->right |= ( xp->x >= ( int ) G_2d.cut_canvas.w );
@@ -806,6 +816,32 @@ cut_recalc_XPoints( void )
 }
 
 
+/*-------------------------------------------------------------*
+ * Sets the y-scaling of the cut through a curve for full scale
+ * mode, i.e. so that the range between the minimum and maximum
+ * of all data of the 2d curve fills the height of the canvas.
+ *-------------------------------------------------------------*/
+
+static void
+cut_fs_y_scale( long curve )
+{
+    Curve_2d_T *scv = G_2d.curve_2d[ curve ];
+
+
+    if ( ! scv->is_scale_set )
+    {
+        G_cut.s2d[ curve ][ Y ] = G_2d.cut_canvas.h - 1.0;
+        G_cut.shift[ curve ][ Y ] = 0.0;
+        return;
+    }
+
+    G_cut.s2d[ curve ][ Y ] = ( G_2d.cut_canvas.h - 1.0 ) * scv->rwc_delta[ Z ]
+                              / ( scv->rw_max - scv->rw_min );
+    G_cut.shift[ curve ][ Y ] = ( scv->rwc_start[ Z ] - scv->rw_min )
+                                / scv->rwc_delta[ Z ];
+}
+
+
 /*------------------------------------------------------*
  * Called whenever a different curve is to be displayed
  *------------------------------------------------------*/
@@ -845,6 +881,7 @@ cut_new_curve_handler( void )
         G_cut.curve = -1;
         cv->points = T_free( cv->points );
         cv->xpoints = T_free( cv->xpoints );
+        cv->xp_ref = T_free( cv->xp_ref );
         cv->count = 0;
     }
     else
@@ -908,85 +945,64 @@ cut_new_curve_handler( void )
 
 
 /*---------------------------------------------------------------------------*
- * Function is called by accept_2d_data() whenever the z-scaling has changed
- * and thus also the y-scaling of the cut curve
+ * Function is called by accept_2d_data() whenever the minimum or maximum
+ * of the data of a 2d curve has changed. The scaled data of the curve stay
+ * unchanged (unless they just got scaled for the first time), so only in
+ * full scale mode the y-scaling of the cut curve needs to be adjusted.
  *---------------------------------------------------------------------------*/
 
 bool
-cut_data_rescaled( long   curve,
-                   double y_min,
-                   double y_max )
+cut_data_rescaled( long curve )
 {
     long i;
     Curve_1d_T *cv  = &G_2d.cut_curve;
     Curve_2d_T *scv = G_2d.curve_2d[ G_2d.active_curve ];
-    Scaled_Point_T *sp, *ssp;
+    double *sp, *ssp;
 
 
     if ( ! G_2d.is_cut )
         return false;
 
-    if ( ! G_cut.is_fs[ curve ] )
+    if ( G_cut.is_fs[ curve ] )
     {
-        /* Calculate s2d[ Y ] and shift[ Y ] to fit the new scaling */
-
-        G_cut.s2d[ curve ][ Y ] *=
-                    ( y_max - y_min ) / G_2d.curve_2d[ curve ]->rwc_delta[ Z ];
-        G_cut.shift[ curve ][ Y ] = ( G_2d.curve_2d[ curve ]->rwc_delta[ Z ]
-                                      * G_cut.shift[ curve ][ Y ]
-                                      - G_2d.curve_2d[ curve ]->rwc_start[ Z ]
-                                      + y_min ) / ( y_max - y_min );
-
-        if ( G_cut.can_undo[ curve ] )
-        {
-            G_cut.old_s2d[ curve ][ Y ] *=
-                    ( y_max - y_min ) / G_2d.curve_2d[ curve ]->rwc_delta[ Z ];
-            G_cut.old_shift[ curve ][ Y ] =
-                           ( G_2d.curve_2d[ curve ]->rwc_delta[ Z ]
-                             * G_cut.old_shift[ curve ][ Y ]
-                             - G_2d.curve_2d[ curve ]->rwc_start[ Z ] + y_min )
-                           / ( y_max - y_min );
-        }
+        cut_fs_y_scale( curve );
 
         if ( curve == G_2d.active_curve )
         {
             cv->s2d[ Y ] = G_cut.s2d[ curve ][ Y ];
             cv->shift[ Y ] = G_cut.shift[ curve ][ Y ];
-
-            if ( G_cut.can_undo[ curve ] )
-            {
-                cv->old_s2d[ Y ] = G_cut.old_s2d[ curve ][ Y ];
-                cv->old_shift[ Y ] = G_cut.old_shift[ curve ][ Y ];
-            }
         }
     }
 
     if ( curve != G_2d.active_curve )
         return false;
 
-    /* Extract the rescaled data of the cut from the 2d curve */
+    /* Extract the (possibly just scaled) data of the cut from the 2d curve */
 
     if ( G_cut.cut_dir == X )
     {
-        for ( i = 0, sp = cv->points, ssp = scv->points + G_cut.index;
-              i < G_cut.nx; ssp += G_2d.nx, sp++, i++ )
-            if ( ssp->exist )
+        for ( i = 0, sp = cv->points,
+              ssp = cut_column_points( ) + G_cut.index * Col_stride;
+              i < G_cut.nx; ssp++, sp++, i++ )
+            if ( POINT_EXISTS( *ssp ) )
             {
-                sp->v = ssp->v;
-                cv->xpoints[ sp->xp_ref ].y = i2s15( G_2d.cut_canvas.h ) - 1
-                         - s15rnd( cv->s2d[ Y ] * ( sp->v + cv->shift[ Y ] ) );
+                *sp = *ssp;
+                cv->xpoints[ cv->xp_ref[ i ] ].y =
+                                           i2s15( G_2d.cut_canvas.h ) - 1
+                         - s15rnd( cv->s2d[ Y ] * ( *sp + cv->shift[ Y ] ) );
             }
     }
     else
     {
         for ( i = 0, sp = cv->points,
-              ssp = scv->points + G_cut.index * G_2d.nx;
+              ssp = scv->points + G_cut.index * G_2d.nx_max;
               i < G_cut.nx; ssp++, sp++, i++ )
-            if ( ssp->exist )
+            if ( POINT_EXISTS( *ssp ) )
             {
-                sp->v = ssp->v;
-                cv->xpoints[ sp->xp_ref ].y = i2s15( G_2d.cut_canvas.h ) - 1
-                         - s15rnd( cv->s2d[ Y ] * ( sp->v + cv->shift[ Y ] ) );
+                *sp = *ssp;
+                cv->xpoints[ cv->xp_ref[ i ] ].y =
+                                           i2s15( G_2d.cut_canvas.h ) - 1
+                         - s15rnd( cv->s2d[ Y ] * ( *sp + cv->shift[ Y ] ) );
             }
     }
 
@@ -1010,7 +1026,7 @@ cut_num_points_changed( int  dir,
                         long num_points )
 {
     Curve_1d_T *cv = &G_2d.cut_curve;
-    Scaled_Point_T *sp;
+    double *sp;
     long k;
 
 
@@ -1024,11 +1040,12 @@ cut_num_points_changed( int  dir,
 
     cv->points = T_realloc( cv->points, num_points * sizeof *cv->points );
     cv->xpoints = T_realloc( cv->xpoints, num_points * sizeof *cv->xpoints );
+    cv->xp_ref = T_realloc( cv->xp_ref, num_points * sizeof *cv->xp_ref );
 
     /* The new entries are not set yet */
 
     for ( k = G_cut.nx, sp = cv->points + k; k < num_points; sp++, k++ )
-        sp->exist = false;
+        *sp = NO_POINT;
 
     /* In full scale mode the x-axis scale must be reset and all points need to
        be rescaled */
@@ -1041,8 +1058,8 @@ cut_num_points_changed( int  dir,
                               ( G_2d.cut_canvas.w - 1.0 ) / ( num_points - 1 );
 
         for ( sp = cv->points, k = 0; k < G_cut.nx; sp++, k++ )
-            if ( sp->exist )
-                cv->xpoints[ sp->xp_ref ].x = s15rnd( cv->s2d[ X ] * k );
+            if ( POINT_EXISTS( *sp ) )
+                cv->xpoints[ cv->xp_ref[ k ] ].x = s15rnd( cv->s2d[ X ] * k );
     }
 
     /* Signal calling routine that redraw of cut curve is needed */
@@ -1064,12 +1081,34 @@ cut_new_points( long curve,
                 long y_index,
                 long len )
 {
-    Scaled_Point_T *sp;
+    double *sp;
     long p_index;
 
 
-    /* Nothing to be done if either the cross section isn't drawn or the new
-       points don't belong to the curve currently shown */
+    /* Update the column-wise copy of the curve if there's room for the new
+       points, otherwise it must be rebuilt when it's needed the next time.
+       This must also be done when the curve isn't the one currently shown,
+       it may become the active curve again later. */
+
+    if ( Col_curve == curve )
+    {
+        if (    x_index + len <= Col_width
+             && y_index < Col_stride
+             && Col_is_scaled == G_2d.curve_2d[ curve ]->is_scale_set )
+        {
+            double *cp = Col_points + x_index * Col_stride + y_index;
+
+            sp = G_2d.curve_2d[ curve ]->points + y_index * G_2d.nx_max
+                 + x_index;
+            for ( p_index = 0; p_index < len; cp += Col_stride, p_index++ )
+                *cp = *sp++;
+        }
+        else
+            Col_curve = -1;
+    }
+
+    /* Nothing else to be done if either the cross section isn't drawn or
+       the new points don't belong to the curve currently shown */
 
     if ( ! G_2d.is_cut || G_cut.curve == -1 || curve != G_2d.active_curve )
         return false;
@@ -1084,8 +1123,9 @@ cut_new_points( long curve,
         if ( x_index > G_cut.index || x_index + len <= G_cut.index )
             return false;
 
-        sp = G_2d.curve_2d[ curve ]->points + y_index * G_2d.nx + G_cut.index;
-        cut_integrate_point( y_index, sp->v );
+        sp =   G_2d.curve_2d[ curve ]->points + y_index * G_2d.nx_max
+             + G_cut.index;
+        cut_integrate_point( y_index, *sp );
     }
     else
     {
@@ -1094,9 +1134,9 @@ cut_new_points( long curve,
 
         /* All new points are on the cut */
 
-        sp = G_2d.curve_2d[ curve ]->points + y_index * G_2d.nx + x_index;
+        sp = G_2d.curve_2d[ curve ]->points + y_index * G_2d.nx_max + x_index;
         for ( p_index = x_index; p_index < x_index + len; sp++, p_index++ )
-            cut_integrate_point( p_index, sp->v );
+            cut_integrate_point( p_index, *sp );
     }
 
     /* Signal calling routine that a redraw of the cut curve is needed */
@@ -1113,46 +1153,51 @@ cut_integrate_point( long   p_index,
                      double val )
 {
     Curve_1d_T *cv = &G_2d.cut_curve;
-    Scaled_Point_T *cvp;
+    double *cvp;
     long xp_index;
     long i, j;
 
 
+    /* A NaN (i.e. a point that got removed from the 2D curve) is not shown
+       in the cut */
+
+    if ( ! POINT_EXISTS( val ) )
+        return;
+
     /* If this is a completely new point integrate it into the array of
        XPoints (which have to be sorted in ascending order of the
        x-coordinate), otherwise the XPoint just needs to be updated */
 
-    if ( ! cv->points[ p_index ].exist )
+    if ( ! POINT_EXISTS( cv->points[ p_index ] ) )
     {
         /* Find next existing point to the left */
 
-        for ( i = p_index - 1, cvp = cv->points + i; i >= 0 && ! cvp->exist;
-              cvp--, i-- )
+        for ( i = p_index - 1, cvp = cv->points + i;
+              i >= 0 && ! POINT_EXISTS( *cvp ); cvp--, i-- )
             /* empty */ ;
 
         if ( i == -1 )                    /* new points to be drawn is first */
         {
-            xp_index = cv->points[ p_index ].xp_ref = 0;
+            xp_index = cv->xp_ref[ p_index ] = 0;
             memmove( cv->xpoints + 1, cv->xpoints,
                      cv->count * sizeof *cv->xpoints );
             for ( cvp = cv->points + 1, j = 1; j < G_cut.nx; cvp++, j++ )
-                if ( cvp->exist )
-                    cvp->xp_ref++;
+                if ( POINT_EXISTS( *cvp ) )
+                    cv->xp_ref[ j ]++;
         }
-        else if ( cv->points[ i ].xp_ref == cv->count - 1 )    /* ...is last */
+        else if ( cv->xp_ref[ i ] == cv->count - 1 )           /* ...is last */
         {
-            xp_index = cv->points[ p_index ].xp_ref = cv->count;
+            xp_index = cv->xp_ref[ p_index ] = cv->count;
         }
         else                                             /* ...is in between */
         {
-            xp_index = cv->points[ p_index ].xp_ref =
-                                                    cv->points[ i ].xp_ref + 1;
+            xp_index = cv->xp_ref[ p_index ] = cv->xp_ref[ i ] + 1;
             memmove( cv->xpoints + xp_index + 1, cv->xpoints + xp_index,
                      ( cv->count - xp_index ) * sizeof *cv->xpoints );
             for ( j = p_index + 1, cvp = cv->points + j; j < G_cut.nx;
                   cvp++, j++ )
-                if ( cvp->exist )
-                    cvp->xp_ref++;
+                if ( POINT_EXISTS( *cvp ) )
+                    cv->xp_ref[ j ]++;
         }
 
         /* Calculate the x-coordinate of the new point and figure out if it
@@ -1168,23 +1213,22 @@ cut_integrate_point( long   p_index,
         /* Increment the number of points belonging to the cut */
 
         cv->count++;
-        cv->points[ p_index ].exist = true;
     }
     else
     {
-        xp_index = cv->points[ p_index ].xp_ref;
+        xp_index = cv->xp_ref[ p_index ];
     }
 
     /* Store the (new) points value */
 
-    cv->points[ p_index ].v = val;
+    cv->points[ p_index ] = val;
 
     /* Calculate the y-coordinate of the (new) point and figure out if it
        exceeds the borders of the canvas */
 
     cv->xpoints[ xp_index ].y = i2s15( G_2d.cut_canvas.h ) - 1
                               - s15rnd( cv->s2d[ Y ]
-                              * ( cv->points[ p_index ].v + cv->shift[ Y ] ) );
+                              * ( cv->points[ p_index ] + cv->shift[ Y ] ) );
 
     if ( cv->xpoints[ xp_index ].y < 0 )
         cv->up = true;
@@ -1990,6 +2034,7 @@ redraw_cut_canvas( Canvas_T * c )
 
     /* Clear the canvas by drawing over its pixmap in the background color */
 
+    dump_window_changed( 3 );
     XFillRectangle( G.d, c->pm, c->gc, 0, 0, c->w, c->h );
 
     /* For the main canvas draw the markers, then the curve and finally the
@@ -2661,7 +2706,7 @@ shift_XPoints_of_cut_curve( Canvas_T * c )
 
     for ( k = 0, j = 0; j < G_cut.nx; j++ )
     {
-        if ( ! cv->points[ j ].exist )
+        if ( ! POINT_EXISTS( cv->points[ j ] ) )
             continue;
 
         cv->xpoints[ k ].x = i2s15( cv->xpoints[ k ].x + dx );
@@ -2950,6 +2995,74 @@ cut_save_scale_state( void )
 }
 
 
+/*------------------------------------------------------------------*
+ * Returns the column-wise copy of the curve shown in the cut window
+ * (the points of column 'x' start at index 'x * Col_stride'), which
+ * gets (re)built from the 2D curve if necessary.
+ *------------------------------------------------------------------*/
+
+static double *
+cut_column_points( void )
+{
+    Curve_2d_T *scv = G_2d.curve_2d[ G_2d.active_curve ];
+    double *cp;
+    double *sp;
+    long x, y;
+
+
+    if (    Col_curve == G_2d.active_curve
+         && Col_width >= G_2d.nx
+         && Col_stride >= G_2d.ny
+         && Col_is_scaled == scv->is_scale_set )
+        return Col_points;
+
+    /* Make it as large as the 2D curve (which grows geometrically), so it
+       rarely will have to be rebuilt when new points arrive */
+
+    Col_curve = -1;
+    Col_points = T_realloc( Col_points,
+                            G_2d.nx_max * G_2d.ny_max * sizeof *Col_points );
+    Col_width = G_2d.nx_max;
+    Col_stride = G_2d.ny_max;
+
+    for ( y = 0; y < G_2d.ny_max; y++ )
+        for ( x = 0, sp = scv->points + y * G_2d.nx_max, cp = Col_points + y;
+              x < G_2d.nx_max; cp += Col_stride, sp++, x++ )
+            *cp = *sp;
+
+    Col_curve = G_2d.active_curve;
+    Col_is_scaled = scv->is_scale_set;
+
+    return Col_points;
+}
+
+
+/*----------------------------------------------------------------*
+ * Releases the column-wise copy of the curve shown in the cut
+ * window, it can't be kept up to date while the window is closed
+ *----------------------------------------------------------------*/
+
+static void
+cut_drop_columns( void )
+{
+    Col_points = T_free( Col_points );
+    Col_curve = -1;
+}
+
+
+/*-------------------------------------------------------------------*
+ * Must be called whenever points of a 2D curve got changed in place
+ * (e.g. on full scale rescaling), so the column-wise copy will get
+ * rebuilt from the curve when it's needed the next time
+ *-------------------------------------------------------------------*/
+
+void
+cut_invalidate_columns( void )
+{
+    Col_curve = -1;
+}
+
+
 /*----------------------------------------------------------*
  *----------------------------------------------------------*/
 
@@ -2957,14 +3070,17 @@ void
 cut_clear_curve( long curve )
 {
     long i;
-    Scaled_Point_T *sp;
+    double *sp;
+
 
+    if ( curve == Col_curve )
+        Col_curve = -1;
 
     if ( ! G_2d.is_cut || curve != G_2d.active_curve )
         return;
 
     for ( sp = G_2d.cut_curve.points, i = 0; i < G_cut.nx; sp++, i++ )
-        sp->exist = false;
+        *sp = NO_POINT;
     G_2d.cut_curve.count = 0;
 }
 
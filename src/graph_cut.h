@@ -74,9 +74,7 @@ void cut_init( void );
 void cut_show( int  /* dir     */,
                long /* u_index */  );
 
-bool cut_data_rescaled( long   /* curve */,
-                        double /* y_min */,
-                        double /* y_max */  );
+bool cut_data_rescaled( long /* curve */ );
 
 bool cut_num_points_changed( int  /* dir        */,
                              long /* num_points */  );
@@ -96,6 +94,8 @@ void cut_form_close( void );
 
 void cut_clear_curve( long /* curve */ );
 
+void cut_invalidate_columns( void );
+
 void set_cut_marker( long /* x_pos */,
                      long /* color */  );
 
@@ -24,6 +24,13 @@
 Graphics_1d_T G_1d;
 
 
+/* Minimum number of points per pixel column at which, instead of all points
+   of a curve, only the minimum and maximum of the points in each column get
+   drawn */
+
+#define LOD_MIN_POINTS_PER_PIXEL   4
+
+
 static void press_handler_1d( FL_OBJECT * obj,
                               Window      window,
                               XEvent    * ev,
@@ -48,6 +55,19 @@ static void reconfigure_window_1d( Canvas_T * c,
                                    int        w,
                                    int        h );
 static void recalc_XPoints_1d( void );
+static bool use_lod_1d( Curve_1d_T * cv );
+static void recalc_lod_XPoints_of_curve_1d( Curve_1d_T * cv );
+static void lod_build_1d( Curve_1d_T * cv );
+static void lod_range_1d( Curve_1d_T * cv,
+                          long         a,
+                          long         b,
+                          double     * min,
+                          double     * max );
+static void lod_phys_range_1d( Curve_1d_T * cv,
+                               long         a,
+                               long         b,
+                               double     * min,
+                               double     * max );
 static void delete_marker_1d( long x_pos );
 
 
@@ -738,7 +758,7 @@ user_zoom_1d( double x,
             cv->s2d[ X ] = ( G_1d.canvas.w - 1 ) / --xw;
 
         if ( ! keep_y )
-            cv->shift[ Y ] = ( G_1d.rw_min - y ) / G_1d.rwc_delta[ Y ];
+            cv->shift[ Y ] = ( G_1d.rwc_start[ Y ] - y ) / G_1d.rwc_delta[ Y ];
 
         if ( ! keep_yw )
             cv->s2d[ Y ] = G_1d.rwc_delta[ Y ] * ( G_1d.canvas.h - 1 ) / yw;
@@ -995,7 +1015,6 @@ static bool
 shift_XPoints_of_curve_1d( Canvas_T   * c,
                            Curve_1d_T * cv )
 {
-    long j, k;
     int dx = 0,
         dy = 0;
     int factor;
@@ -1025,26 +1044,30 @@ shift_XPoints_of_curve_1d( Canvas_T   * c,
         }
     }
 
+    /* If only the minima and maxima per pixel column are drawn the columns
+       that have been moved into the canvas would be wrong, recalculate */
+
+    if ( use_lod_1d( cv ) )
+    {
+        recalc_XPoints_of_curve_1d( cv );
+        return true;
+    }
+
     /* Add the shifts to the XPoints */
 
-    for ( k = 0, j = 0; j < G_1d.nx; j++ )
+    for ( long k = 0; k < cv->xp_count; k++ )
     {
-        if ( cv->points[ j ].exist )
-        {
-            cv->xpoints[ k ].x = i2s15( cv->xpoints[ k ].x + dx );
-            cv->xpoints[ k ].y = i2s15( cv->xpoints[ k ].y + dy );
-
-            if ( cv->xpoints[ k ].x < 0 )
-                cv->left = true;
-            if ( cv->xpoints[ k ].x >= ( int ) G_1d.canvas.w )
-                cv->right = true;
-            if ( cv->xpoints[ k ].y < 0 )
-                cv->up = true;
-            if ( cv->xpoints[ k ].y >= ( int ) G_1d.canvas.h )
-                cv->down = true;
-
-            k++;
-        }
+        cv->xpoints[ k ].x = i2s15( cv->xpoints[ k ].x + dx );
+        cv->xpoints[ k ].y = i2s15( cv->xpoints[ k ].y + dy );
+
+        if ( cv->xpoints[ k ].x < 0 )
+            cv->left = true;
+        if ( cv->xpoints[ k ].x >= ( int ) G_1d.canvas.w )
+            cv->right = true;
+        if ( cv->xpoints[ k ].y < 0 )
+            cv->up = true;
+        if ( cv->xpoints[ k ].y >= ( int ) G_1d.canvas.h )
+            cv->down = true;
     }
 
     return true;
@@ -1191,17 +1214,32 @@ recalc_XPoints_of_curve_1d( Curve_1d_T * cv )
 {
     cv->up = cv->down = cv->left = cv->right = false;
 
-    Scaled_Point_T * sp = cv->points;
+    if ( use_lod_1d( cv ) )
+    {
+        recalc_lod_XPoints_of_curve_1d( cv );
+        cv->needs_recalc = false;
+        return;
+    }
+
+    /* The j-th point is stored at index 'k', which is different from 'j'
+       only in sliding window mode, where the points form a ring buffer */
+
     XPoint * xp = cv->xpoints;
+    long k = cv->start;
 
-    for ( long j = 0; j < G_1d.nx; sp++, j++ )
+    for ( long j = 0; j < G_1d.nx; j++ )
     {
-        if ( ! sp->exist )
+        double point = cv->points[ k ];
+
+        if ( ++k == G_1d.nx )
+            k = 0;
+
+        if ( ! POINT_EXISTS( point ) )
             continue;
 
         xp->x = s15rnd( cv->s2d[ X ] * ( j + cv->shift[ X ] ) );
         xp->y = s15rnd( G_1d.canvas.h - 1 - cv->s2d[ Y ]
-                        * ( cv->points[ j ].v + cv->shift[ Y ] ) );
+                        * ( point + cv->shift[ Y ] ) );
 
         cv->left  |= xp->x < 0;
         cv->right |= xp->x >= ( int ) G_1d.canvas.w;
@@ -1210,6 +1248,267 @@ recalc_XPoints_of_curve_1d( Curve_1d_T * cv )
 
         xp++;
     }
+
+    cv->xp_count = xp - cv->xpoints;
+    cv->needs_recalc = false;
+}
+
+
+/*------------------------------------------------------------------*
+ * Returns if there are that many points per pixel column that it's
+ * enough to draw their minima and maxima (the XPoints arrays must
+ * be large enough to hold two points for each column of the canvas
+ * and the columns left and right of it).
+ *------------------------------------------------------------------*/
+
+static bool
+use_lod_1d( Curve_1d_T * cv )
+{
+    return    cv->s2d[ X ] > 0.0
+           && cv->s2d[ X ] * LOD_MIN_POINTS_PER_PIXEL <= 1.0
+           && 2 * ( ( long ) G_1d.canvas.w + 2 ) <= G_1d.nx;
+}
+
+
+/*-----------------------------------------------------------------------*
+ * Recalculates the graphic data for a curve from the minimum and maximum
+ * of the points in each pixel column. These are found via the curves
+ * min/max pyramid, so the time needed depends on the width of the canvas
+ * and only logarithmically on the number of points. All points left and
+ * right of the canvas are treated as if they were in the column directly
+ * next to it.
+ *-----------------------------------------------------------------------*/
+
+static void
+recalc_lod_XPoints_of_curve_1d( Curve_1d_T * cv )
+{
+    XPoint * xp = cv->xpoints;
+    long j_start = 0;
+
+
+    if ( cv->lod_size < G_1d.nx )
+        lod_build_1d( cv );
+
+    for ( int px = -1; px <= ( int ) G_1d.canvas.w; px++ )
+    {
+        /* Find the range of points that end up in the column */
+
+        long j_end = G_1d.nx;
+
+        if ( px < ( int ) G_1d.canvas.w )
+        {
+            double e = ceil( ( px + 0.5 ) / cv->s2d[ X ] - cv->shift[ X ] );
+            j_end = lrnd( d_min( d_max( e, 0.0 ), G_1d.nx ) );
+        }
+
+        if ( j_end <= j_start )
+            continue;
+
+        double min,
+               max;
+
+        lod_range_1d( cv, j_start, j_end, &min, &max );
+        j_start = j_end;
+
+        if ( ! POINT_EXISTS( min ) )
+            continue;
+
+        short y_min = s15rnd( G_1d.canvas.h - 1 - cv->s2d[ Y ]
+                              * ( min + cv->shift[ Y ] ) );
+        short y_max = s15rnd( G_1d.canvas.h - 1 - cv->s2d[ Y ]
+                              * ( max + cv->shift[ Y ] ) );
+
+        cv->left  |= px < 0;
+        cv->right |= px >= ( int ) G_1d.canvas.w;
+        cv->up    |= y_max < 0;
+        cv->down  |= y_min >= ( int ) G_1d.canvas.h;
+
+        /* Start with the extremum nearer to the previous point to avoid
+           drawing an extra line through the whole column */
+
+        if (    xp > cv->xpoints
+             &&   abs( xp[ -1 ].y - y_max ) < abs( xp[ -1 ].y - y_min ) )
+        {
+            short tmp = y_min;
+            y_min = y_max;
+            y_max = tmp;
+        }
+
+        xp->x = px;
+        xp++->y = y_min;
+
+        if ( y_max != y_min )
+        {
+            xp->x = px;
+            xp++->y = y_max;
+        }
+    }
+
+    cv->xp_count = xp - cv->xpoints;
+}
+
+
+/*-----------------------------------------------------------------------*
+ * (Re)builds the min/max pyramid of a curve: the first level contains
+ * minimum and maximum of each pair of points, each following level the
+ * minima and maxima of pairs of blocks of the previous level. Its size
+ * is rounded up to a power of 2, so it can stay in use while the number
+ * of points in normal display mode grows (the points beyond the end are
+ * unset). NaNs for unset points are dropped by fmin() and fmax().
+ *-----------------------------------------------------------------------*/
+
+static void
+lod_build_1d( Curve_1d_T * cv )
+{
+    long size = 1;
+
+
+    while ( size < G_1d.nx )
+        size <<= 1;
+
+    cv->lod = T_realloc( cv->lod, 2 * size * sizeof *cv->lod );
+    cv->lod_size = size;
+
+    double * lp = cv->lod;
+
+    for ( long i = 0; i < size; i += 2 )
+    {
+        double p0 = i < G_1d.nx ? cv->points[ i ] : NO_POINT;
+        double p1 = i + 1 < G_1d.nx ? cv->points[ i + 1 ] : NO_POINT;
+
+        *lp++ = fmin( p0, p1 );
+        *lp++ = fmax( p0, p1 );
+    }
+
+    for ( long nb = size >> 2; nb > 0; nb >>= 1 )
+    {
+        double * prev = lp - 4 * nb;
+
+        for ( long i = 0; i < nb; prev += 4, i++ )
+        {
+            *lp++ = fmin( prev[ 0 ], prev[ 2 ] );
+            *lp++ = fmax( prev[ 1 ], prev[ 3 ] );
+        }
+    }
+}
+
+
+/*----------------------------------------------------------------------*
+ * Updates the min/max pyramid of a curve after the point at (physical)
+ * index 'index' has been set or unset. If the pyramid doesn't cover the
+ * point it's marked as in need of rebuilding.
+ *----------------------------------------------------------------------*/
+
+void
+lod_point_changed_1d( Curve_1d_T * cv,
+                      long         index )
+{
+    if ( index >= cv->lod_size )
+    {
+        cv->lod_size = 0;
+        return;
+    }
+
+    long i = index & ~ 1L;
+    double p0 = cv->points[ i ];
+    double p1 = i + 1 < G_1d.nx ? cv->points[ i + 1 ] : NO_POINT;
+    double * lp = cv->lod;
+
+    i >>= 1;
+    lp[ 2 * i ]     = fmin( p0, p1 );
+    lp[ 2 * i + 1 ] = fmax( p0, p1 );
+
+    for ( long nb = cv->lod_size >> 1; nb > 1; nb >>= 1 )
+    {
+        double * up = lp + 2 * nb;
+
+        i >>= 1;
+        up[ 2 * i ]     = fmin( lp[ 4 * i ],     lp[ 4 * i + 2 ] );
+        up[ 2 * i + 1 ] = fmax( lp[ 4 * i + 1 ], lp[ 4 * i + 3 ] );
+        lp = up;
+    }
+}
+
+
+/*---------------------------------------------------------------------*
+ * Determines minimum and maximum of the points with (logical) indices
+ * from 'a' up to (but not including) 'b'. In sliding window mode this
+ * range may wrap around the end of the ring buffer and is split.
+ * Both values are NaN if there are no points in the range.
+ *---------------------------------------------------------------------*/
+
+static void
+lod_range_1d( Curve_1d_T * cv,
+              long         a,
+              long         b,
+              double     * min,
+              double     * max )
+{
+    *min = *max = NO_POINT;
+
+    a += cv->start;
+    b += cv->start;
+
+    if ( a >= G_1d.nx )
+    {
+        a -= G_1d.nx;
+        b -= G_1d.nx;
+    }
+
+    if ( b > G_1d.nx )
+    {
+        lod_phys_range_1d( cv, 0, b - G_1d.nx, min, max );
+        b = G_1d.nx;
+    }
+
+    lod_phys_range_1d( cv, a, b, min, max );
+}
+
+
+/*---------------------------------------------------------------------*
+ * Merges minimum and maximum of the points with (physical) indices
+ * from 'a' up to (but not including) 'b' into 'min' and 'max'. Only
+ * the points at the ends of the range that don't fill a whole block
+ * of the next level are looked at individually on each level.
+ *---------------------------------------------------------------------*/
+
+static void
+lod_phys_range_1d( Curve_1d_T * cv,
+                   long         a,
+                   long         b,
+                   double     * min,
+                   double     * max )
+{
+    if ( a < b && a & 1 )
+    {
+        *min = fmin( *min, cv->points[ a ] );
+        *max = fmax( *max, cv->points[ a++ ] );
+    }
+
+    if ( a < b && b & 1 )
+    {
+        *min = fmin( *min, cv->points[ --b ] );
+        *max = fmax( *max, cv->points[ b ] );
+    }
+
+    double * lp = cv->lod;
+
+    for ( long nb = cv->lod_size >> 1; ( a >>= 1 ) < ( b >>= 1 );
+          lp += 2 * nb, nb >>= 1 )
+    {
+        if ( a & 1 )
+        {
+            *min = fmin( *min, lp[ 2 * a ] );
+            *max = fmax( *max, lp[ 2 * a++ + 1 ] );
+        }
+
+        if ( b & 1 )
+        {
+            b--;
+            *min = fmin( *min, lp[ 2 * b ] );
+            *max = fmax( *max, lp[ 2 * b + 1 ] );
+        }
+    }
 }
 
 
@@ -1233,6 +1532,7 @@ redraw_all_1d( void )
 void
 redraw_canvas_1d( Canvas_T * c )
 {
+    dump_window_changed( 1 );
     XFillRectangle( G.d, c->pm, c->gc, 0, 0, c->w, c->h );
 
     if ( G.is_init )
@@ -1264,10 +1564,13 @@ redraw_canvas_1d( Canvas_T * c )
             {
                 cv = G_1d.curve[ i ];
 
+                if ( cv->needs_recalc )
+                    recalc_XPoints_of_curve_1d( cv );
+
                 if ( cv->count <= 1 )
                     continue;
 
-                XDrawLines( G.d, c->pm, cv->gc, cv->xpoints, cv->count,
+                XDrawLines( G.d, c->pm, cv->gc, cv->xpoints, cv->xp_count,
                             CoordModeOrigin );
             }
 
@@ -1521,9 +1824,9 @@ fs_rescale_1d( bool vert_only )
         Curve_1d_T * cv = G_1d.curve[ i ];
 
         for ( long j = 0; j < G_1d.nx; j++ )
-            if ( cv->points[ j ].exist )
+            if ( POINT_EXISTS( cv->points[ j ] ) )
             {
-                double data = cv->points[ j ].v;
+                double data = cv->points[ j ];
                 max = d_max( data, max );
                 min = d_min( data, min );
             }
@@ -1541,8 +1844,8 @@ fs_rescale_1d( bool vert_only )
 
     /* Calculate new real world maximum and minimum */
 
-    double rw_min = G_1d.rwc_delta[ Y ] * min + G_1d.rw_min;
-    double rw_max = G_1d.rwc_delta[ Y ] * max + G_1d.rw_min;
+    double rw_min = G_1d.rwc_delta[ Y ] * min + G_1d.rwc_start[ Y ];
+    double rw_max = G_1d.rwc_delta[ Y ] * max + G_1d.rwc_start[ Y ];
 
     /* Calculate new scaling factor and rescale the scaled data as well as the
        points for drawing */
@@ -1564,12 +1867,12 @@ fs_rescale_1d( bool vert_only )
 
         cv->up = cv->down = cv->left = cv->right = false;
 
-        for ( long j = 0; j < G_1d.nx; j++ )
-            if ( cv->points[ j ].exist )
-                cv->points[ j ].v = ( G_1d.rwc_delta[ Y ] * cv->points[ j ].v
-                                      + G_1d.rw_min - rw_min )
-                                    / new_rwc_delta_y;
+        for ( long j = 0; j < G_1d.nx; j++ )        /* NaNs don't change */
+            cv->points[ j ] = (   G_1d.rwc_delta[ Y ] * cv->points[ j ]
+                                + G_1d.rwc_start[ Y ] - rw_min )
+                              / new_rwc_delta_y;
 
+        cv->lod_size = 0;
         recalc_XPoints_of_curve_1d( cv );
     }
 
@@ -1581,6 +1884,29 @@ fs_rescale_1d( bool vert_only )
 }
 
 
+/*-------------------------------------------------------------------*
+ * Sets the y-scaling of all curves of the 1d graphics so that the
+ * range between the minimum and maximum of all data received so far
+ * fills the whole canvas. The scaled data are relative to the real
+ * world coordinates G_1d.rwc_start[ Y ] and G_1d.rwc_delta[ Y ]
+ * which don't change with new extrema, so only the transformation
+ * from scaled data to canvas coordinates needs adjusting.
+ *-------------------------------------------------------------------*/
+
+void
+fs_adjust_y_1d( void )
+{
+    double factor = G_1d.rwc_delta[ Y ] / ( G_1d.rw_max - G_1d.rw_min );
+    double shift = ( G_1d.rwc_start[ Y ] - G_1d.rw_min ) / G_1d.rwc_delta[ Y ];
+
+    for ( long i = 0; i < G_1d.nc; i++ )
+    {
+        G_1d.curve[ i ]->shift[ Y ] = shift;
+        G_1d.curve[ i ]->s2d[ Y ] = ( G_1d.canvas.h - 1.0 ) * factor;
+    }
+}
+
+
 /*---------------------------------------------------*
  * Function creates the axis scales for 1D displays.
  *---------------------------------------------------*/
@@ -44,6 +44,9 @@ bool user_zoom_1d( double /* x       */,
 
 void recalc_XPoints_of_curve_1d( Curve_1d_T * /* cv */ );
 
+void lod_point_changed_1d( Curve_1d_T * /* cv    */,
+                           long         /* index */  );
+
 void redraw_all_1d( void );
 
 void redraw_canvas_1d( Canvas_T * /* c */ );
@@ -55,6 +58,8 @@ int get_mouse_pos_1d( double *       /* pa      */,
 
 void fs_rescale_1d( bool /* vert_only */ );
 
+void fs_adjust_y_1d( void );
+
 void make_scale_1d( Curve_1d_T * /* cv    */,
                     Canvas_T *   /* c     */,
                     int          /* coord */  );
@@ -19,10 +19,24 @@
 
 
 #include "fsc2.h"
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <X11/extensions/XShm.h>
 
 Graphics_2d_T G_2d;
 
 
+/* Client side image the points of the 2D display get drawn into (if
+   possible in shared memory with the X server) before being send to the
+   server with a single request */
+
+static XImage * Points_image = NULL;
+static XShmSegmentInfo Points_shm;
+static bool Points_use_shm;
+static bool Points_no_image = false;    /* set if the image can't be used */
+static bool Shm_failed;
+
+
 static void press_handler_2d( FL_OBJECT * obj,
                               Window      window,
                               XEvent    * ev,
@@ -51,6 +65,17 @@ static void reconfigure_window_2d( Canvas_T * c,
 static void recalc_XPoints_2d( void );
 static void draw_2d_points( Canvas_T   * c,
                             Curve_2d_T * cv );
+static bool draw_2d_points_image( Canvas_T   * c,
+                                  Curve_2d_T * cv );
+static bool get_points_image( Canvas_T * c );
+static int shm_error_handler( Display     * d,
+                              XErrorEvent * ev );
+static void fill_image_rect( XImage        * image,
+                             int             x,
+                             int             y,
+                             int             w,
+                             int             h,
+                             unsigned long   pixel );
 static void make_color_scale( Canvas_T * c );
 static void delete_marker_2d( long x_pos,
                               long y_pos,
@@ -832,7 +857,7 @@ user_zoom_2d( long   curve,
     if ( ! ( keep_z && keep_zw ) )
     {
         if ( ! keep_z )
-            cv->shift[ Z ] = ( cv->rw_min - z ) / cv->rwc_delta[ Z ];
+            cv->shift[ Z ] = ( cv->rwc_start[ Z ] - z ) / cv->rwc_delta[ Z ];
 
         if ( ! keep_zw )
         {
@@ -1179,7 +1204,7 @@ shift_XPoints_of_curve_2d( Canvas_T *   c,
         dy = 0,
         dz;
     int factor;
-    Scaled_Point_T *sp = cv->points;
+    double *sp = cv->points;
     XPoint *xp = cv->xpoints;
 
 
@@ -1217,8 +1242,8 @@ shift_XPoints_of_curve_2d( Canvas_T *   c,
     cv->up = cv->down = cv->left = cv->right = ( cv->count != 0 );
 
     for ( i = 0, count = cv->count;
-          i < G_2d.nx * G_2d.ny && count != 0; sp++, xp++, i++ )
-        if ( sp->exist )
+          i < G_2d.nx_max * G_2d.ny && count != 0; sp++, xp++, i++ )
+        if ( POINT_EXISTS( *sp ) )
         {
             count--;
 
@@ -1410,8 +1435,8 @@ void
 recalc_XPoints_of_curve_2d( Curve_2d_T * cv )
 {
     long i, j, count;
-    Scaled_Point_T *sp;
-    XPoint *xp = cv->xpoints;
+    double *sp;
+    XPoint *xp;
     XPoint p;
     short dw, dh;
 
@@ -1423,10 +1448,16 @@ recalc_XPoints_of_curve_2d( Curve_2d_T * cv )
     dw = i2s15( cv->w / 2 );
     dh = i2s15( cv->h / 2 );
 
-    for ( sp = cv->points, i = 0, count = cv->count;
-          i < G_2d.ny && count != 0; i++ )
+    /* Rows are G_2d.nx_max points apart (the XPoints are stored at the
+       same indices as the points they belong to) */
+
+    for ( i = 0, count = cv->count; i < G_2d.ny && count != 0; i++ )
+    {
+        sp = cv->points + i * G_2d.nx_max;
+        xp = cv->xpoints + i * G_2d.nx_max;
+
         for ( j = 0; j < G_2d.nx && count != 0; sp++, xp++, j++ )
-            if ( sp->exist )
+            if ( POINT_EXISTS( *sp ) )
             {
                 count--;
 
@@ -1441,6 +1472,7 @@ recalc_XPoints_of_curve_2d( Curve_2d_T * cv )
                 cv->up    &= xp->y + cv->h <= 0;
                 cv->down  &= xp->y >= ( int ) G_2d.canvas.h;
             }
+    }
 
     cv->needs_recalc = false;
 }
@@ -1473,6 +1505,7 @@ redraw_canvas_2d( Canvas_T * c )
     short int dw, dh;
 
 
+    dump_window_changed( 2 );
     XFillRectangle( G.d, c->pm, c->gc, 0, 0, c->w, c->h );
 
     if ( ! G.is_init )
@@ -1599,7 +1632,7 @@ draw_2d_points( Canvas_T   * c,
 
 {
     long i, count;
-    Scaled_Point_T *sp;
+    double *sp;
     XPoint *xp;
     XPoint p[ 2 ];
 
@@ -1611,11 +1644,17 @@ draw_2d_points( Canvas_T   * c,
          || G_2d.curve_2d[ G_2d.active_curve ]->h > 2 * c->h )
         return;
 
+    /* Unless it can't be done draw into a client side image and send it to
+       the X server in one go instead of one request per point */
+
+    if ( draw_2d_points_image( c, cv ) )
+        return;
+
     if ( cv->w == 1 && cv->h == 1 )
-        for ( sp = cv->points, xp = cv->xpoints, count = cv->count,
-                  i = 0; i < G_2d.nx * G_2d.ny && count != 0; sp++, xp++, i++ )
+        for ( sp = cv->points, xp = cv->xpoints, count = cv->count, i = 0;
+              i < G_2d.nx_max * G_2d.ny && count != 0; sp++, xp++, i++ )
         {
-            if ( ! sp->exist )
+            if ( ! POINT_EXISTS( *sp ) )
                 continue;
 
             count--;
@@ -1630,7 +1669,7 @@ draw_2d_points( Canvas_T   * c,
 
             XDrawPoint( G.d, c->pm,
                         G_2d.gcs[ d2ci( cv->z_factor
-                                      * ( sp->v + cv->shift[ Z ] ) ) ],
+                                      * ( *sp + cv->shift[ Z ] ) ) ],
                         xp->x, xp->y );
         }
     else if ( cv->w == 1 || cv->h == 1 )
@@ -1638,10 +1677,10 @@ draw_2d_points( Canvas_T   * c,
         p[ 1 ].x = cv->w - 1;
         p[ 1 ].y = cv->h - 1;
 
-        for ( sp = cv->points, xp = cv->xpoints, count = cv->count,
-                  i = 0; i < G_2d.nx * G_2d.ny && count != 0; sp++, xp++, i++ )
+        for ( sp = cv->points, xp = cv->xpoints, count = cv->count, i = 0;
+              i < G_2d.nx_max * G_2d.ny && count != 0; sp++, xp++, i++ )
         {
-            if ( ! sp->exist )
+            if ( ! POINT_EXISTS( *sp ) )
                 continue;
 
             count--;
@@ -1659,16 +1698,16 @@ draw_2d_points( Canvas_T   * c,
 
             XDrawLines( G.d, c->pm,
                         G_2d.gcs[ d2ci( cv->z_factor
-                                      * ( sp->v + cv->shift[ Z ] ) ) ],
+                                      * ( *sp + cv->shift[ Z ] ) ) ],
                         p, 2,  CoordModePrevious );
         }
     }
     else
     {
-        for ( sp = cv->points, xp = cv->xpoints, count = cv->count,
-              i = 0; i < G_2d.nx * G_2d.ny && count != 0; sp++, xp++, i++ )
+        for ( sp = cv->points, xp = cv->xpoints, count = cv->count, i = 0;
+              i < G_2d.nx_max * G_2d.ny && count != 0; sp++, xp++, i++ )
         {
-            if ( ! sp->exist )
+            if ( ! POINT_EXISTS( *sp ) )
                 continue;
 
             count--;
@@ -1683,13 +1722,269 @@ draw_2d_points( Canvas_T   * c,
 
             XFillRectangle( G.d, c->pm,
                             G_2d.gcs[ d2ci( cv->z_factor
-                                          * ( sp->v + cv->shift[ Z ] ) ) ],
+                                          * ( *sp + cv->shift[ Z ] ) ) ],
                             xp->x, xp->y, cv->w, cv->h );
         }
     }
 }
 
 
+/*---------------------------------------------------------------------*
+ * Draws the points of a curve into a client side image of the canvas,
+ * starting with a background of the same colour the pixmap of the
+ * canvas gets filled with and then drawing a rectangle of the size of
+ * a point (clipped to the canvas) for each point in the order they're
+ * stored, so the result is the same as when drawing them one by one.
+ * Finally the image is copied into the pixmap. Returns false if no
+ * image could be created.
+ *---------------------------------------------------------------------*/
+
+static bool
+draw_2d_points_image( Canvas_T   * c,
+                      Curve_2d_T * cv )
+{
+    if ( ! get_points_image( c ) )
+        return false;
+
+    unsigned long pixels[ NUM_COLORS + 2 ];
+    for ( int i = 0; i < NUM_COLORS + 2; i++ )
+        pixels[ i ] = fl_get_pixel( FL_FREE_COL1 + i );
+
+    fill_image_rect( Points_image, 0, 0, c->w, c->h,
+                     fl_get_pixel( FL_INACTIVE ) );
+
+    double * sp = cv->points;
+    XPoint * xp = cv->xpoints;
+    long count = cv->count;
+
+    for ( long i = 0; i < G_2d.nx_max * G_2d.ny && count != 0;
+          sp++, xp++, i++ )
+    {
+        if ( ! POINT_EXISTS( *sp ) )
+            continue;
+
+        count--;
+
+        /* Clip the point to the canvas */
+
+        int x = xp->x;
+        int y = xp->y;
+        int w = cv->w;
+        int h = cv->h;
+
+        if ( x < 0 )
+        {
+            w += x;
+            x = 0;
+        }
+
+        if ( y < 0 )
+        {
+            h += y;
+            y = 0;
+        }
+
+        if ( x + w > ( int ) c->w )
+            w = c->w - x;
+        if ( y + h > ( int ) c->h )
+            h = c->h - y;
+
+        if ( w <= 0 || h <= 0 )
+            continue;
+
+        fill_image_rect( Points_image, x, y, w, h,
+                         pixels[ d2ci( cv->z_factor
+                                       * ( *sp + cv->shift[ Z ] ) ) ] );
+    }
+
+    /* A shared memory image can only be reused once the X server is done
+       with it */
+
+    if ( Points_use_shm )
+    {
+        XShmPutImage( G.d, c->pm, c->gc, Points_image, 0, 0, 0, 0,
+                      c->w, c->h, False );
+        XSync( G.d, False );
+    }
+    else
+        XPutImage( G.d, c->pm, c->gc, Points_image, 0, 0, 0, 0, c->w, c->h );
+
+    return true;
+}
+
+
+/*---------------------------------------------------------------------*
+ * Makes sure there's a client side image with the size of the canvas,
+ * if possible in shared memory (i.e. if the X server supports the
+ * MIT-SHM extension and is running on the same machine). Returns false
+ * if no image can be used for the visual.
+ *---------------------------------------------------------------------*/
+
+static bool
+get_points_image( Canvas_T * c )
+{
+    if ( Points_no_image )
+        return false;
+
+    if (    Points_image != NULL
+         && Points_image->width == ( int ) c->w
+         && Points_image->height == ( int ) c->h )
+        return true;
+
+    delete_points_image_2d( );
+
+    Visual * visual = fl_get_visual( );
+    unsigned int depth = fl_get_canvas_depth( c->obj );
+
+    /* First try to get an image in shared memory */
+
+    if ( XShmQueryExtension( G.d ) )
+    {
+        Points_image = XShmCreateImage( G.d, visual, depth, ZPixmap, NULL,
+                                        &Points_shm, c->w, c->h );
+
+        if ( Points_image != NULL )
+        {
+            Points_shm.shmid = shmget( IPC_PRIVATE,
+                                         Points_image->bytes_per_line
+                                       * Points_image->height,
+                                       IPC_CREAT | S_IRUSR | S_IWUSR );
+            Points_shm.shmaddr = ( char * ) -1;
+            if ( Points_shm.shmid >= 0 )
+                Points_shm.shmaddr = shmat( Points_shm.shmid, NULL, 0 );
+
+            if ( Points_shm.shmaddr != ( char * ) -1 )
+            {
+                /* Attaching fails (asynchronously) if the X server isn't
+                   on the same machine, so catch the error */
+
+                Points_image->data = Points_shm.shmaddr;
+                Points_shm.readOnly = False;
+
+                Shm_failed = false;
+                XSync( G.d, False );
+                int ( * old_handler )( Display *, XErrorEvent * ) =
+                                      XSetErrorHandler( shm_error_handler );
+                XShmAttach( G.d, &Points_shm );
+                XSync( G.d, False );
+                XSetErrorHandler( old_handler );
+
+                if ( ! Shm_failed )
+                {
+                    /* Segment is deleted as soon as both sides detached */
+
+                    shmctl( Points_shm.shmid, IPC_RMID, NULL );
+                    Points_use_shm = true;
+                    return true;
+                }
+
+                shmdt( Points_shm.shmaddr );
+            }
+
+            if ( Points_shm.shmid >= 0 )
+                shmctl( Points_shm.shmid, IPC_RMID, NULL );
+
+            Points_image->data = NULL;
+            XDestroyImage( Points_image );
+            Points_image = NULL;
+        }
+    }
+
+    /* Otherwise use a normal image */
+
+    Points_use_shm = false;
+    Points_image = XCreateImage( G.d, visual, depth, ZPixmap, 0, NULL,
+                                 c->w, c->h, BitmapPad( G.d ), 0 );
+    if ( Points_image == NULL )
+    {
+        Points_no_image = true;
+        return false;
+    }
+
+    Points_image->data = T_malloc(   Points_image->bytes_per_line
+                                   * Points_image->height );
+    return true;
+}
+
+
+/*-------------------------------------------------------------*
+ * Error handler that's active while attaching the X server to
+ * the shared memory of the image.
+ *-------------------------------------------------------------*/
+
+static int
+shm_error_handler( Display     * d   UNUSED_ARG,
+                   XErrorEvent * ev  UNUSED_ARG )
+{
+    Shm_failed = true;
+    return 0;
+}
+
+
+/*-------------------------------------------------------------*
+ * Gets rid of the client side image for the 2D display, to be
+ * called when the 2D display window is closed.
+ *-------------------------------------------------------------*/
+
+void
+delete_points_image_2d( void )
+{
+    if ( Points_image == NULL )
+        return;
+
+    if ( Points_use_shm )
+    {
+        XShmDetach( G.d, &Points_shm );
+        XSync( G.d, False );
+        shmdt( Points_shm.shmaddr );
+    }
+    else
+        T_free( Points_image->data );
+
+    Points_image->data = NULL;
+    XDestroyImage( Points_image );
+    Points_image = NULL;
+}
+
+
+/*------------------------------------------------------------------*
+ * Fills a (clipped) rectangle of an image with a pixel value. For
+ * the most common case of 32 bits per pixel in the byte order of
+ * the machine the memory gets written to directly, otherwise the
+ * (slower) XPutPixel() macro is used.
+ *------------------------------------------------------------------*/
+
+static void
+fill_image_rect( XImage        * image,
+                 int             x,
+                 int             y,
+                 int             w,
+                 int             h,
+                 unsigned long   pixel )
+{
+    static const int one = 1;
+    int host_order = * ( const char * ) &one ? LSBFirst : MSBFirst;
+
+    if ( image->bits_per_pixel == 32 && image->byte_order == host_order )
+    {
+        uint32_t p = pixel;
+
+        for ( int j = y; j < y + h; j++ )
+        {
+            uint32_t * row = ( uint32_t * ) (   image->data
+                                              + j * image->bytes_per_line ) + x;
+
+            for ( int i = 0; i < w; i++ )
+                row[ i ] = p;
+        }
+    }
+    else
+        for ( int j = y; j < y + h; j++ )
+            for ( int i = x; i < x + w; i++ )
+                XPutPixel( image, i, j, pixel );
+}
+
+
 /*-----------------------------------------------*
  * Copies the background pixmap onto the canvas.
  *-----------------------------------------------*/
@@ -1800,12 +2095,12 @@ repaint_canvas_2d( Canvas_T * c )
                 a_index = -1;
             else
             {
-                a_index =   G_2d.nx * lrnd( floor( y_pos ) )
+                a_index =   G_2d.nx_max * lrnd( floor( y_pos ) )
                           + lrnd( floor( x_pos ) );
 
-                if ( cv->points[ a_index ].exist )
+                if ( POINT_EXISTS( cv->points[ a_index ] ) )
                     z_pos =   cv->rwc_start[ Z ] + cv->rwc_delta[ Z ]
-                            * cv->points[ a_index ].v;
+                            * cv->points[ a_index ];
                 else
                     a_index = -1;
             }
@@ -1862,12 +2157,12 @@ repaint_canvas_2d( Canvas_T * c )
                 }
                 else
                 {
-                    index_1 = G_2d.nx * lrnd( floor( y_pos ) )
+                    index_1 = G_2d.nx_max * lrnd( floor( y_pos ) )
                               + lrnd( floor( x_pos ) );
 
-                    if ( cv->points[ index_1 ].exist )
+                    if ( POINT_EXISTS( cv->points[ index_1 ] ) )
                         z_pos_1 = cv->rwc_start[ Z ] + cv->rwc_delta[ Z ]
-                                * ( cv->points[ index_1 ].v - cv->shift[ Z ] );
+                                * ( cv->points[ index_1 ] - cv->shift[ Z ] );
                     else
                         index_1 = -1;
                 }
@@ -1885,12 +2180,12 @@ repaint_canvas_2d( Canvas_T * c )
                 }
                 else
                 {
-                    index_2 = G_2d.nx * lrnd( floor( y_pos ) )
+                    index_2 = G_2d.nx_max * lrnd( floor( y_pos ) )
                               + lrnd( floor( x_pos ) );
 
-                    if ( cv->points[ index_2 ].exist )
+                    if ( POINT_EXISTS( cv->points[ index_2 ] ) )
                         z_pos_2 = cv->rwc_start[ Z ] + cv->rwc_delta[ Z ]
-                                * ( cv->points[ index_2 ].v - cv->shift[ Z ] );
+                                * ( cv->points[ index_2 ] - cv->shift[ Z ] );
                     else
                         index_2 = -1;
                 }
@@ -1968,11 +2263,12 @@ get_mouse_pos_2d( double       * pa,
     pa[ Y ] = ( G_2d.canvas.h - 1.0 - ppos[ Y ] + cv->h / 2 )
               / cv->s2d[ Y ] - cv->shift[ Y ];
 
-    a_index = G_2d.nx * lrnd( floor( pa[ Y ] ) ) + lrnd( floor( pa[ X ] ) );
+    a_index =   G_2d.nx_max * lrnd( floor( pa[ Y ] ) )
+              + lrnd( floor( pa[ X ] ) );
 
-    if ( cv->points[ a_index ].exist )
+    if ( POINT_EXISTS( cv->points[ a_index ] ) )
         pa[ Z ] = cv->rwc_start[ Z ] + cv->rwc_delta[ Z ]
-                  * cv->points[ a_index ].v;
+                  * cv->points[ a_index ];
 
     pa[ X ] = cv->rwc_start[ X ] + cv->rwc_delta[ X ]
               * ( ppos[ X ] / cv->s2d[ X ] - cv->shift[ X ] );
@@ -1980,7 +2276,7 @@ get_mouse_pos_2d( double       * pa,
               * ( ( G_2d.canvas.h - 1.0 - ppos[ Y ] )
                   / cv->s2d[ Y ] - cv->shift[ Y ] );
 
-    return cv->points[ a_index ].exist ? 2 : -2;
+    return POINT_EXISTS( cv->points[ a_index ] ) ? 2 : -2;
 }
 
 
@@ -2000,7 +2296,7 @@ fs_rescale_2d( Curve_2d_T * cv,
            rw_max;
     double data;
     double new_rwc_delta_z;
-    Scaled_Point_T *sp;
+    double *sp;
 
 
     if ( ! cv->is_scale_set )
@@ -2009,10 +2305,10 @@ fs_rescale_2d( Curve_2d_T * cv,
     /* Find minimum and maximum value of all scaled data */
 
     for ( sp = cv->points, count = cv->count, i = 0;
-          i < G_2d.nx * G_2d.ny && count != 0; sp++, i++ )
-        if ( sp->exist )
+          i < G_2d.nx_max * G_2d.ny && count != 0; sp++, i++ )
+        if ( POINT_EXISTS( *sp ) )
         {
-            data = sp->v;
+            data = *sp;
             max = d_max( data, max );
             min = d_min( data, min );
             count--;
@@ -2030,8 +2326,8 @@ fs_rescale_2d( Curve_2d_T * cv,
 
     /* Calculate new real world maximum and minimum */
 
-    rw_min = cv->rwc_delta[ Z ] * min + cv->rw_min;
-    rw_max = cv->rwc_delta[ Z ] * max + cv->rw_min;
+    rw_min = cv->rwc_delta[ Z ] * min + cv->rwc_start[ Z ];
+    rw_max = cv->rwc_delta[ Z ] * max + cv->rwc_start[ Z ];
 
     /* Calculate new scaling factor and rescale the scaled data as well as the
        points for drawing */
@@ -2050,12 +2346,14 @@ fs_rescale_2d( Curve_2d_T * cv,
 
     cv->up = cv->down = cv->left = cv->right = false;
 
-    for ( sp = cv->points, i = 0; i < G_2d.nx * G_2d.ny; sp++, i++ )
-        if ( sp->exist )
-            sp->v = ( cv->rwc_delta[ Z ] * sp->v + cv->rw_min - rw_min )
-                    / new_rwc_delta_z;
+    /* Non-existing points (NaNs) don't change */
+
+    for ( sp = cv->points, i = 0; i < G_2d.nx_max * G_2d.ny; sp++, i++ )
+        *sp = ( cv->rwc_delta[ Z ] * *sp + cv->rwc_start[ Z ] - rw_min )
+              / new_rwc_delta_z;
 
     cv->needs_recalc = true;
+    cut_invalidate_columns( );
 
     /* Store new minimum and maximum and the new scale factor */
 
@@ -2066,6 +2364,23 @@ fs_rescale_2d( Curve_2d_T * cv,
 }
 
 
+/*-------------------------------------------------------------------*
+ * Sets the z-scaling of a curve so that the range between minimum
+ * and maximum of all its data received so far spans the whole color
+ * scale. Since the scaled data are relative to the real world coord-
+ * inates cv->rwc_start[ Z ] and cv->rwc_delta[ Z ], which don't
+ * change with new extrema, none of the data have to be touched.
+ *-------------------------------------------------------------------*/
+
+void
+fs_adjust_z_2d( Curve_2d_T * cv )
+{
+    cv->z_factor = cv->rwc_delta[ Z ] / ( cv->rw_max - cv->rw_min );
+    cv->shift[ Z ] = ( cv->rwc_start[ Z ] - cv->rw_min ) / cv->rwc_delta[ Z ];
+    cv->s2d[ Z ] = ( G_2d.z_axis.h - 1.0 ) * cv->z_factor;
+}
+
+
 /*----------------------------------------------------*
  *----------------------------------------------------*/
 
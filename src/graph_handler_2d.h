@@ -61,6 +61,8 @@ int get_mouse_pos_2d( double *       /* pa      */,
 void fs_rescale_2d( Curve_2d_T * /* cv     */,
                     bool         /* z_only */  );
 
+void fs_adjust_z_2d( Curve_2d_T * /* cv */ );
+
 void make_scale_2d( Curve_2d_T * /* cv    */,
                     Canvas_T *   /* c     */,
                     int          /* coord */  );
@@ -74,6 +76,8 @@ void set_marker_2d( long /* x_pos */,
 
 void remove_markers_2d( long * /* curves */ );
 
+void delete_points_image_2d( void );
+
 
 #endif   /* ! GRAPH_HANDLER_2D_HEADER */
 
@@ -1013,6 +1013,7 @@ G_init_curves_1d( void )
 
         cv->points = NULL;
         cv->xpoints = NULL;
+        cv->xp_ref = NULL;
 
         /* Create a GC for drawing the curve and set its color */
 
@@ -1064,6 +1065,11 @@ G_init_curves_1d( void )
         cv->shift[ X ] = cv->shift[ Y ] = 0.0;
 
         cv->count = 0;
+        cv->start = 0;
+        cv->needs_recalc = false;
+        cv->xp_count = 0;
+        cv->lod = NULL;
+        cv->lod_size = 0;
         cv->active = true;
         cv->can_undo = false;
 
@@ -1072,7 +1078,7 @@ G_init_curves_1d( void )
         cv->points = T_malloc( G_1d.nx * sizeof *cv->points );
 
         for ( long j = 0; j < G_1d.nx; j++ )      /* no points are known yet */
-            cv->points[ j ].exist = false;
+            cv->points[ j ] = NO_POINT;
 
         cv->xpoints = T_malloc( G_1d.nx * sizeof *cv->xpoints );
     }
@@ -1102,6 +1108,12 @@ G_init_curves_2d( void )
     for ( int i = 0; i < 7; i++ )
         fl_set_cursor_color( G_2d.cursor[ i ], FL_BLACK, FL_WHITE );
 
+    /* At the start the arrays for the data have exactly the room needed
+       for the initial number of points, they grow when required */
+
+    G_2d.nx_max = G_2d.nx;
+    G_2d.ny_max = G_2d.ny;
+
     for ( long i = 0; i < G_2d.nc; i++ )
     {
         /* Allocate memory for the curve */
@@ -1189,9 +1201,8 @@ G_init_curves_2d( void )
 
         cv->points = T_malloc( G_2d.nx * G_2d.ny * sizeof *cv->points );
 
-        Scaled_Point_T * sp = cv->points;
-        for ( long j = 0; j < G_2d.nx * G_2d.ny; sp++, j++ )
-            sp->exist = false;
+        for ( long j = 0; j < G_2d.nx * G_2d.ny; j++ )
+            cv->points[ j ] = NO_POINT;
 
         cv->xpoints = T_malloc( G_2d.nx * G_2d.ny * sizeof *cv->xpoints );
     }
@@ -1464,6 +1475,7 @@ graphics_free( void )
 
             T_free( cv->points );
             T_free( cv->xpoints );
+            T_free( cv->lod );
             cv = T_free( cv );
         }
 
@@ -1472,6 +1484,8 @@ graphics_free( void )
         for ( long i = 0; i < NUM_COLORS + 2; i++ )
             XFreeGC( G.d, G_2d.gcs[ i ] );
 
+        delete_points_image_2d( );
+
         for ( long i = 0; i < G_2d.nc; i++ )
         {
             Curve_2d_T * cv2  = G_2d.curve_2d[ i ];
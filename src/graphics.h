@@ -75,7 +75,6 @@
 #define WINDOW_2D   2
 #define WINDOW_CUT  4
 
-typedef struct Scaled_Point Scaled_Point_T;
 typedef struct Marker_1d Marker_1d_T;
 typedef struct Marker_2d Marker_2d_T;
 typedef struct Curve_1d Curve_1d_T;
@@ -87,11 +86,13 @@ typedef struct Graphics_1d Graphics_1d_T;
 typedef struct Graphics_2d Graphics_2d_T;
 
 
-struct Scaled_Point {
-    double v;               /* value of the point (in interval [0,1] */
-    bool   exist;           /* set if value has been set at all */
-    long   xp_ref;          /* index of the associated XPoint */
-};
+/* The scaled data of the curves (values in the interval [0,1]) are stored
+   in plain arrays of doubles, points that haven't been set at all are marked
+   by NaN (which, in contrast to a separate flag, lets rescaling loops run
+   over all points without having to check each of them) */
+
+#define NO_POINT          ( ( double ) NAN )
+#define POINT_EXISTS( v ) ( ! isnan( v ) )
 
 
 struct Marker_1d {
@@ -112,9 +113,21 @@ struct Marker_2d {
 
 
 struct Curve_1d {
-    Scaled_Point_T * points;
+    double         * points;     /* scaled data */
     XPoint         * xpoints;
+    long           * xp_ref;     /* indices of the associated XPoints (only
+                                    used for the cross section curve) */
     long           count;        /* points in curve */
+    long           start;        /* index of the first point (in sliding
+                                    window mode the points are kept in a
+                                    ring buffer, otherwise it's always 0) */
+    bool           needs_recalc; /* set when XPoints must be recalculated */
+    long           xp_count;     /* number of XPoints to be drawn */
+    double         * lod;        /* minima and maxima of the points in blocks
+                                    of 2, 4, 8, ... points (only used for
+                                    the curves in the 1D window) */
+    long           lod_size;     /* number of points covered by 'lod', a
+                                    power of 2 or 0 if it needs rebuilding */
 
     GC gc;
 
@@ -144,7 +157,7 @@ struct Curve_2d {
     bool             is_fs;
     bool             is_scale_set;
 
-    Scaled_Point_T * points;
+    double         * points;  /* scaled data */
     XPoint         * xpoints;
     long             count;   /* number of points in curve */
 
@@ -324,6 +337,8 @@ struct Graphics_2d {
     long nc;                /* number of curves */
     long nx;                /* points in x-direction */
     long ny;                /* points in y-direction */
+    long nx_max;            /* points per row the curves have room for */
+    long ny_max;            /* rows the curves have room for */
     double rwc_start[ 3 ];  /* real world coordinate start values */
     double rwc_delta[ 3 ];  /* real world coordinate increment values */
     char *label[ 6 ];       /* label for x-, y- and z-axis */
@@ -28,10 +28,12 @@
 void
 clear_curve_1d( long curve )
 {
-    Scaled_Point_T *sp = G_1d.curve[ curve ]->points;
+    double *sp = G_1d.curve[ curve ]->points;
     for ( long i = 0; i < G_1d.nx; sp++, i++ )
-        sp->exist = false;
+        *sp = NO_POINT;
     G_1d.curve[ curve ]->count = 0;
+    G_1d.curve[ curve ]->start = 0;
+    G_1d.curve[ curve ]->lod_size = 0;
 }
 
 
@@ -42,9 +44,9 @@ clear_curve_1d( long curve )
 void
 clear_curve_2d( long curve )
 {
-    Scaled_Point_T *sp = G_2d.curve_2d[ curve ]->points;
-    for ( long i = 0; i < G_2d.nx * G_2d.ny; sp++, i++ )
-        sp->exist = false;
+    double *sp = G_2d.curve_2d[ curve ]->points;
+    for ( long i = 0; i < G_2d.nx_max * G_2d.ny; sp++, i++ )
+        *sp = NO_POINT;
     G_2d.curve_2d[ curve ]->count = 0;
 }
 
@@ -235,15 +237,33 @@ rescale_1d( long new_nx )
     if ( new_nx < 0 )
         return;
 
+    /* In sliding window mode the points of the curves may start anywhere
+       in their ring buffers, make them start at the first element again */
+
+    for ( long k = 0; k < G_1d.nc; k++ )
+        if ( G_1d.curve[ k ]->start != 0 )
+        {
+            Curve_1d_T * cv = G_1d.curve[ k ];
+            double * old_points = cv->points;
+
+            cv->points = T_malloc( G_1d.nx * sizeof *cv->points );
+            memcpy( cv->points, old_points + cv->start,
+                    ( G_1d.nx - cv->start ) * sizeof *cv->points );
+            memcpy( cv->points + G_1d.nx - cv->start, old_points,
+                    cv->start * sizeof *cv->points );
+            T_free( old_points );
+            cv->start = 0;
+        }
+
     /* Find the maximum x-index currently used by a point or a marker */
 
     long max_x = 0;
     for ( long k = 0; k < G_1d.nc; k++ )
     {
-        Scaled_Point_T * sp = G_1d.curve[ k ]->points;
+        double * sp = G_1d.curve[ k ]->points;
         long count = G_1d.curve[ k ]->count;
         for ( long i = 0; count > 0; sp++, i++ )
-            if ( sp->exist )
+            if ( POINT_EXISTS( *sp ) )
             {
                 if( i > max_x )
                     max_x = i;
@@ -278,9 +298,11 @@ rescale_1d( long new_nx )
         G_1d.curve[ k ]->xpoints = T_realloc( G_1d.curve[ k ]->xpoints,
                                     max_x * sizeof *G_1d.curve[ k ]->xpoints );
 
-        Scaled_Point_T * sp = G_1d.curve[ k ]->points + G_1d.nx;
+        double * sp = G_1d.curve[ k ]->points + G_1d.nx;
         for ( long i = G_1d.nx; i < max_x; sp++, i++ )
-            sp->exist = false;
+            *sp = NO_POINT;
+
+        G_1d.curve[ k ]->lod_size = 0;
     }
 
     G_1d.nx = max_x;
@@ -317,13 +339,14 @@ rescale_2d( long * new_dims )
          max_y = 0;
     for ( long k = 0; k < G_2d.nc; k++ )
     {
-        Scaled_Point_T * sp = G_2d.curve_2d[ k ]->points;
         long count = G_2d.curve_2d[ k ]->count;
 
         for ( long j = 0; count > 0; j++ )
         {
+            double * sp = G_2d.curve_2d[ k ]->points + j * G_2d.nx_max;
+
             for ( long i = 0; i < G_2d.nx && count > 0; sp++, i++ )
-                if ( sp->exist )
+                if ( POINT_EXISTS( *sp ) )
                 {
                     max_y = j;
                     if ( i > max_x )
@@ -363,20 +386,20 @@ rescale_2d( long * new_dims )
         /* Reorganize the old elements to fit into the new array and clear
            the the new elements in the already existing rows */
 
-        Scaled_Point_T * old_sp = G_2d.curve_2d[ k ]->points;
-        Scaled_Point_T * osp = old_sp;
-        Scaled_Point_T * sp = G_2d.curve_2d[ k ]->points
-                                  = T_malloc(   new_nx * new_ny * sizeof *sp );
+        double * old_sp = G_2d.curve_2d[ k ]->points;
+        double * osp = old_sp;
+        double * sp = G_2d.curve_2d[ k ]->points
+                    = T_malloc( new_nx * new_ny * sizeof *sp );
 
         long j;
-        for ( j = 0; j < l_min( G_2d.ny, new_ny ); j++, osp += G_2d.nx )
+        for ( j = 0; j < l_min( G_2d.ny, new_ny ); j++, osp += G_2d.nx_max )
         {
             memcpy( sp, osp, l_min( G_2d.nx, new_nx ) * sizeof *sp );
             if ( G_2d.nx < new_nx )
             {
                 sp += G_2d.nx;
                 for ( long l = G_2d.nx; l < new_nx; l++, sp++ )
-                    sp->exist = false;
+                    *sp = NO_POINT;
             }
             else
                 sp += new_nx;
@@ -384,7 +407,7 @@ rescale_2d( long * new_dims )
 
         for ( ; j < new_ny; j++ )
             for ( long l = 0; l < new_nx; l++, sp++ )
-                sp->exist = false;
+                *sp = NO_POINT;
 
         T_free( old_sp );
 
@@ -401,13 +424,18 @@ rescale_2d( long * new_dims )
         }
     }
 
+    /* The column-wise copy of the curve used for cuts may still contain
+       points that got removed */
+
+    cut_invalidate_columns( );
+
     if ( G_2d.nx != new_nx )
          cut_num_points_changed( X, new_nx );
     if ( G_2d.ny != new_ny )
         cut_num_points_changed( Y, new_ny );
 
-    G_2d.nx = new_nx;
-    G_2d.ny = new_ny;
+    G_2d.nx = G_2d.nx_max = new_nx;
+    G_2d.ny = G_2d.ny_max = new_ny;
 
     for ( long k = 0; k < G_2d.nc; k++ )
         recalc_XPoints_of_curve_2d( G_2d.curve_2d[ k ] );
@@ -445,13 +473,15 @@ change_mode( long mode,
             cv->xpoints = T_realloc( cv->xpoints, width * sizeof *cv->xpoints );
         }
 
-        Scaled_Point_T *sp = cv->points;
+        double *sp = cv->points;
         for ( long i = 0; i < width; sp++, i++ )
-            sp->exist = false;
+            *sp = NO_POINT;
 
         cv->can_undo = false;
         cv->shift[ X ] = 0.0;
         cv->count = 0;
+        cv->start = 0;
+        cv->lod_size = 0;
         cv->s2d[ X ] = ( double ) ( G_1d.canvas.w - 1 )
                        / ( double ) ( width - 1 );
     }
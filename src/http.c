@@ -31,6 +31,11 @@ static void spawn_server( void );
 static void http_send_error_browser( int pd );
 static void http_send_picture( int pd,
                                int type );
+static void http_send_png( int pd,
+                           int type );
+static bool http_write( int          pd,
+                        const void * buf,
+                        size_t       len );
 
 
 enum {
@@ -267,6 +272,18 @@ http_check( void )
                 http_send_picture( Comm.http_pd[ HTTP_PARENT_WRITE ], 3 );
                 break;
 
+            case 'x' :                          /* send PNG with 1D window */
+                http_send_png( Comm.http_pd[ HTTP_PARENT_WRITE ], 1 );
+                break;
+
+            case 'y' :                          /* send PNG with 2D window */
+                http_send_png( Comm.http_pd[ HTTP_PARENT_WRITE ], 2 );
+                break;
+
+            case 'z' :               /* send PNG with cross section window */
+                http_send_png( Comm.http_pd[ HTTP_PARENT_WRITE ], 3 );
+                break;
+
 #if ! defined NDEBUG
             default :
                 fprintf( stderr, "Got stray request ('%c', %d) from http "
@@ -388,6 +405,80 @@ http_send_picture( int pd,
 }
 
 
+/*-----------------------------------------------------------------*
+ * Sends a PNG image of one of the windows directly to the server,
+ * first a line with a '1', then a line with the length of the
+ * image data and then the data. If the window isn't shown or the
+ * image can't be created just a line with a '0' is sent.
+ *-----------------------------------------------------------------*/
+
+static void
+http_send_png( int pd,
+               int type )
+{
+    const unsigned char *data;
+    size_t len;
+    char header[ 30 ];
+
+
+    if (    ! G.is_init
+         || ( type == 1 && G.dim == 2 )
+         || ( type == 2 && G.dim == 1 )
+         || ( type == 3 && ! G_2d.is_cut ) )
+    {
+        http_write( pd, "0\n", 2 );
+        return;
+    }
+
+    TRY
+    {
+        data = dump_window_png( type, &len );
+        TRY_SUCCESS;
+    }
+    OTHERWISE
+    {
+        http_write( pd, "0\n", 2 );
+        return;
+    }
+
+    sprintf( header, "1\n%lu\n", ( unsigned long ) len );
+    if ( http_write( pd, header, strlen( header ) ) )
+        http_write( pd, data, len );
+}
+
+
+/*--------------------------------------------------------------*
+ * Writes all of a buffer to the pipe to the server, returns if
+ * this succeeded.
+ *--------------------------------------------------------------*/
+
+static bool
+http_write( int          pd,
+            const void * buf,
+            size_t       len )
+{
+    const char *p = buf;
+
+
+    while ( len > 0 )
+    {
+        ssize_t n = write( pd, p, len );
+
+        if ( n < 0 )
+        {
+            if ( errno == EINTR )
+                continue;
+            return false;
+        }
+
+        p += n;
+        len -= n;
+    }
+
+    return true;
+}
+
+
 /*
  * Local variables:
  * tags-file-name: "../TAGS"
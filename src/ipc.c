@@ -39,23 +39,30 @@ union semun {
 /*-------------------------------------------------------------------*
  * Routine tries to get a shared memory segment - if this fails and
  * the reason is that no segments or no memory for segments are left
- * it waits for some time hoping for the parent process to remove
- * other segments in the mean time. On success it writes the "magic"
- * string "fsc2" into the start of the segment and returns a pointer
- * to the following memory. If it fails completely it returns NULL.
+ * (and 'wait' is set) it waits for some time hoping for the parent
+ * process to remove other segments in the mean time. On success it
+ * writes the "magic" string "fsc2" into the start of the segment and
+ * returns a pointer to the following memory. If it fails completely
+ * it returns NULL.
  *-------------------------------------------------------------------*/
 
 void *
-get_shm( int * shm_id,
-         long  len )
+get_shm( int  * shm_id,
+         long   len,
+         bool   wait )
 {
     raise_permissions( );
 
     while ( ( *shm_id = shmget( IPC_PRIVATE, len + 4,
                                 IPC_CREAT | S_IRUSR | S_IWUSR ) ) < 0 )
     {
-        if ( errno == ENOSPC || errno == ENOMEM ) /* wait for 10 ms */
-            fsc2_usleep( 10000, true );
+        if ( wait && ( errno == ENOSPC || errno == ENOMEM ) )
+            fsc2_usleep( 10000, true );           /* wait for 10 ms */
+        else if ( ! wait )
+        {
+            lower_permissions( );
+            return NULL;
+        }
         else                                      /* non-recoverable failure */
         {
             lower_permissions( );
@@ -144,9 +151,10 @@ detach_shm( const void * buf,
 
 /*-----------------------------------------------------------------*
  * Function tries to delete all shared memory. Shared memory is
- * used for data with the identifier stored in the message queue.
- * So if the message queue exists (i.e. isn't NULL) we run through
- * all identifiers, and if they're non-negative we delete the thus
+ * used for the ring buffer for data and for data sets too large
+ * for it with the identifier stored in the message queue. So if
+ * the message queue exists (i.e. isn't NULL) we run through all
+ * identifiers, and if they're non-negative we delete the thus
  * indexed segment. Finally, we delete the memory segment used for
  * the 'master key'.
  *-----------------------------------------------------------------*/
@@ -157,6 +165,14 @@ delete_all_shm( void )
     if ( Comm.MQ_ID < 0 )
         return;
 
+    /* Get rid of the ring buffer for data */
+
+    if ( Comm.data_ring_ID >= 0 )
+    {
+        detach_shm( Comm.data_ring, &Comm.data_ring_ID );
+        Comm.data_ring = NULL;
+    }
+
     raise_permissions( );
 
     /* If message queue exists check that all memory segments indexed in it
@@ -25,8 +25,9 @@
 #include "fsc2.h"
 
 
-void * get_shm( int * /* shm_id */,
-                long  /* len    */  );
+void * get_shm( int  * /* shm_id */,
+                long   /* len    */,
+                bool   /* wait   */  );
 
 void * attach_shm( int /* key */ );
 
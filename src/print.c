@@ -1626,25 +1626,32 @@ eps_draw_curve_1d( FILE       * fp,
             break;
     }
 
-    /* Find the very first point and move to it */
+    /* Find the very first point and move to it (in sliding window mode the
+       points are stored in a ring buffer starting at index 'cv->start') */
 
-    for ( k = 0; ! cv->points[ k ].exist && k < max_points; k++ )
-        /* empty */ ;
+    for ( k = 0; k < max_points; k++ )
+        if ( POINT_EXISTS( cv->points[ ( cv->start + k ) % max_points ] ) )
+            break;
 
     if ( k >= max_points )                  /* is there only just one ? */
         return;
 
     fprintf( fp, "%.2f %.2f m\n", x_0 + s2d[ X ] * ( k + cv->shift[ X ] ),
-             y_0 + s2d[ Y ] * ( cv->points[ k ].v + cv->shift[ Y ] ) );
+             y_0 + s2d[ Y ] * (   cv->points[ ( cv->start + k ) % max_points ]
+                                + cv->shift[ Y ] ) );
     k++;
 
     /* Draw all other points */
 
     for ( ; k < max_points; k++ )
-        if (  cv->points[ k ].exist )
+    {
+        double point = cv->points[ ( cv->start + k ) % max_points ];
+
+        if ( POINT_EXISTS( point ) )
             fprintf( fp, "%.2f %.2f l\n",
                      x_0 + s2d[ X ] * ( k + cv->shift[ X ] ),
-                     y_0 + s2d[ Y ] * ( cv->points[ k ].v + cv->shift[ Y ] ) );
+                     y_0 + s2d[ Y ] * ( point + cv->shift[ Y ] ) );
+    }
 
     fprintf( fp, "s gr\n" );
 }
@@ -1681,13 +1688,13 @@ eps_draw_surface( FILE * fp,
 
     /* Now draw points for which we have data */
 
-    for ( k = 0, j = 0; j < G_2d.ny; j++ )
-        for ( i = 0; i < G_2d.nx; k++, i++ )
+    for ( j = 0; j < G_2d.ny; j++ )
+        for ( k = j * G_2d.nx_max, i = 0; i < G_2d.nx; k++, i++ )
         {
-            if ( ! cv->points[ k ].exist )
+            if ( ! POINT_EXISTS( cv->points[ k ] ) )
                 continue;
 
-            i2rgb( cv->z_factor * ( cv->points[ k ].v + cv->shift[ Z ] ),
+            i2rgb( cv->z_factor * ( cv->points[ k ] + cv->shift[ Z ] ),
                    rgb );
             fprintf( fp,
                      "%.6f %.6f %.6f srgb\n"
@@ -1761,10 +1768,10 @@ eps_draw_contour( FILE * fp,
     /* Now draw the data */
 
     for ( g = 1.0, z = 0.0; z <= 1.0; g -= 0.045, z += 0.05 )
-        for ( k = 0, j = 0; j < G_2d.ny; j++ )
-            for ( i = 0; i < G_2d.nx; i++, k++ )
+        for ( j = 0; j < G_2d.ny; j++ )
+            for ( k = j * G_2d.nx_max, i = 0; i < G_2d.nx; i++, k++ )
             {
-                if ( ! cv->points[ k ].exist )
+                if ( ! POINT_EXISTS( cv->points[ k ] ) )
                 {
                     fprintf( fp, "0.5 sgr %.2f %.2f m 0 %.2f 2 copy rl "
                                  "%.2f 0 rl neg rl cp f\n",
@@ -1774,11 +1781,11 @@ eps_draw_contour( FILE * fp,
                     continue;
                 }
 
-                if ( i < G_2d.nx - 1 && cv->points[ k + 1 ].exist )
+                if ( i < G_2d.nx - 1 && POINT_EXISTS( cv->points[ k + 1 ] ) )
                 {
-                    z1 = cv->z_factor * ( cv->points[ k ].v + cv->shift[ Z ] );
+                    z1 = cv->z_factor * ( cv->points[ k ] + cv->shift[ Z ] );
                     z2 = cv->z_factor
-                                  * ( cv->points[ k + 1 ].v + cv->shift[ Z ] );
+                                  * ( cv->points[ k + 1 ] + cv->shift[ Z ] );
 
                     if ( ( z1 >= z && z2 < z ) || ( z1 < z && z2 >= z ) )
                     {
@@ -1791,11 +1798,10 @@ eps_draw_contour( FILE * fp,
                 }
 
                 if ( j < G_2d.ny - 1 &&
-                     cv->points[ ( j + 1 ) * G_2d.nx + i ].exist )
+                     POINT_EXISTS( cv->points[ k + G_2d.nx_max ] ) )
                 {
-                    z1 = cv->z_factor * ( cv->points[ k ].v + cv->shift[ Z ] );
-                    z2 = cv->z_factor * ( cv->points[ ( j + 1 )
-                                                      * G_2d.nx + i ].v
+                    z1 = cv->z_factor * ( cv->points[ k ] + cv->shift[ Z ] );
+                    z2 = cv->z_factor * (   cv->points[ k + G_2d.nx_max ]
                                           + cv->shift[ Z ] );
 
                     if ( ( z1 >= z && z2 < z ) || ( z1 < z && z2 >= z ) )
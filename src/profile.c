@@ -0,0 +1,396 @@
+/*
+ *  Copyright (C) 1999-2014 Jens Thoms Toerring
+ *
+ *  This file is part of fsc2.
+ *
+ *  Fsc2 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3, or (at your option)
+ *  any later version.
+ *
+ *  Fsc2 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*---------------------------------------------------------------------------*
+ * A simple profiler for the EXPERIMENT section, switched on by the
+ * '-profile' command line option. Whenever a new statement (or control
+ * structure) starts the wall clock and CPU time spent since the start of
+ * the previous one gets added to the statistics for the program token the
+ * previous statement started with. Calls of EDL functions are timed, too,
+ * and the time spent in functions from device modules is also charged to
+ * the statement as the time spent talking to devices (i.e. waiting for
+ * the GPIB bus etc.). At the end of the experiment a report, sorted by
+ * the time spent in each line of the EDL script and in each function,
+ * gets printed to the standard output. Only the experiment itself is
+ * profiled, not the test run.
+ *---------------------------------------------------------------------------*/
+
+
+#include "fsc2.h"
+
+
+extern size_t Num_Func;       /* number of built-in and listed functions */
+extern Func_T * Fncts;        /* structure for list of functions */
+
+
+typedef struct {
+    double        wall;       /* wall clock time */
+    double        cpu;        /* CPU time */
+    double        device;     /* wall clock time spent in module functions */
+    unsigned long count;      /* number of times executed or called */
+} Profile_Stat_T;
+
+typedef struct {
+    const char *   fname;
+    long           lc;
+    Profile_Stat_T stat;
+} Profile_Line_T;
+
+
+static Profile_Stat_T * Stmt_stats = NULL;    /* per program token */
+static Profile_Stat_T * Func_stats = NULL;    /* per function */
+static size_t Num_func_stats;
+static Prg_Token_T * Cur_stmt;                /* statement currently running */
+static double Stmt_wall;                      /* times at its start */
+static double Stmt_cpu;
+static double Start_wall;                     /* times at start of experiment */
+static double Start_cpu;
+static int Device_depth;                      /* nesting of module functions */
+
+
+static double wall_time( void );
+static double cpu_time( void );
+static int line_cmp( const void * a,
+                     const void * b );
+static int wall_cmp( const void * a,
+                     const void * b );
+static void report_lines( double total );
+static void report_functions( void );
+
+
+/*------------------------------------------------------------------*
+ * Sets up the profiler if profiling has been asked for, to be called
+ * by the child process immediately before the experiment starts.
+ *------------------------------------------------------------------*/
+
+void
+profile_init( void )
+{
+    if ( ! PROFILING || EDL.prg_length <= 0 )
+        return;
+
+    Stmt_stats = T_malloc( EDL.prg_length * sizeof *Stmt_stats );
+    memset( Stmt_stats, 0, EDL.prg_length * sizeof *Stmt_stats );
+
+    Num_func_stats = Num_Func;
+    if ( Num_func_stats > 0 )
+    {
+        Func_stats = T_malloc( Num_func_stats * sizeof *Func_stats );
+        memset( Func_stats, 0, Num_func_stats * sizeof *Func_stats );
+    }
+
+    Cur_stmt = NULL;
+    Device_depth = 0;
+    Start_wall = Stmt_wall = wall_time( );
+    Start_cpu = Stmt_cpu = cpu_time( );
+}
+
+
+/*-------------------------------------------------------------------*
+ * Called at the start of each statement or control structure of the
+ * EXPERIMENT section: the time spent since the previous one started
+ * gets charged to it. With a NULL argument just the statistics for
+ * the statement still running get updated.
+ *-------------------------------------------------------------------*/
+
+void
+profile_stmt( Prg_Token_T * tok )
+{
+    if ( Stmt_stats == NULL )
+        return;
+
+    double wall = wall_time( );
+    double cpu = cpu_time( );
+
+    if ( Cur_stmt != NULL )
+    {
+        Profile_Stat_T * s = Stmt_stats + ( Cur_stmt - EDL.prg_token );
+
+        s->wall += wall - Stmt_wall;
+        s->cpu += cpu - Stmt_cpu;
+    }
+
+    if ( ( Cur_stmt = tok ) != NULL )
+        Stmt_stats[ tok - EDL.prg_token ].count++;
+
+    Stmt_wall = wall;
+    Stmt_cpu = cpu;
+}
+
+
+/*-------------------------------------------------------------*
+ * Records the times at the start of a call of an EDL function.
+ *-------------------------------------------------------------*/
+
+void
+profile_func_start( Func_T         * f,
+                    Profile_Mark_T * mark )
+{
+    if ( Stmt_stats == NULL )
+        return;
+
+    if ( f->device != NULL )
+        Device_depth++;
+
+    mark->wall = wall_time( );
+    mark->cpu = cpu_time( );
+}
+
+
+/*-------------------------------------------------------------------*
+ * Adds the time spent in an EDL function to its statistics when the
+ * function returns (or throws an exception). For functions from
+ * device modules the time also gets charged to the statement as
+ * time spent dealing with devices, but only for the outermost one
+ * if they call each other.
+ *-------------------------------------------------------------------*/
+
+void
+profile_func_end( Func_T         * f,
+                  Profile_Mark_T * mark )
+{
+    if ( Stmt_stats == NULL )
+        return;
+
+    double wall = wall_time( ) - mark->wall;
+    double cpu = cpu_time( ) - mark->cpu;
+
+    if ( f >= Fncts && f < Fncts + Num_func_stats )
+    {
+        Profile_Stat_T * s = Func_stats + ( f - Fncts );
+
+        s->wall += wall;
+        s->cpu += cpu;
+        s->count++;
+    }
+
+    if ( f->device != NULL && --Device_depth == 0 && Cur_stmt != NULL )
+        Stmt_stats[ Cur_stmt - EDL.prg_token ].device += wall;
+}
+
+
+/*--------------------------------------------------------------------*
+ * Prints the report at the end of the experiment and releases all
+ * memory used by the profiler.
+ *--------------------------------------------------------------------*/
+
+void
+profile_report( void )
+{
+    if ( Stmt_stats == NULL )
+        return;
+
+    profile_stmt( NULL );
+
+    double wall = wall_time( ) - Start_wall;
+    double cpu = cpu_time( ) - Start_cpu;
+
+    printf( "\nProfile of experiment: %.3f s wall clock time, %.3f s CPU "
+            "time\n\n", wall, cpu );
+
+    TRY
+    {
+        report_lines( wall );
+        report_functions( );
+        TRY_SUCCESS;
+    }
+    OTHERWISE                   /* out of memory, give up on the report */
+    {
+        Stmt_stats = T_free( Stmt_stats );
+        Func_stats = T_free( Func_stats );
+        return;
+    }
+
+    Vars_Stack_Stats_T vs;
+    vars_stack_stats( &vs );
+
+    printf( "\nStack variables: %lu requested, %lu allocated, %lu names not "
+            "copied\n", vs.requests, vs.allocations, vs.shared_names );
+    fflush( stdout );
+
+    Stmt_stats = T_free( Stmt_stats );
+    Func_stats = T_free( Func_stats );
+}
+
+
+/*---------------------------------------------------------------------*
+ * Prints the statistics for the lines of the EDL script, sorted by the
+ * wall clock time spent in them. Statements on the same line (or in
+ * the same loop header) get lumped together.
+ *---------------------------------------------------------------------*/
+
+static void
+report_lines( double total )
+{
+    Profile_Line_T * lines = T_malloc( EDL.prg_length * sizeof *lines );
+    long num_lines = 0;
+
+    for ( long i = 0; i < EDL.prg_length; i++ )
+        if ( Stmt_stats[ i ].count > 0 )
+        {
+            lines[ num_lines ].fname = EDL.prg_token[ i ].Fname;
+            lines[ num_lines ].lc = EDL.prg_token[ i ].Lc;
+            lines[ num_lines++ ].stat = Stmt_stats[ i ];
+        }
+
+    qsort( lines, num_lines, sizeof *lines, line_cmp );
+
+    long n = 0;
+    for ( long i = 1; i < num_lines; i++ )
+    {
+        if ( ! line_cmp( lines + n, lines + i ) )
+        {
+            lines[ n ].stat.wall   += lines[ i ].stat.wall;
+            lines[ n ].stat.cpu    += lines[ i ].stat.cpu;
+            lines[ n ].stat.device += lines[ i ].stat.device;
+            lines[ n ].stat.count  += lines[ i ].stat.count;
+        }
+        else
+            lines[ ++n ] = lines[ i ];
+    }
+    if ( num_lines > 0 )
+        num_lines = n + 1;
+
+    qsort( lines, num_lines, sizeof *lines, wall_cmp );
+
+    printf( "   Wall [s]      %%     CPU [s]  Devices [s]    Executed  "
+            "Line\n" );
+
+    for ( long i = 0; i < num_lines; i++ )
+        printf( "%11.6f  %5.1f  %10.6f  %11.6f  %10lu  %s:%ld\n",
+                lines[ i ].stat.wall,
+                total > 0.0 ? 100.0 * lines[ i ].stat.wall / total : 0.0,
+                lines[ i ].stat.cpu, lines[ i ].stat.device,
+                lines[ i ].stat.count, lines[ i ].fname, lines[ i ].lc );
+
+    T_free( lines );
+}
+
+
+/*---------------------------------------------------------------------*
+ * Prints the statistics for all EDL functions that got called, sorted
+ * by the wall clock time spent in them (including the time spent in
+ * other functions they call).
+ *---------------------------------------------------------------------*/
+
+static void
+report_functions( void )
+{
+    if ( Num_func_stats == 0 )
+        return;
+
+    Profile_Line_T * fncts = T_malloc( Num_func_stats * sizeof *fncts );
+    long num_fncts = 0;
+
+    for ( size_t i = 0; i < Num_func_stats; i++ )
+        if ( Func_stats[ i ].count > 0 )
+        {
+            fncts[ num_fncts ].fname = Fncts[ i ].name;
+            fncts[ num_fncts ].lc = i;
+            fncts[ num_fncts++ ].stat = Func_stats[ i ];
+        }
+
+    qsort( fncts, num_fncts, sizeof *fncts, wall_cmp );
+
+    printf( "\n   Wall [s]     CPU [s]       Calls  Function\n" );
+
+    for ( long i = 0; i < num_fncts; i++ )
+    {
+        Device_T * dev = Fncts[ fncts[ i ].lc ].device;
+
+        printf( "%11.6f  %10.6f  %10lu  %s()%s%s%s\n",
+                fncts[ i ].stat.wall, fncts[ i ].stat.cpu,
+                fncts[ i ].stat.count, fncts[ i ].fname,
+                dev != NULL ? " [" : "", dev != NULL ? dev->name : "",
+                dev != NULL ? "]" : "" );
+    }
+
+    T_free( fncts );
+}
+
+
+/*--------------------------------------------------*
+ * Returns the current wall clock time in seconds.
+ *--------------------------------------------------*/
+
+static double
+wall_time( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + 1.0e-9 * ts.tv_nsec;
+}
+
+
+/*---------------------------------------------------------*
+ * Returns the CPU time used by the process in seconds.
+ *---------------------------------------------------------*/
+
+static double
+cpu_time( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_PROCESS_CPUTIME_ID, &ts );
+    return ts.tv_sec + 1.0e-9 * ts.tv_nsec;
+}
+
+
+/*------------------------------------------------------*
+ * Function for qsort()ing lines by file name and number
+ *------------------------------------------------------*/
+
+static int
+line_cmp( const void * a,
+          const void * b )
+{
+    const Profile_Line_T * la = a;
+    const Profile_Line_T * lb = b;
+    int res = strcmp( la->fname, lb->fname );
+
+    if ( res != 0 )
+        return res;
+    return la->lc < lb->lc ? -1 : ( la->lc > lb->lc );
+}
+
+
+/*---------------------------------------------------------------*
+ * Function for qsort()ing lines or functions by decreasing time
+ *---------------------------------------------------------------*/
+
+static int
+wall_cmp( const void * a,
+          const void * b )
+{
+    double wa = ( ( const Profile_Line_T * ) a )->stat.wall;
+    double wb = ( ( const Profile_Line_T * ) b )->stat.wall;
+
+    return wa > wb ? -1 : ( wa < wb );
+}
+
+
+/*
+ * Local variables:
+ * tags-file-name: "../TAGS"
+ * tab-width: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,63 @@
+/*
+ *  Copyright (C) 1999-2014 Jens Thoms Toerring
+ *
+ *  This file is part of fsc2.
+ *
+ *  Fsc2 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3, or (at your option)
+ *  any later version.
+ *
+ *  Fsc2 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+#if ! defined PROFILE_HEADER
+#define PROFILE_HEADER
+
+
+#include "fsc2.h"
+
+
+typedef struct {
+    double wall;              /* wall clock time at start of call */
+    double cpu;               /* CPU time at start of call */
+} Profile_Mark_T;
+
+
+/* Tells if the run of the experiment is to be profiled (only the child
+   process running the experiment ever sets up the profiler) */
+
+#define PROFILING  ( Fsc2_Internals.cmdline_flags & DO_PROFILE )
+
+
+void profile_init( void );
+
+void profile_stmt( Prg_Token_T * /* tok */ );
+
+void profile_func_start( Func_T         * /* f    */,
+                         Profile_Mark_T * /* mark */ );
+
+void profile_func_end( Func_T         * /* f    */,
+                       Profile_Mark_T * /* mark */ );
+
+void profile_report( void );
+
+
+#endif   /* ! PROFILE_HEADER */
+
+
+/*
+ * Local variables:
+ * tags-file-name: "../TAGS"
+ * tab-width: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
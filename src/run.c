@@ -197,6 +197,10 @@ run( void )
     if ( Fsc2_Internals.child_pid > 0 )   /* fork() was succeeded */
     {
         sigprocmask( SIG_SETMASK, &old_mask, NULL );
+
+        /* Only the first run of the experiment resumes from a checkpoint */
+
+        Fsc2_Internals.cmdline_flags &= ~ DO_RESUME;
         Fsc2_Internals.mode = PREPARATION;
         return true;
     }
@@ -1359,8 +1363,11 @@ run_child( void )
 
     /* Initialization is done and the child can start doing its real work */
 
+    profile_init( );
+
     TRY
     {
+        checkpoint_init( );              /* may also resume from one */
         do_measurement( );               /* run the experiment */
         Child_return_status = true;
         TRY_SUCCESS;
@@ -1368,6 +1375,9 @@ run_child( void )
     OTHERWISE                            /* catch all exceptions */
         Child_return_status = false;
 
+    checkpoint_done( Child_return_status );
+    profile_report( );
+
     run_child_exit_hooks( );
 
     close_all_files( );
@@ -1569,6 +1579,8 @@ child_confirmation_handler( int signo )
 static void
 do_measurement( void )
 {
+    bool is_compiled = exp_is_compiled( );
+
     EDL.react_to_do_quit = true;
 
     exp_runparser_init( );
@@ -1598,9 +1610,20 @@ do_measurement( void )
             if ( EDL.cur_prg_token == EDL.prg_token + EDL.On_Stop_Pos )
                 EDL.react_to_do_quit = EDL.do_quit = false;
 
-            /* Do whatever is necessary to do for the program token */
+            if ( CHECKPOINTING && checkpoint_due( ) )
+                checkpoint_write( );
 
-            deal_with_program_tokens( );
+            /* Run the compiled code or do whatever is necessary to do for
+               the program token */
+
+            if ( is_compiled )
+                run_compiled_exp( false );
+            else
+            {
+                if ( PROFILING )
+                    profile_stmt( EDL.cur_prg_token );
+                deal_with_program_tokens( );
+            }
 
             TRY_SUCCESS;
         }
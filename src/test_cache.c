@@ -0,0 +1,377 @@
+/*
+ *  Copyright (C) 1999-2014 Jens Thoms Toerring
+ *
+ *  This file is part of fsc2.
+ *
+ *  Fsc2 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3, or (at your option)
+ *  any later version.
+ *
+ *  Fsc2 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/*---------------------------------------------------------------------------*
+ * The test run of an EDL script can take quite some time for experiments
+ * with long loops. Since its outcome only depends on the program (as
+ * output by fsc2_clean, i.e. with all include files), the modules loaded
+ * and the function and device data bases, a key is calculated from all
+ * of them after the script has been parsed and, if the test run succeeded
+ * without any warnings, stored in the file '~/.fsc2/test_cache'. When the
+ * very same program gets tested again the test run is skipped and just
+ * the test hooks of the modules are run (some store their state in it,
+ * which their exp hook restores).
+ *
+ * Some modules need to see what happens during the test run, e.g. pulsers
+ * figure out the pulse sequences to be used. Such modules evaluate what
+ * happened in their end-of-test hook function and, if one of them is
+ * loaded, the test run is always done. The same holds when fsc2 was
+ * started with the '-forceTest' option or when the test run is all that's
+ * asked for.
+ *---------------------------------------------------------------------------*/
+
+
+#include "fsc2.h"
+
+
+/* Maximum number of keys kept in the cache file */
+
+#define TEST_CACHE_ENTRIES  100
+
+/* Offset and prime for the 64-bit FNV-1a hash function */
+
+#define FNV_OFFSET  0xcbf29ce484222325ULL
+#define FNV_PRIME   0x100000001b3ULL
+
+
+static char ** Config_files = NULL;     /* data base files that were read */
+static size_t Num_config_files = 0;
+static bool Key_valid = false;          /* set when 'Key' could be calculated */
+static unsigned long long Input_hash = FNV_OFFSET;  /* of fsc2_clean output */
+static unsigned long long Key;
+static int Errors_before[ 3 ];          /* numbers of messages before test */
+
+
+static bool compute_key( unsigned long long * key );
+static void hash_bytes( unsigned long long * h,
+                        const void         * data,
+                        size_t               len );
+static bool hash_file( unsigned long long * h,
+                       const char         * name );
+static bool hash_stat( unsigned long long * h,
+                       const char         * name );
+static char * cache_file_name( void );
+static size_t read_keys( FILE               * fp,
+                         unsigned long long * keys );
+
+
+/*-------------------------------------------------------------------*
+ * Records the name of a file (like the function and device data
+ * bases) that isn't part of the EDL program but still influences the
+ * outcome of the test run.
+ *-------------------------------------------------------------------*/
+
+void
+test_cache_add_file( const char * name )
+{
+    Config_files = T_realloc( Config_files,
+                              ( Num_config_files + 1 ) * sizeof *Config_files );
+    Config_files[ Num_config_files ] = T_strdup( name );
+    Num_config_files++;
+}
+
+
+/*-------------------------------------------------------------*
+ * Adds a character of the output of fsc2_clean (as read by the
+ * lexers for the different sections) to the key.
+ *-------------------------------------------------------------*/
+
+void
+test_cache_add_input( char c )
+{
+    Input_hash = ( Input_hash ^ ( unsigned char ) c ) * FNV_PRIME;
+}
+
+
+/*-----------------------------------------------------------*
+ * Forgets about everything from the previous test, to be
+ * called before a new EDL program gets parsed.
+ *-----------------------------------------------------------*/
+
+void
+test_cache_forget( void )
+{
+    while ( Num_config_files > 0 )
+        T_free( Config_files[ --Num_config_files ] );
+    Config_files = T_free( Config_files );
+    Key_valid = false;
+    Input_hash = FNV_OFFSET;
+}
+
+
+/*--------------------------------------------------------------------*
+ * Called after the EDL program has been parsed successfully to find
+ * out if a test run is needed. 'EDL.needs_test_run' gets set to false
+ * if the very same program already passed the test run before.
+ *--------------------------------------------------------------------*/
+
+void
+test_cache_check( void )
+{
+    EDL.needs_test_run = true;
+    Key_valid = false;
+
+    if ( Fsc2_Internals.cmdline_flags & ( FORCE_TEST | TEST_ONLY | DO_CHECK ) )
+        return;
+
+    for ( Device_T * cd = EDL.Device_List; cd != NULL; cd = cd->next )
+        if ( cd->is_loaded && cd->driver.is_end_of_test_hook )
+            return;
+
+    if ( ! compute_key( &Key ) )
+        return;
+
+    Key_valid = true;
+    for ( int i = 0; i < 3; i++ )
+        Errors_before[ i ] = EDL.compilation.error[ i ];
+
+    char * fname = cache_file_name( );
+    if ( fname == NULL )
+        return;
+
+    FILE * fp = fopen( fname, "r" );
+    T_free( fname );
+
+    if ( ! fp || ! fsc2_obtain_fcntl_lock( fp, F_RDLCK, true ) )
+    {
+        if ( fp )
+            fclose( fp );
+        return;
+    }
+
+    unsigned long long keys[ TEST_CACHE_ENTRIES ];
+    size_t num_keys = read_keys( fp, keys );
+
+    fsc2_release_fcntl_lock( fp );
+    fclose( fp );
+
+    for ( size_t i = 0; i < num_keys; i++ )
+        if ( keys[ i ] == Key )
+        {
+            EDL.needs_test_run = false;
+            eprint( NO_ERROR, false, "Test run skipped, the program, its "
+                    "modules and include files are unchanged since it "
+                    "passed the test run before.\n" );
+            return;
+        }
+}
+
+
+/*--------------------------------------------------------------------*
+ * Called after a test run has been finished successfully. Unless
+ * there were warnings during the test run the key for the program
+ * gets added to the cache file (removing the oldest one if the file
+ * would become too long).
+ *--------------------------------------------------------------------*/
+
+void
+test_cache_store( void )
+{
+    if ( ! Key_valid )
+        return;
+
+    for ( int i = 0; i < 3; i++ )
+        if ( EDL.compilation.error[ i ] != Errors_before[ i ] )
+            return;
+
+    char * fname = cache_file_name( );
+    if ( fname == NULL )
+        return;
+
+    FILE * fp = fopen( fname, "r+" );
+    if ( fp == NULL && errno == ENOENT )
+        fp = fopen( fname, "w+" );
+    T_free( fname );
+
+    if ( ! fp || ! fsc2_obtain_fcntl_lock( fp, F_WRLCK, true ) )
+    {
+        if ( fp )
+            fclose( fp );
+        return;
+    }
+
+    unsigned long long keys[ TEST_CACHE_ENTRIES ];
+    size_t num_keys = read_keys( fp, keys );
+    size_t first = num_keys == TEST_CACHE_ENTRIES ? 1 : 0;
+
+    rewind( fp );
+    if ( ftruncate( fileno( fp ), 0 ) == 0 )
+    {
+        for ( size_t i = first; i < num_keys; i++ )
+            if ( keys[ i ] != Key )
+                fprintf( fp, "%016llx\n", keys[ i ] );
+        fprintf( fp, "%016llx\n", Key );
+    }
+
+    fsc2_release_fcntl_lock( fp );
+    fclose( fp );
+}
+
+
+/*---------------------------------------------------------------------*
+ * Calculates the key for the current program from the output of
+ * fsc2_clean, the contents of the data base files and the names, sizes
+ * and modification times of fsc2 itself and all loaded modules (in the
+ * order they were loaded in). Returns false if one of the files can't
+ * be accessed.
+ *---------------------------------------------------------------------*/
+
+static bool
+compute_key( unsigned long long * key )
+{
+    unsigned long long h = FNV_OFFSET;
+
+    if ( ! hash_stat( &h, "/proc/self/exe" ) )
+        return false;
+
+    hash_bytes( &h, &Input_hash, sizeof Input_hash );
+
+    for ( size_t i = 0; i < Num_config_files; i++ )
+        if ( ! hash_file( &h, Config_files[ i ] ) )
+            return false;
+
+    for ( Device_T * cd = EDL.Device_List; cd != NULL; cd = cd->next )
+        if (    cd->is_loaded
+             && (    cd->driver.lib_name == NULL
+                  || ! hash_stat( &h, cd->driver.lib_name ) ) )
+            return false;
+
+    *key = h;
+    return true;
+}
+
+
+/*-----------------------------------------------------*
+ * Adds a number of bytes to the hash value in 'h'.
+ *-----------------------------------------------------*/
+
+static void
+hash_bytes( unsigned long long * h,
+            const void         * data,
+            size_t               len )
+{
+    const unsigned char * p = data;
+
+    while ( len-- > 0 )
+        *h = ( *h ^ *p++ ) * FNV_PRIME;
+}
+
+
+/*------------------------------------------------------------*
+ * Adds the name and the complete content of a file to the
+ * hash value in 'h'.
+ *------------------------------------------------------------*/
+
+static bool
+hash_file( unsigned long long * h,
+           const char         * name )
+{
+    FILE * fp = fopen( name, "r" );
+    char buf[ 8192 ];
+    size_t len;
+
+    if ( fp == NULL )
+        return false;
+
+    hash_bytes( h, name, strlen( name ) + 1 );
+
+    while ( ( len = fread( buf, 1, sizeof buf, fp ) ) > 0 )
+        hash_bytes( h, buf, len );
+
+    bool ok = ! ferror( fp );
+    fclose( fp );
+    return ok;
+}
+
+
+/*----------------------------------------------------------------*
+ * Adds the name, size and modification time of a file to the hash
+ * value in 'h'.
+ *----------------------------------------------------------------*/
+
+static bool
+hash_stat( unsigned long long * h,
+           const char         * name )
+{
+    struct stat buf;
+
+    if ( stat( name, &buf ) == -1 )
+        return false;
+
+    hash_bytes( h, name, strlen( name ) + 1 );
+    hash_bytes( h, &buf.st_size, sizeof buf.st_size );
+    hash_bytes( h, &buf.st_mtime, sizeof buf.st_mtime );
+    return true;
+}
+
+
+/*-------------------------------------------------------------*
+ * Returns the (allocated) name of the cache file or NULL if the
+ * home directory of the user can't be determined.
+ *-------------------------------------------------------------*/
+
+static char *
+cache_file_name( void )
+{
+    struct passwd * ue = getpwuid( getuid( ) );
+    if ( ! ue || ! ue->pw_dir || ! *ue->pw_dir )
+        return NULL;
+
+    char * fname = NULL;
+    TRY
+    {
+        fname = get_string( "%s/.fsc2/test_cache", ue->pw_dir );
+        TRY_SUCCESS;
+    }
+    OTHERWISE
+        return NULL;
+
+    return fname;
+}
+
+
+/*---------------------------------------------------------------*
+ * Reads in the keys from the cache file, returns how many there
+ * were (lines that aren't keys are skipped).
+ *---------------------------------------------------------------*/
+
+static size_t
+read_keys( FILE               * fp,
+           unsigned long long * keys )
+{
+    char line[ 64 ];
+    size_t num_keys = 0;
+
+    while (    num_keys < TEST_CACHE_ENTRIES
+            && fgets( line, sizeof line, fp ) != NULL )
+        if ( sscanf( line, "%llx", keys + num_keys ) == 1 )
+            num_keys++;
+
+    return num_keys;
+}
+
+
+/*
+ * Local variables:
+ * tags-file-name: "../TAGS"
+ * tab-width: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
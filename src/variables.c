@@ -144,8 +144,56 @@
 #include "fsc2.h"
 
 
+/* Variables in the variables list are also kept in two open-addressing hash
+   tables, one keyed by the variables name (only for variables that have a
+   name), used by vars_get(), and one keyed by the address of the variable
+   structure (for all variables in the list), used by vars_exist(). Both
+   tables have a size that's a power of 2 and are never more than half
+   filled. */
+
+#define VAR_TABLE_MIN_SIZE  64
+
+typedef struct {
+    Var_T  ** slots;
+    size_t    size;
+    size_t    count;
+    bool      by_name;
+} Var_Table_T;
+
+static Var_Table_T Name_Table = { NULL, 0, 0, true };
+static Var_Table_T Addr_Table = { NULL, 0, 0, false };
+
+
+/* Variables on the stack are allocated from a pool of chunks of variable
+   structures instead of getting malloc()'ed and free()'ed one by one. A
+   variable popped from the stack goes into a free list from which the next
+   pushed variable is taken, so for all but the very first evaluations no
+   memory allocations are needed anymore. The chunks only get released in
+   vars_clean_up(). */
+
+#define VAR_POOL_CHUNK_SIZE  256
+
+static Var_T *  Free_Stack_Vars = NULL;
+static Var_T ** Pool_Chunks     = NULL;
+static size_t   Num_Pool_Chunks = 0;
+static Vars_Stack_Stats_T Stack_Stats = { 0, 0, 0 };
+
+
 /* locally used functions */
 
+static size_t var_name_hash( const char * name );
+static size_t var_table_hash( Var_Table_T * t,
+                              Var_T       * v );
+static void var_table_insert( Var_Table_T * t,
+                              Var_T       * v );
+static void var_table_remove( Var_Table_T * t,
+                              Var_T       * v );
+static bool var_table_contains( Var_Table_T * t,
+                                Var_T       * v );
+static void var_table_clear( Var_Table_T * t );
+static Var_T * stack_var_get( void );
+static void stack_var_put( Var_T * v );
+static void stack_var_pool_clear( void );
 static void free_all_vars( void );
 static Var_T * vars_push_submatrix( Var_T *    from,
                                     Var_Type_T type,
@@ -178,15 +226,259 @@ vars_get( const char * name )
 {
     /* Try to find the variable with the name passed to the function */
 
-    for ( Var_T * v = EDL.Var_List; v; v = v->next )
+    if ( ! Name_Table.slots )
+        return NULL;
+
+    size_t mask = Name_Table.size - 1;
+
+    for ( size_t i = var_name_hash( name ) & mask; Name_Table.slots[ i ];
+          i = ( i + 1 ) & mask )
+        if ( ! strcmp( Name_Table.slots[ i ]->name, name ) )
+            return Name_Table.slots[ i ];
+
+    return NULL;
+}
+
+
+/*-----------------------------------------------------------*
+ * Returns a hash value for a variable name (FNV-1a hash)
+ *-----------------------------------------------------------*/
+
+static size_t
+var_name_hash( const char * name )
+{
+    size_t h = 2166136261U;
+
+    while ( *name )
     {
-        if ( ! v->name )
+        h ^= ( unsigned char ) *name++;
+        h *= 16777619U;
+    }
+
+    return h;
+}
+
+
+/*-----------------------------------------------------------*
+ * Returns the hash value a variable is stored under in one
+ * of the two hash tables, i.e. either the hash of its name
+ * or of the address of the variable structure.
+ *-----------------------------------------------------------*/
+
+static size_t
+var_table_hash( Var_Table_T * t,
+                Var_T       * v )
+{
+    if ( t->by_name )
+        return var_name_hash( v->name );
+
+    size_t h = ( size_t ) v / sizeof *v;
+    return h ^ ( h >> 7 ) ^ ( h >> 17 );
+}
+
+
+/*-----------------------------------------------------------*
+ * Adds a variable to a hash table, doubling the size of the
+ * table (and rehashing all entries) when it gets half full.
+ *-----------------------------------------------------------*/
+
+static void
+var_table_insert( Var_Table_T * t,
+                  Var_T       * v )
+{
+    size_t mask;
+
+    if ( 2 * ( t->count + 1 ) > t->size )
+    {
+        size_t old_size = t->size;
+        Var_T **old_slots = t->slots;
+
+        t->size = old_size ? 2 * old_size : VAR_TABLE_MIN_SIZE;
+        t->slots = T_malloc( t->size * sizeof *t->slots );
+        for ( size_t i = 0; i < t->size; i++ )
+            t->slots[ i ] = NULL;
+        t->count = 0;
+
+        for ( size_t i = 0; i < old_size; i++ )
+            if ( old_slots[ i ] )
+                var_table_insert( t, old_slots[ i ] );
+
+        T_free( old_slots );
+    }
+
+    mask = t->size - 1;
+
+    size_t i;
+    for ( i = var_table_hash( t, v ) & mask; t->slots[ i ];
+          i = ( i + 1 ) & mask )
+        /* empty */ ;
+
+    t->slots[ i ] = v;
+    t->count++;
+}
+
+
+/*-----------------------------------------------------------*
+ * Removes a variable from a hash table. Entries following
+ * the removed one in the same cluster get moved back if
+ * necessary, so no tombstones are needed.
+ *-----------------------------------------------------------*/
+
+static void
+var_table_remove( Var_Table_T * t,
+                  Var_T       * v )
+{
+    if ( ! t->slots )
+        return;
+
+    size_t mask = t->size - 1;
+    size_t i;
+
+    for ( i = var_table_hash( t, v ) & mask; t->slots[ i ] != v;
+          i = ( i + 1 ) & mask )
+        if ( ! t->slots[ i ] )
+            return;
+
+    for ( size_t j = ( i + 1 ) & mask; t->slots[ j ]; j = ( j + 1 ) & mask )
+    {
+        size_t k = var_table_hash( t, t->slots[ j ] ) & mask;
+
+        /* Leave the entry alone if its home slot is (cyclically) in the
+           range ]i, j], otherwise move it into the hole */
+
+        if ( i <= j ? ( i < k && k <= j ) : ( i < k || k <= j ) )
             continue;
-        if ( ! strcmp( v->name, name ) )
-            return v;
+
+        t->slots[ i ] = t->slots[ j ];
+        i = j;
     }
 
-    return NULL;
+    t->slots[ i ] = NULL;
+    t->count--;
+}
+
+
+/*-----------------------------------------------------------*
+ * Checks if a variable is stored in a hash table
+ *-----------------------------------------------------------*/
+
+static bool
+var_table_contains( Var_Table_T * t,
+                    Var_T       * v )
+{
+    if ( ! t->slots )
+        return false;
+
+    size_t mask = t->size - 1;
+
+    for ( size_t i = var_table_hash( t, v ) & mask; t->slots[ i ];
+          i = ( i + 1 ) & mask )
+        if ( t->slots[ i ] == v )
+            return true;
+
+    return false;
+}
+
+
+/*-----------------------------------------------------------*
+ * Releases the memory of a hash table
+ *-----------------------------------------------------------*/
+
+static void
+var_table_clear( Var_Table_T * t )
+{
+    t->slots = T_free( t->slots );
+    t->size = t->count = 0;
+}
+
+
+/*-----------------------------------------------------------*
+ * Returns a new (uninitialized) variable structure for the
+ * stack, taken from the free list if possible. If the free
+ * list is empty a new chunk of structures is allocated.
+ *-----------------------------------------------------------*/
+
+static Var_T *
+stack_var_get( void )
+{
+    Stack_Stats.requests++;
+
+    if ( ! Free_Stack_Vars )
+    {
+        Var_T *chunk = T_malloc( VAR_POOL_CHUNK_SIZE * sizeof *chunk );
+
+        TRY
+        {
+            Pool_Chunks = T_realloc( Pool_Chunks,
+                                       ( Num_Pool_Chunks + 1 )
+                                     * sizeof *Pool_Chunks );
+            TRY_SUCCESS;
+        }
+        OTHERWISE
+        {
+            T_free( chunk );
+            RETHROW;
+        }
+
+        Pool_Chunks[ Num_Pool_Chunks++ ] = chunk;
+
+        for ( size_t i = 0; i < VAR_POOL_CHUNK_SIZE - 1; i++ )
+            chunk[ i ].next = chunk + i + 1;
+        chunk[ VAR_POOL_CHUNK_SIZE - 1 ].next = NULL;
+        Free_Stack_Vars = chunk;
+
+        Stack_Stats.allocations++;
+    }
+
+    Var_T *v = Free_Stack_Vars;
+    Free_Stack_Vars = v->next;
+    return v;
+}
+
+
+/*-----------------------------------------------------------*
+ * Puts a variable structure no longer used back into the
+ * free list of stack variables
+ *-----------------------------------------------------------*/
+
+static void
+stack_var_put( Var_T * v )
+{
+    v->next = Free_Stack_Vars;
+    Free_Stack_Vars = v;
+}
+
+
+/*-----------------------------------------------------------*
+ * Releases all memory of the pool of stack variables - must
+ * only be called when the stack is empty.
+ *-----------------------------------------------------------*/
+
+static void
+stack_var_pool_clear( void )
+{
+    fsc2_assert( EDL.Var_Stack == NULL );
+
+    for ( size_t i = 0; i < Num_Pool_Chunks; i++ )
+        T_free( Pool_Chunks[ i ] );
+    Pool_Chunks = T_free( Pool_Chunks );
+    Num_Pool_Chunks = 0;
+    Free_Stack_Vars = NULL;
+}
+
+
+/*-----------------------------------------------------------*
+ * Stores the statistics about the stack variables in 'stats',
+ * i.e. how many variables were pushed onto the stack, how many
+ * chunks of memory had to be allocated for them and how often
+ * the names of function variables could be shared instead of
+ * having to be copied.
+ *-----------------------------------------------------------*/
+
+void
+vars_stack_stats( Vars_Stack_Stats_T * stats )
+{
+    *stats = Stack_Stats;
 }
 
 
@@ -222,6 +514,10 @@ vars_new( const char * name )
         EDL.Var_List->prev = vp;     /* (if this isn't the very first) */
     EDL.Var_List = vp;               /* make it the head of the list */
 
+    var_table_insert( &Addr_Table, vp );
+    if ( vp->name )
+        var_table_insert( &Name_Table, vp );
+
     return vp;
 }
 
@@ -293,8 +589,13 @@ vars_free( Var_T * v,
             break;
     }
 
+    var_table_remove( &Addr_Table, v );
+
     if ( v->name )
+    {
+        var_table_remove( &Name_Table, v );
         v->name = T_free( v->name );
+    }
 
     if ( ! v->prev )
         EDL.Var_List = v->next;
@@ -319,6 +620,12 @@ free_all_vars( void )
 {
     for ( Var_T * v = EDL.Var_List; v; )
         v = vars_free( v, false );
+
+    if ( ! EDL.Var_List )
+    {
+        var_table_clear( &Name_Table );
+        var_table_clear( &Addr_Table );
+    }
 }
 
 
@@ -343,6 +650,7 @@ void
 vars_clean_up( void )
 {
     vars_del_stack( );
+    stack_var_pool_clear( );
     free_all_vars( );
     vars_iter( NULL );
 }
@@ -537,7 +845,7 @@ vars_push( Var_Type_T type,
     /* Get memory for the new variable to be appended to the stack, set its
        type and initialize some fields */
 
-    Var_T * nsv = T_malloc( sizeof *nsv );
+    Var_T * nsv = stack_var_get( );
     nsv->name   = NULL;
     nsv->type   = type;
     nsv->next   = NULL;
@@ -687,7 +995,7 @@ vars_make( Var_Type_T type,
 
     if ( src->flags & ON_STACK )
     {
-        nv        = T_malloc( sizeof *nv );
+        nv        = stack_var_get( );
         nv->name  = NULL;
         nv->next  = NULL;
         nv->flags = ON_STACK;
@@ -972,9 +1280,11 @@ vars_pop( Var_T * v )
             break;
     }
 
-    if ( v->name )
+    if ( v->flags & SHARED_NAME )
+        Stack_Stats.shared_names++;
+    else if ( v->name )
         T_free( v->name );
-    T_free( v );
+    stack_var_put( v );
 
     return ret;
 }
@@ -1056,8 +1366,8 @@ vars_check( Var_T * v,
 
 /*---------------------------------------------------------------*
  * vars_exist() checks if a variable really exists by looking it
- * up in the variable list or on the variable stack (depending
- * on what type of variable it is).
+ * up in the variable list (via its hash table) or on the variable
+ * stack (depending on what type of variable it is).
  *---------------------------------------------------------------*/
 
 bool
@@ -1065,14 +1375,13 @@ vars_exist( Var_T * v )
 {
     fsc2_assert( v != NULL );
 
+    if ( ! ( v->flags & ON_STACK ) )
+        return var_table_contains( &Addr_Table, v );
+
     Var_T *lp;
 
-    if ( v->flags & ON_STACK )
-        for ( lp = EDL.Var_Stack; lp && lp != v; lp = lp->next )
-            /* empty */ ;
-    else
-        for ( lp = EDL.Var_List; lp && lp != v; lp = lp->next )
-            /* empty */ ;
+    for ( lp = EDL.Var_Stack; lp && lp != v; lp = lp->next )
+        /* empty */ ;
 
     return lp == v;
 }
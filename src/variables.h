@@ -97,6 +97,13 @@ struct Var {
     ( ( a )->type & ( INT_VAR | INT_ARR | INT_REF | INT_PTR ) )
 
 
+/* A 1D array that's a temporary or on the stack (i.e. owns a copy of its
+   data that's going to be thrown away) can be overwritten with the result
+   of an arithmetic operation it's an operand of */
+
+#define IS_SCRATCH_ARR( a )  ( ( a )->flags & ( IS_TEMP | ON_STACK ) )
+
+
 #define RHS_TYPES \
     ( INT_VAR | FLOAT_VAR | INT_ARR | FLOAT_ARR | INT_REF | FLOAT_REF )
 
@@ -108,10 +115,18 @@ enum {
     IS_TEMP            = ( 1 << 3 ),       /*    8 */
     EXISTS_BEFORE_TEST = ( 1 << 4 ),       /*   16 */
     DONT_RECURSE       = ( 1 << 5 ),       /*   32 */
-    INIT_ONLY          = ( 1 << 6 )        /*   64 */
+    INIT_ONLY          = ( 1 << 6 ),       /*   64 */
+    SHARED_NAME        = ( 1 << 7 )        /*  128 */
 };
 
 
+typedef struct {
+    unsigned long requests;        /* number of variables pushed on stack */
+    unsigned long allocations;     /* number of memory chunks allocated */
+    unsigned long shared_names;    /* number of function names not copied */
+} Vars_Stack_Stats_T;
+
+
 enum {
     COMP_EQUAL,
     COMP_UNEQUAL,
@@ -164,6 +179,8 @@ void vars_save_restore( bool /* flag */ );
 Var_T * vars_free( Var_T * /* v             */,
                    bool    /* also_nameless */  );
 
+void vars_stack_stats( Vars_Stack_Stats_T * /* stats */ );
+
 
 #endif  /* ! VARIABLES_HEADER */
 
@@ -169,7 +169,7 @@ vars_int_var_div( Var_T * v1,
             break;
 
         case INT_ARR :
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( INT_ARR, v2->val.lpnt, ( long ) v2->len );
@@ -196,7 +196,7 @@ vars_int_var_div( Var_T * v1,
             break;
 
         case FLOAT_ARR :
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( FLOAT_ARR, v2->val.dpnt,
@@ -344,7 +344,7 @@ vars_float_var_div( Var_T * v1,
             break;
 
         case FLOAT_ARR :
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( FLOAT_ARR, v2->val.dpnt,
@@ -453,7 +453,7 @@ vars_int_arr_div( Var_T * v1,
             break;
 
         case INT_ARR :
-            if ( v1->flags & IS_TEMP && v1 != v2 )
+            if ( vars_arr_swap_for_dest( v1, v2 ) )
             {
                 Var_T * vt = v1;
                 v1 = v2;
@@ -461,7 +461,7 @@ vars_int_arr_div( Var_T * v1,
                 exc = ! exc;
             }
 
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( INT_ARR, v2->val.lpnt, ( long ) v2->len );
@@ -488,7 +488,7 @@ vars_int_arr_div( Var_T * v1,
             break;
 
         case FLOAT_ARR :
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( FLOAT_ARR, v2->val.dpnt,
@@ -567,7 +567,7 @@ vars_float_arr_div( Var_T * v1,
             break;
 
         case FLOAT_ARR :
-            if ( v1->flags & IS_TEMP )
+            if ( vars_arr_swap_for_dest( v1, v2 ) )
             {
                 Var_T * vt = v1;
                 v1 = v2;
@@ -575,7 +575,7 @@ vars_float_arr_div( Var_T * v1,
                 exc = ! exc;
             }
 
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( FLOAT_ARR, v2->val.dpnt,
@@ -168,7 +168,7 @@ vars_int_var_mod( Var_T * v1,
             break;
 
         case INT_ARR :
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( INT_ARR, v2->val.lpnt, ( long ) v2->len );
@@ -195,7 +195,7 @@ vars_int_var_mod( Var_T * v1,
             break;
 
         case FLOAT_ARR :
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( FLOAT_ARR, v2->val.dpnt,
@@ -345,7 +345,7 @@ vars_float_var_mod( Var_T * v1,
             break;
 
         case FLOAT_ARR :
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( FLOAT_ARR, v2->val.dpnt,
@@ -452,7 +452,7 @@ vars_int_arr_mod( Var_T * v1,
             break;
 
         case INT_ARR :
-            if ( v1->flags & IS_TEMP && v1 != v2 )
+            if ( vars_arr_swap_for_dest( v1, v2 ) )
             {
                 Var_T * vt = v1;
                 v1 = v2;
@@ -460,7 +460,7 @@ vars_int_arr_mod( Var_T * v1,
                 exc = ! exc;
             }
 
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( INT_ARR, v2->val.lpnt, ( long ) v2->len );
@@ -489,7 +489,7 @@ vars_int_arr_mod( Var_T * v1,
             break;
 
         case FLOAT_ARR :
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( FLOAT_ARR, v2->val.dpnt,
@@ -572,7 +572,7 @@ vars_float_arr_mod( Var_T * v1,
             break;
 
         case FLOAT_ARR :
-            if ( v1->flags & IS_TEMP )
+            if ( vars_arr_swap_for_dest( v1, v2 ) )
             {
                 Var_T * vt = v1;
                 v1 = v2;
@@ -580,7 +580,7 @@ vars_float_arr_mod( Var_T * v1,
                 exc = ! exc;
             }
 
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( FLOAT_ARR, v2->val.dpnt,
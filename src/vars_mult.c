@@ -123,14 +123,19 @@ vars_int_var_mult( Var_T * v1,
             break;
 
         case INT_ARR :
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( INT_ARR, v2->val.lpnt, ( long ) v2->len );
 
             if ( v1->val.lval != 1 )
-                for ( ssize_t i = 0; i < v2->len; i++ )
-                    new_var->val.lpnt[ i ] *= v1->val.lval;
+            {
+                long a = v1->val.lval;
+                long *dp = new_var->val.lpnt;
+
+                for ( ssize_t i = 0, len = new_var->len; i < len; i++ )
+                    dp[ i ] *= a;
+            }
 
             vars_pop( v1 );
             if ( new_var != v2 )
@@ -139,15 +144,20 @@ vars_int_var_mult( Var_T * v1,
             break;
 
         case FLOAT_ARR :
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( FLOAT_ARR, v2->val.dpnt,
                                      ( long ) v2->len );
 
             if ( v1->val.lval != 1 )
-                for ( ssize_t i = 0; i < new_var->len; i++ )
-                    new_var->val.dpnt[ i ] *= ( double ) v1->val.lval;
+            {
+                double a = v1->val.lval;
+                double *dp = new_var->val.dpnt;
+
+                for ( ssize_t i = 0, len = new_var->len; i < len; i++ )
+                    dp[ i ] *= a;
+            }
 
             vars_pop( v1 );
             if ( new_var != v2 )
@@ -224,24 +234,34 @@ vars_float_var_mult( Var_T * v1,
         case INT_ARR :
             new_var = vars_push( FLOAT_ARR, NULL, ( long ) v2->len );
 
-            for ( ssize_t i = 0; i < new_var->len; i++ )
-                new_var->val.dpnt[ i ]
-                                 = v1->val.dval * ( double ) v2->val.lpnt[ i ];
+            {
+                double a = v1->val.dval;
+                double *dp = new_var->val.dpnt;
+                long *sp = v2->val.lpnt;
+
+                for ( ssize_t i = 0, len = new_var->len; i < len; i++ )
+                    dp[ i ] = a * ( double ) sp[ i ];
+            }
 
             vars_pop( v1 );
             vars_pop( v2 );
             break;
 
         case FLOAT_ARR :
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( FLOAT_ARR, v2->val.dpnt,
                                      ( long ) v2->len );
 
             if ( v1->val.dval != 1.0 )
-                for ( ssize_t i = 0; i < new_var->len; i++ )
-                    new_var->val.dpnt[ i ] *= v1->val.dval;
+            {
+                double a = v1->val.dval;
+                double *dp = new_var->val.dpnt;
+
+                for ( ssize_t i = 0, len = new_var->len; i < len; i++ )
+                    dp[ i ] *= a;
+            }
 
             vars_pop( v1 );
             if ( new_var != v2 )
@@ -310,20 +330,25 @@ vars_int_arr_mult( Var_T * v1,
             break;
 
         case INT_ARR :
-            if ( v1->flags & IS_TEMP )
+            if ( vars_arr_swap_for_dest( v1, v2 ) )
             {
                 Var_T * vt = v1;
                 v1 = v2;
                 v2 = vt;
             }
 
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( INT_ARR, v2->val.lpnt, ( long ) v2->len );
 
-            for ( ssize_t i = 0; i < new_var->len; i++ )
-                new_var->val.lpnt[ i ] *= v1->val.lpnt[ i ];
+            {
+                long *dp = new_var->val.lpnt;
+                long *sp = v1->val.lpnt;
+
+                for ( ssize_t i = 0, len = new_var->len; i < len; i++ )
+                    dp[ i ] *= sp[ i ];
+            }
 
             vars_pop( v1 );
             if ( new_var != v2 )
@@ -331,14 +356,19 @@ vars_int_arr_mult( Var_T * v1,
             break;
 
         case FLOAT_ARR :
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( FLOAT_ARR, v2->val.dpnt,
                                      ( long ) v2->len );
 
-            for ( ssize_t i = 0; i < v1->len; i++ )
-                new_var->val.dpnt[ i ] *= ( double ) v1->val.lpnt[ i ];
+            {
+                double *dp = new_var->val.dpnt;
+                long *sp = v1->val.lpnt;
+
+                for ( ssize_t i = 0, len = v1->len; i < len; i++ )
+                    dp[ i ] *= ( double ) sp[ i ];
+            }
 
             if ( v1 != v2 )
                 vars_pop( v1 );
@@ -395,21 +425,26 @@ vars_float_arr_mult( Var_T * v1,
             break;
 
         case FLOAT_ARR :
-            if ( v1->flags & IS_TEMP )
+            if ( vars_arr_swap_for_dest( v1, v2 ) )
             {
                 Var_T * vt = v1;
                 v1 = v2;
                 v2 = vt;
             }
 
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( FLOAT_ARR, v2->val.dpnt,
                                      ( long ) v2->len );
 
-            for ( ssize_t i = 0; i < new_var->len; i++ )
-                new_var->val.dpnt[ i ] *= v1->val.dpnt[ i ];
+            {
+                double *dp = new_var->val.dpnt;
+                double *sp = v1->val.dpnt;
+
+                for ( ssize_t i = 0, len = new_var->len; i < len; i++ )
+                    dp[ i ] *= sp[ i ];
+            }
 
             if ( v1 != v2 )
                 vars_pop( v1 );
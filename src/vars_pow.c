@@ -164,7 +164,7 @@ vars_int_var_pow( Var_T * v1,
             break;
 
         case INT_ARR :
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( INT_ARR, v2->val.lpnt, ( long ) v2->len );
@@ -187,7 +187,7 @@ vars_int_var_pow( Var_T * v1,
             break;
 
         case FLOAT_ARR :
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( FLOAT_ARR, v2->val.dpnt,
@@ -339,7 +339,7 @@ vars_float_var_pow( Var_T * v1,
             break;
 
         case FLOAT_ARR :
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( FLOAT_ARR, v2->val.dpnt,
@@ -446,7 +446,7 @@ vars_int_arr_pow( Var_T * v1,
             break;
 
         case INT_ARR :
-            if ( v1->flags & IS_TEMP && v1 != v2 )
+            if ( vars_arr_swap_for_dest( v1, v2 ) )
             {
                 Var_T * vt = v1;
                 v1 = v2;
@@ -454,7 +454,7 @@ vars_int_arr_pow( Var_T * v1,
                 exc = ! exc;
             }
 
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( INT_ARR, v2->val.lpnt, ( long ) v2->len );
@@ -479,7 +479,7 @@ vars_int_arr_pow( Var_T * v1,
             break;
 
         case FLOAT_ARR :
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( FLOAT_ARR, v2->val.dpnt,
@@ -564,7 +564,7 @@ vars_float_arr_pow( Var_T * v1,
             break;
 
         case FLOAT_ARR :
-            if ( v1->flags & IS_TEMP )
+            if ( vars_arr_swap_for_dest( v1, v2 ) )
             {
                 Var_T * vt = v1;
                 v1 = v2;
@@ -572,7 +572,7 @@ vars_float_arr_pow( Var_T * v1,
                 exc = ! exc;
             }
 
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( FLOAT_ARR, v2->val.dpnt,
@@ -154,18 +154,22 @@ vars_int_var_sub( Var_T * v1,
             break;
 
         case INT_ARR :
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( INT_ARR, v2->val.lpnt, ( long ) v2->len );
 
-            for ( ssize_t i = 0; i < new_var->len; i++ )
             {
+                long a = v1->val.lval;
+                long *dp = new_var->val.lpnt;
+                ssize_t len = new_var->len;
+
                 if ( ! exc )
-                    ir = v1->val.lval - new_var->val.lpnt[ i ];
+                    for ( ssize_t i = 0; i < len; i++ )
+                        dp[ i ] = a - dp[ i ];
                 else
-                    ir = new_var->val.lpnt[ i ] - v1->val.lval;
-                new_var->val.lpnt[ i ] = ir;
+                    for ( ssize_t i = 0; i < len; i++ )
+                        dp[ i ] = dp[ i ] - a;
             }
 
             vars_pop( v1 );
@@ -175,19 +179,23 @@ vars_int_var_sub( Var_T * v1,
             break;
 
         case FLOAT_ARR :
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( FLOAT_ARR, v2->val.dpnt,
                                      ( long ) v2->len );
 
-            for ( ssize_t i = 0; i < new_var->len; i++ )
             {
+                double a = v1->val.lval;
+                double *dp = new_var->val.dpnt;
+                ssize_t len = new_var->len;
+
                 if ( ! exc )
-                    dr = v1->val.lval - new_var->val.dpnt[ i ];
+                    for ( ssize_t i = 0; i < len; i++ )
+                        dp[ i ] = a - dp[ i ];
                 else
-                    dr = new_var->val.dpnt[ i ] - v1->val.lval;
-                new_var->val.dpnt[ i ] = dr;
+                    for ( ssize_t i = 0; i < len; i++ )
+                        dp[ i ] = dp[ i ] - a;
             }
 
             vars_pop( v1 );
@@ -276,13 +284,18 @@ vars_float_var_sub( Var_T * v1,
         case INT_ARR :
             new_var = vars_push( FLOAT_ARR, NULL, ( long ) v2->len );
 
-            for ( ssize_t i = 0; i < new_var->len; i++ )
             {
+                double a = v1->val.dval;
+                double *dp = new_var->val.dpnt;
+                long *sp = v2->val.lpnt;
+                ssize_t len = new_var->len;
+
                 if ( ! exc )
-                    dr = v1->val.dval - v2->val.lpnt[ i ];
+                    for ( ssize_t i = 0; i < len; i++ )
+                        dp[ i ] = a - sp[ i ];
                 else
-                    dr = v2->val.lpnt[ i ] - v1->val.dval;
-                new_var->val.dpnt[ i ] = dr;
+                    for ( ssize_t i = 0; i < len; i++ )
+                        dp[ i ] = sp[ i ] - a;
             }
 
             vars_pop( v1 );
@@ -291,19 +304,23 @@ vars_float_var_sub( Var_T * v1,
             break;
 
         case FLOAT_ARR :
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( FLOAT_ARR, v2->val.dpnt,
                                      ( long ) v2->len );
 
-            for ( ssize_t i = 0; i < new_var->len; i++ )
             {
+                double a = v1->val.dval;
+                double *dp = new_var->val.dpnt;
+                ssize_t len = new_var->len;
+
                 if ( ! exc )
-                    dr = v1->val.dval - new_var->val.dpnt[ i ];
+                    for ( ssize_t i = 0; i < len; i++ )
+                        dp[ i ] = a - dp[ i ];
                 else
-                    dr = new_var->val.dpnt[ i ] - v1->val.dval;
-                new_var->val.dpnt[ i ] = dr;
+                    for ( ssize_t i = 0; i < len; i++ )
+                        dp[ i ] = dp[ i ] - a;
             }
 
             vars_pop( v1 );
@@ -368,8 +385,6 @@ vars_int_arr_sub( Var_T * v1,
     vars_arith_len_check( v1, v2, "subtraction" );
 
     Var_T * new_var = NULL;
-    long ir;
-    double dr;
 
     switch ( v2->type )
     {
@@ -382,7 +397,7 @@ vars_int_arr_sub( Var_T * v1,
             break;
 
         case INT_ARR :
-            if ( v1->flags & IS_TEMP && v1 != v2 )
+            if ( vars_arr_swap_for_dest( v1, v2 ) )
             {
                 Var_T * vt = v1;
                 v1 = v2;
@@ -390,18 +405,22 @@ vars_int_arr_sub( Var_T * v1,
                 exc = ! exc;
             }
 
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( INT_ARR, v2->val.lpnt, ( long ) v2->len );
 
-            for ( ssize_t i = 0; i < new_var->len; i++ )
             {
+                long *dp = new_var->val.lpnt;
+                long *sp = v1->val.lpnt;
+                ssize_t len = new_var->len;
+
                 if ( ! exc )
-                    ir = v1->val.lpnt[ i ] - new_var->val.lpnt[ i ];
+                    for ( ssize_t i = 0; i < len; i++ )
+                        dp[ i ] = sp[ i ] - dp[ i ];
                 else
-                    ir = new_var->val.lpnt[ i ] - v1->val.lpnt[ i ];
-                new_var->val.lpnt[ i ] = ir;
+                    for ( ssize_t i = 0; i < len; i++ )
+                        dp[ i ] = dp[ i ] - sp[ i ];
             }
 
             vars_pop( v1 );
@@ -410,19 +429,23 @@ vars_int_arr_sub( Var_T * v1,
             break;
 
         case FLOAT_ARR :
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( FLOAT_ARR, v2->val.dpnt,
                                      ( long ) v2->len );
 
-            for ( ssize_t i = 0; i < v1->len; i++ )
             {
+                double *dp = new_var->val.dpnt;
+                long *sp = v1->val.lpnt;
+                ssize_t len = v1->len;
+
                 if ( ! exc )
-                    dr = v1->val.lpnt[ i ] - new_var->val.dpnt[ i ];
+                    for ( ssize_t i = 0; i < len; i++ )
+                        dp[ i ] = sp[ i ] - dp[ i ];
                 else
-                    dr = new_var->val.dpnt[ i ] - v1->val.lpnt[ i ];
-                new_var->val.dpnt[ i ] = dr;
+                    for ( ssize_t i = 0; i < len; i++ )
+                        dp[ i ] = dp[ i ] - sp[ i ];
             }
 
             if ( v1 != v2 )
@@ -467,7 +490,6 @@ vars_float_arr_sub( Var_T * v1,
     vars_arith_len_check( v1, v2, "subtraction" );
 
     Var_T * new_var = NULL;
-    double dr;
 
     switch ( v2->type )
     {
@@ -484,7 +506,7 @@ vars_float_arr_sub( Var_T * v1,
             break;
 
         case FLOAT_ARR :
-            if ( v1->flags & IS_TEMP )
+            if ( vars_arr_swap_for_dest( v1, v2 ) )
             {
                 Var_T * vt = v1;
                 v1 = v2;
@@ -492,19 +514,23 @@ vars_float_arr_sub( Var_T * v1,
                 exc = ! exc;
             }
 
-            if ( v2->flags & IS_TEMP )
+            if ( IS_SCRATCH_ARR( v2 ) )
                 new_var = v2;
             else
                 new_var = vars_push( FLOAT_ARR, v2->val.dpnt,
                                      ( long ) v2->len );
 
-            for ( ssize_t i = 0; i < new_var->len; i++ )
             {
+                double *dp = new_var->val.dpnt;
+                double *sp = v1->val.dpnt;
+                ssize_t len = new_var->len;
+
                 if ( ! exc )
-                    dr = v1->val.dpnt[ i ] - new_var->val.dpnt[ i ];
+                    for ( ssize_t i = 0; i < len; i++ )
+                        dp[ i ] = sp[ i ] - dp[ i ];
                 else
-                    dr = new_var->val.dpnt[ i ] - v1->val.dpnt[ i ];
-                new_var->val.dpnt[ i ] = dr;
+                    for ( ssize_t i = 0; i < len; i++ )
+                        dp[ i ] = dp[ i ] - sp[ i ];
             }
 
             if ( v1 != v2 )
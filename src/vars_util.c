@@ -52,7 +52,7 @@ Var_T * vars_negate( Var_T * v )
             break;
 
         case INT_ARR :
-            if ( ! ( v->flags & IS_TEMP ) )
+            if ( ! IS_SCRATCH_ARR( v ) )
                 new_var = vars_push( v->type, v->val.lpnt, v->len );
 
             for ( ssize_t i = 0; i < new_var->len; i++ )
@@ -61,7 +61,7 @@ Var_T * vars_negate( Var_T * v )
             break;
 
         case FLOAT_ARR :
-            if ( ! ( v->flags & IS_TEMP ) )
+            if ( ! IS_SCRATCH_ARR( v ) )
                 new_var = vars_push( v->type, v->val.dpnt, v->len );
 
             for ( ssize_t i = 0; i < new_var->len; i++ )
@@ -335,6 +335,29 @@ vars_arith_len_check( Var_T *      v1,
 }
 
 
+/*-----------------------------------------------------------------------*
+ * For arithmetic operations between two 1D arrays of the same type the
+ * result is stored in one of them if possible instead of a new array.
+ * The function returns if the first operand is the one to be used (and
+ * thus the operands must be swapped). Temporaries are preferred since
+ * some callers rely on the result ending up in them, then other arrays
+ * on the stack.
+ *-----------------------------------------------------------------------*/
+
+bool
+vars_arr_swap_for_dest( Var_T * v1,
+                        Var_T * v2 )
+{
+    if ( v1 == v2 || ! IS_SCRATCH_ARR( v1 ) )
+        return false;
+
+    if ( v1->flags & IS_TEMP )
+        return true;
+
+    return ! IS_SCRATCH_ARR( v2 );
+}
+
+
 /*
  * Local variables:
  * tags-file-name: "../TAGS"
@@ -38,6 +38,9 @@ void vars_arith_len_check( Var_T *      /* v1 */,
                            Var_T *      /* v2 */,
                            const char * /* op */  );
 
+bool vars_arr_swap_for_dest( Var_T * /* v1 */,
+                             Var_T * /* v2 */  );
+
 
 #endif  /* ! VARS_UTIL_HEADER */
 
@@ -0,0 +1,865 @@
+/*
+ *  Copyright (C) 1999-2016 Jens Thoms Toerring
+ *
+ *  This file is part of fsc2.
+ *
+ *  Fsc2 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3, or (at your option)
+ *  any later version.
+ *
+ *  Fsc2 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/* Write-behind queues for the files the EDL script writes to. Data to be
+   written to a file are appended to the file's queue and a single writer
+   thread (started when the first queue gets created) writes them to the
+   files, so the experiment doesn't get stalled by slow disks, network
+   file systems or compression. The memory used by all queues (including
+   the compressed data) is limited, if there's no space left the experiment
+   has to wait until the writer has made some progress.
+
+   For compressed files the data aren't compressed by zlib's gzwrite()
+   (the file is opened in transparent mode, so gzwrite() just writes out
+   what it gets) but each chunk of a queue is compressed independently
+   as a sequence of raw deflate blocks by one of a pool of compressor
+   threads. The writer then writes out the compressed chunks in the
+   correct order, preceded by a gzip header, and when the queue gets
+   closed the end of the deflate stream and the gzip trailer (with the
+   CRC32 of all data, calculated from the CRCs of the chunks) follow,
+   so the result is a normal gzip file (as also created by 'pigz -i').
+
+   The writer and compressor threads do nothing but writing and compres-
+   sing, they never call functions that may throw exceptions or talk to
+   the parent process. If writing fails the writer marks the queue as
+   having an error and stops writing to the file (but keeps the data that
+   couldn't be written). It's then up to the main thread to find out
+   about it (the functions for putting data into the queue or flushing
+   it tell it), deal with the problem (e.g. by asking the user to delete
+   some files) and to then either let the writer retry or close the
+   queue. */
+
+
+#include "fsc2.h"
+#include <pthread.h>
+
+
+#define WQ_CHUNK_SIZE   262144                   /* 256 kB */
+#define WQ_MAX_MEMORY   ( 128 * WQ_CHUNK_SIZE )  /* 32 MB for all queues */
+#define WQ_MAX_THREADS  64                       /* compressor threads */
+
+#define GZIP_HEADER_SIZE  10
+
+#if ! defined GZIP_LEVEL
+#define GZIP_LEVEL    9
+#endif
+
+#if ! defined GZIP_THREADS
+#define GZIP_THREADS  0                 /* one per processor */
+#endif
+
+
+/* States of a chunk of a queue of a compressed file, for normal files
+   chunks are always in the FILLING state */
+
+enum {
+    WQ_FILLING,                     /* data still can be appended */
+    WQ_WAITING,                     /* waiting to be compressed */
+    WQ_COMPRESSING,                 /* compressor is working on it */
+    WQ_READY                        /* compressed, ready for writing */
+};
+
+
+typedef struct WQ_Chunk WQ_Chunk_T;
+
+struct WQ_Chunk {
+    WQ_Chunk_T    * next;
+    int             state;
+    bool            first;          /* first chunk of compressed file */
+    size_t          len;            /* number of bytes in the chunk */
+    size_t          pos;            /* number of bytes already written */
+    unsigned char * out;            /* compressed data */
+    size_t          out_len;        /* number of bytes of compressed data */
+    unsigned long   crc;            /* CRC32 of the (uncompressed) data */
+    unsigned char   data[ WQ_CHUNK_SIZE ];
+};
+
+struct Write_Queue {
+    FILE          * fp;
+    gzFile          gp;
+    WQ_Chunk_T    * head;           /* chunk to be written next */
+    WQ_Chunk_T    * tail;           /* chunk new data get appended to */
+    bool            busy;           /* set while writer writes head chunk */
+    bool            error;          /* set when writing failed */
+    bool            started;        /* gzip header has been queued */
+    unsigned long   crc;            /* CRC32 of data written to gzip file */
+    unsigned long   size;           /* and their number (modulo 2^32) */
+    Write_Queue_T * next;
+};
+
+
+static bool start_thread( pthread_t * thread,
+                          void * ( * func )( void * ) );
+static void * write_queue_thread( void * arg );
+static Write_Queue_T * get_work( void );
+static void * compressor( void * arg );
+static WQ_Chunk_T * get_chunk_to_compress( Write_Queue_T ** qp );
+static bool compress_chunk( WQ_Chunk_T * c );
+static void seal_tail( Write_Queue_T * q );
+static void finish_gzip( Write_Queue_T * q );
+static void put_le32( unsigned char * p,
+                      unsigned long   v );
+static void free_chunks( Write_Queue_T * q );
+
+
+static pthread_mutex_t WQ_Mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t WQ_Work = PTHREAD_COND_INITIALIZER;   /* for writer */
+static pthread_cond_t WQ_Pack = PTHREAD_COND_INITIALIZER;   /* compressors */
+static pthread_cond_t WQ_Done = PTHREAD_COND_INITIALIZER;   /* progress */
+static pthread_t WQ_Thread;
+static bool WQ_Is_Running = false;
+static pthread_t WQ_Packers[ WQ_MAX_THREADS ];
+static int WQ_Num_Packers = 0;
+static bool WQ_Quit = false;
+static Write_Queue_T * WQ_List = NULL;
+static size_t WQ_Memory = 0;
+
+
+/*-------------------------------------------------------------*
+ * Creates a new queue for a file, either a normal file ('fp')
+ * or a compressed one ('gp', which must have been opened in
+ * transparent mode), the other one must be NULL. The writer
+ * thread and, for compressed files, the compressor threads get
+ * started if they aren't running yet.
+ *-------------------------------------------------------------*/
+
+Write_Queue_T *
+write_queue_create( FILE   * fp,
+                    gzFile   gp )
+{
+    Write_Queue_T *q = T_malloc( sizeof *q );
+
+    q->fp      = fp;
+    q->gp      = gp;
+    q->head    = q->tail = NULL;
+    q->busy    = q->error = q->started = false;
+    q->crc     = crc32( 0, NULL, 0 );
+    q->size    = 0;
+
+    pthread_mutex_lock( &WQ_Mutex );
+
+    if ( ! WQ_Is_Running )
+        WQ_Is_Running = start_thread( &WQ_Thread, write_queue_thread );
+
+    /* The number of compressor threads is either set at compile time or
+       defaults to the number of processors */
+
+    if ( WQ_Is_Running && gp && WQ_Num_Packers == 0 )
+    {
+        long num = GZIP_THREADS;
+
+        if ( num <= 0 )
+            num = sysconf( _SC_NPROCESSORS_ONLN );
+        num = l_max( 1, l_min( num, WQ_MAX_THREADS ) );
+
+        while (    WQ_Num_Packers < num
+                && start_thread( WQ_Packers + WQ_Num_Packers, compressor ) )
+            WQ_Num_Packers++;
+    }
+
+    if ( ! WQ_Is_Running || ( gp && WQ_Num_Packers == 0 ) )
+    {
+        pthread_mutex_unlock( &WQ_Mutex );
+        T_free( q );
+        print( FATAL, "Failed to start thread for writing to files.\n" );
+        THROW( EXCEPTION );
+    }
+
+    q->next = WQ_List;
+    WQ_List = q;
+
+    pthread_mutex_unlock( &WQ_Mutex );
+
+    return q;
+}
+
+
+/*---------------------------------------------------------------*
+ * Appends data to the queue of a file. If the memory limit for
+ * all queues has been reached the function waits until the writer
+ * has written out some data. The function returns the number of
+ * bytes that were queued, which is less than requested if writing
+ * to the file failed.
+ *---------------------------------------------------------------*/
+
+size_t
+write_queue_put( Write_Queue_T * q,
+                 const void    * buf,
+                 size_t          len )
+{
+    const char *p = buf;
+    size_t done = 0;
+
+
+    pthread_mutex_lock( &WQ_Mutex );
+
+    while ( done < len && ! q->error )
+    {
+        WQ_Chunk_T *c = q->tail;
+
+        /* Append to the last chunk if there's still room in it and the
+           writer isn't just writing it out (or, for compressed files, it
+           isn't already waiting to be compressed). Once a chunk for a
+           compressed file is full it's handed to the compressors. */
+
+        if (    c
+             && c->state == WQ_FILLING
+             && c->len < WQ_CHUNK_SIZE
+             && ! ( q->busy && c == q->head ) )
+        {
+            size_t n = WQ_CHUNK_SIZE - c->len;
+
+            if ( n > len - done )
+                n = len - done;
+
+            memcpy( c->data + c->len, p + done, n );
+            c->len += n;
+            done   += n;
+
+            if ( q->gp && c->len == WQ_CHUNK_SIZE )
+                seal_tail( q );
+            continue;
+        }
+
+        /* Otherwise a new chunk is needed. If we're already using too much
+           memory wait for the writer to get rid of some of the data of this
+           file - if there are none there's nothing we can wait for and we
+           go a bit over the limit */
+
+        if ( WQ_Memory + sizeof *c > WQ_MAX_MEMORY && q->head )
+        {
+            pthread_cond_wait( &WQ_Done, &WQ_Mutex );
+            continue;
+        }
+
+        if ( ! ( c = malloc( sizeof *c ) ) )
+        {
+            pthread_mutex_unlock( &WQ_Mutex );
+            THROW( OUT_OF_MEMORY_EXCEPTION );
+        }
+
+        c->next    = NULL;
+        c->state   = WQ_FILLING;
+        c->first   = q->gp && ! q->started;
+        c->len     = c->pos = 0;
+        c->out     = NULL;
+        c->out_len = 0;
+
+        q->started = true;
+
+        if ( q->tail )
+            q->tail->next = c;
+        else
+            q->head = c;
+        q->tail = c;
+
+        WQ_Memory += sizeof *c;
+    }
+
+    if ( done > 0 && ! q->gp )
+        pthread_cond_signal( &WQ_Work );
+
+    pthread_mutex_unlock( &WQ_Mutex );
+
+    return done;
+}
+
+
+/*---------------------------------------------------------------*
+ * Waits until all data in the queue of a file have been written
+ * out (for compressed files this includes what zlib may still
+ * have buffered). Returns false if writing failed, true otherwise.
+ *---------------------------------------------------------------*/
+
+bool
+write_queue_flush( Write_Queue_T * q )
+{
+    bool ok;
+
+
+    pthread_mutex_lock( &WQ_Mutex );
+
+    if ( q->gp )
+        seal_tail( q );
+
+    while ( ( q->head || q->busy ) && ! q->error )
+        pthread_cond_wait( &WQ_Done, &WQ_Mutex );
+
+    if (    ! q->error
+         && q->gp
+         && gzflush( q->gp, Z_SYNC_FLUSH ) != Z_OK )
+        q->error = true;
+
+    ok = ! q->error;
+
+    pthread_mutex_unlock( &WQ_Mutex );
+
+    return ok;
+}
+
+
+/*--------------------------------------------------------------*
+ * Tells the writer to try again to write out the data of a file
+ * after writing them failed (and e.g. the user deleted files).
+ *--------------------------------------------------------------*/
+
+void
+write_queue_retry( Write_Queue_T * q )
+{
+    pthread_mutex_lock( &WQ_Mutex );
+
+    if ( q->error )
+    {
+        if ( q->gp )
+            gzclearerr( q->gp );
+        else
+            clearerr( q->fp );
+
+        q->error = false;
+        pthread_cond_signal( &WQ_Work );
+        pthread_cond_broadcast( &WQ_Pack );
+    }
+
+    pthread_mutex_unlock( &WQ_Mutex );
+}
+
+
+/*--------------------------------------------------------------*
+ * Sets a new FILE pointer or gzFile for a queue, needed when a
+ * file had to be reopened. The queue should have been flushed
+ * before the old file got closed. For compressed files a new
+ * gzip stream gets started.
+ *--------------------------------------------------------------*/
+
+void
+write_queue_set_file( Write_Queue_T * q,
+                      FILE          * fp,
+                      gzFile          gp )
+{
+    pthread_mutex_lock( &WQ_Mutex );
+    q->fp      = fp;
+    q->gp      = gp;
+    q->started = false;
+    q->crc     = crc32( 0, NULL, 0 );
+    q->size    = 0;
+    pthread_mutex_unlock( &WQ_Mutex );
+}
+
+
+/*--------------------------------------------------------------*
+ * Returns the CRC32 and the length of the (uncompressed) data
+ * written to a compressed file up to now, needed for continuing
+ * its gzip stream when an experiment is resumed from a checkpoint.
+ * The queue should have been flushed before.
+ *--------------------------------------------------------------*/
+
+void
+write_queue_get_gzip_state( Write_Queue_T * q,
+                            unsigned long * crc,
+                            unsigned long * size )
+{
+    pthread_mutex_lock( &WQ_Mutex );
+    *crc  = q->crc;
+    *size = q->size;
+    pthread_mutex_unlock( &WQ_Mutex );
+}
+
+
+/*--------------------------------------------------------------*
+ * Makes the queue of a compressed file continue the gzip stream
+ * already in the file (with the CRC32 and the length of the data
+ * in it as given) instead of starting a new one. To be used on a
+ * new queue when an experiment is resumed from a checkpoint.
+ *--------------------------------------------------------------*/
+
+void
+write_queue_set_gzip_state( Write_Queue_T * q,
+                            unsigned long   crc,
+                            unsigned long   size )
+{
+    pthread_mutex_lock( &WQ_Mutex );
+    q->started = true;
+    q->crc     = crc;
+    q->size    = size;
+    pthread_mutex_unlock( &WQ_Mutex );
+}
+
+
+/*--------------------------------------------------------------*
+ * Removes a queue, data that haven't been written yet are lost
+ * (so call write_queue_flush() first if they're still needed).
+ * If all data were written to a compressed file the end of the
+ * gzip stream gets written. When the function returns the writer
+ * doesn't use the file anymore and it can be closed.
+ *--------------------------------------------------------------*/
+
+void
+write_queue_close( Write_Queue_T * q )
+{
+    if ( ! q )
+        return;
+
+    pthread_mutex_lock( &WQ_Mutex );
+
+    while ( q->busy )
+        pthread_cond_wait( &WQ_Done, &WQ_Mutex );
+
+    for ( Write_Queue_T ** qp = &WQ_List; *qp; qp = &( *qp )->next )
+        if ( *qp == q )
+        {
+            *qp = q->next;
+            break;
+        }
+
+    /* Chunks may still be in the hands of the compressors, wait for them
+       to finish before the memory for the chunks can be released */
+
+    for ( WQ_Chunk_T *c = q->head; c; c = c->next )
+        while ( c->state == WQ_COMPRESSING )
+            pthread_cond_wait( &WQ_Done, &WQ_Mutex );
+
+    if ( q->gp && ! q->head && ! q->error )
+        finish_gzip( q );
+
+    free_chunks( q );
+
+    /* Memory has become available, so wake up a waiting writer of data */
+
+    pthread_cond_broadcast( &WQ_Done );
+    pthread_mutex_unlock( &WQ_Mutex );
+
+    T_free( q );
+}
+
+
+/*---------------------------------------------------------------*
+ * Stops the writer and compressor threads, to be called when all
+ * queues have been closed, i.e. at the end of the experiment.
+ *---------------------------------------------------------------*/
+
+void
+write_queue_stop( void )
+{
+    pthread_mutex_lock( &WQ_Mutex );
+
+    if ( ! WQ_Is_Running )
+    {
+        pthread_mutex_unlock( &WQ_Mutex );
+        return;
+    }
+
+    WQ_Quit = true;
+    pthread_cond_signal( &WQ_Work );
+    pthread_cond_broadcast( &WQ_Pack );
+    pthread_mutex_unlock( &WQ_Mutex );
+
+    pthread_join( WQ_Thread, NULL );
+    while ( WQ_Num_Packers > 0 )
+        pthread_join( WQ_Packers[ --WQ_Num_Packers ], NULL );
+
+    WQ_Is_Running = WQ_Quit = false;
+}
+
+
+/*---------------------------------------------------------------*
+ * Starts a thread. All signals are blocked for it so they go to
+ * the main thread (e.g. the DO_QUIT signal from the parent) as
+ * before. Returns false if the thread couldn't be created.
+ *---------------------------------------------------------------*/
+
+static bool
+start_thread( pthread_t * thread,
+              void *   ( * func )( void * ) )
+{
+    sigset_t new_mask,
+             old_mask;
+    int ret;
+
+
+    sigfillset( &new_mask );
+    pthread_sigmask( SIG_SETMASK, &new_mask, &old_mask );
+    ret = pthread_create( thread, NULL, func, NULL );
+    pthread_sigmask( SIG_SETMASK, &old_mask, NULL );
+
+    return ret == 0;
+}
+
+
+/*---------------------------------------------------------------*
+ * Function run by the writer thread: as long as there are queues
+ * with data ready for writing (and without errors) the first chunk
+ * of one of them gets written out, otherwise it waits for more.
+ *---------------------------------------------------------------*/
+
+static void *
+write_queue_thread( void * arg  UNUSED_ARG )
+{
+    pthread_mutex_lock( &WQ_Mutex );
+
+    while ( true )
+    {
+        Write_Queue_T *q = get_work( );
+
+        if ( ! q )
+        {
+            if ( WQ_Quit )
+                break;
+            pthread_cond_wait( &WQ_Work, &WQ_Mutex );
+            continue;
+        }
+
+        /* Write out the first chunk without holding the lock - while it's
+           marked as busy it won't get changed */
+
+        WQ_Chunk_T *c = q->head;
+        const unsigned char *src;
+        size_t len;
+        long count;
+
+        if ( q->gp )
+        {
+            src = c->out + c->pos;
+            len = c->out_len - c->pos;
+        }
+        else
+        {
+            src = c->data + c->pos;
+            len = c->len - c->pos;
+        }
+
+        q->busy = true;
+        pthread_mutex_unlock( &WQ_Mutex );
+
+        if ( q->gp )
+            count = gzwrite( q->gp, src, len );
+        else
+            count = fwrite( src, 1, len, q->fp );
+
+        pthread_mutex_lock( &WQ_Mutex );
+        q->busy = false;
+
+        if ( count > 0 )
+            c->pos += count;
+
+        if ( count == ( long ) len )
+        {
+            if ( q->gp )
+            {
+                q->crc = crc32_combine( q->crc, c->crc, c->len );
+                q->size += c->len;
+                free( c->out );
+            }
+
+            if ( ! ( q->head = c->next ) )
+                q->tail = NULL;
+            WQ_Memory -= sizeof *c + c->out_len;
+            free( c );
+        }
+        else
+            q->error = true;
+
+        pthread_cond_broadcast( &WQ_Done );
+    }
+
+    pthread_mutex_unlock( &WQ_Mutex );
+    return NULL;
+}
+
+
+/*---------------------------------------------------------------*
+ * Returns a queue with data to be written and moves it to the
+ * end of the list of queues, so data for all files get written
+ * in turn. Returns NULL if there's nothing to do. Must be called
+ * with the mutex locked.
+ *---------------------------------------------------------------*/
+
+static Write_Queue_T *
+get_work( void )
+{
+    Write_Queue_T **qp;
+    Write_Queue_T *q;
+
+
+    for ( qp = &WQ_List; ( q = *qp ); qp = &q->next )
+        if (    q->head
+             && ! q->error
+             && ( ! q->gp || q->head->state == WQ_READY ) )
+            break;
+
+    if ( ! q )
+        return NULL;
+
+    if ( q->next )
+    {
+        *qp = q->next;
+        while ( *qp )
+            qp = &( *qp )->next;
+        *qp = q;
+        q->next = NULL;
+    }
+
+    return q;
+}
+
+
+/*---------------------------------------------------------------*
+ * Function run by the compressor threads: they wait for chunks
+ * of compressed files that are waiting to be compressed, and
+ * compress them.
+ *---------------------------------------------------------------*/
+
+static void *
+compressor( void * arg  UNUSED_ARG )
+{
+    pthread_mutex_lock( &WQ_Mutex );
+
+    while ( true )
+    {
+        Write_Queue_T *q;
+        WQ_Chunk_T *c = get_chunk_to_compress( &q );
+
+        if ( ! c )
+        {
+            if ( WQ_Quit )
+                break;
+            pthread_cond_wait( &WQ_Pack, &WQ_Mutex );
+            continue;
+        }
+
+        c->state = WQ_COMPRESSING;
+        pthread_mutex_unlock( &WQ_Mutex );
+
+        bool ok = compress_chunk( c );
+
+        pthread_mutex_lock( &WQ_Mutex );
+
+        /* If compression failed (we ran out of memory) it's treated like
+           an error while writing, on a retry the chunk gets compressed
+           again */
+
+        if ( ok )
+        {
+            WQ_Memory += c->out_len;
+            c->state = WQ_READY;
+            if ( c == q->head )
+                pthread_cond_signal( &WQ_Work );
+        }
+        else
+        {
+            c->state = WQ_WAITING;
+            q->error = true;
+        }
+
+        pthread_cond_broadcast( &WQ_Done );
+    }
+
+    pthread_mutex_unlock( &WQ_Mutex );
+    return NULL;
+}
+
+
+/*---------------------------------------------------------------*
+ * Returns the next chunk of a compressed file that's waiting to
+ * be compressed (and the queue it belongs to) or NULL if there's
+ * none. Must be called with the mutex locked.
+ *---------------------------------------------------------------*/
+
+static WQ_Chunk_T *
+get_chunk_to_compress( Write_Queue_T ** qp )
+{
+    for ( Write_Queue_T *q = WQ_List; q; q = q->next )
+    {
+        if ( ! q->gp || q->error )
+            continue;
+
+        for ( WQ_Chunk_T *c = q->head; c; c = c->next )
+            if ( c->state == WQ_WAITING )
+            {
+                *qp = q;
+                return c;
+            }
+    }
+
+    return NULL;
+}
+
+
+/*---------------------------------------------------------------*
+ * Compresses the data of a chunk into a sequence of raw deflate
+ * blocks, ending in an empty stored block (i.e. at a byte bound-
+ * ary), so compressed chunks can simply be concatenated. The
+ * first chunk of a file also gets the gzip header. Since this is
+ * done without holding the lock only the chunks data may be used.
+ *---------------------------------------------------------------*/
+
+static bool
+compress_chunk( WQ_Chunk_T * c )
+{
+    z_stream zs;
+    size_t header = c->first ? GZIP_HEADER_SIZE : 0;
+    size_t size;
+
+
+    zs.zalloc = Z_NULL;
+    zs.zfree  = Z_NULL;
+    zs.opaque = Z_NULL;
+
+    if ( deflateInit2( &zs, GZIP_LEVEL, Z_DEFLATED, -15, 8,
+                       Z_DEFAULT_STRATEGY ) != Z_OK )
+        return false;
+
+    /* deflateBound() doesn't account for the empty block the flush adds */
+
+    size = header + deflateBound( &zs, c->len ) + 16;
+
+    if ( ! ( c->out = malloc( size ) ) )
+    {
+        deflateEnd( &zs );
+        return false;
+    }
+
+    /* The gzip header with no file name or time stamp and Unix as the
+       operating system */
+
+    if ( c->first )
+        memcpy( c->out, "\x1f\x8b\x08\0\0\0\0\0\0\x03", GZIP_HEADER_SIZE );
+
+    zs.next_in   = c->data;
+    zs.avail_in  = c->len;
+    zs.next_out  = c->out + header;
+    zs.avail_out = size - header;
+
+    int ret = deflate( &zs, Z_SYNC_FLUSH );
+
+    c->out_len = size - zs.avail_out;
+    deflateEnd( &zs );
+
+    if ( ret != Z_OK || zs.avail_in != 0 || zs.avail_out == 0 )
+    {
+        free( c->out );
+        c->out = NULL;
+        c->out_len = 0;
+        return false;
+    }
+
+    /* The compressed data count towards the memory limit, so don't keep
+       more memory than needed for them */
+
+    unsigned char *out = realloc( c->out, c->out_len );
+    if ( out )
+        c->out = out;
+
+    c->crc = crc32( 0, c->data, c->len );
+    return true;
+}
+
+
+/*---------------------------------------------------------------*
+ * Hands the last chunk of a queue of a compressed file to the
+ * compressors, no data can be appended to it anymore. Must be
+ * called with the mutex locked.
+ *---------------------------------------------------------------*/
+
+static void
+seal_tail( Write_Queue_T * q )
+{
+    if ( ! q->tail || q->tail->state != WQ_FILLING )
+        return;
+
+    q->tail->state = WQ_WAITING;
+    pthread_cond_signal( &WQ_Pack );
+}
+
+
+/*---------------------------------------------------------------*
+ * Writes the end of a gzip stream, i.e. a final empty deflate
+ * block and the trailer with the CRC32 and length of the data.
+ * If nothing was written yet a gzip header has to be written
+ * first. Must be called with the mutex locked and only when the
+ * writer can't be using the file.
+ *---------------------------------------------------------------*/
+
+static void
+finish_gzip( Write_Queue_T * q )
+{
+    unsigned char buf[ GZIP_HEADER_SIZE + 10 ];
+    unsigned char *p = buf;
+
+
+    if ( ! q->started )
+    {
+        memcpy( p, "\x1f\x8b\x08\0\0\0\0\0\0\x03", GZIP_HEADER_SIZE );
+        p += GZIP_HEADER_SIZE;
+        q->started = true;
+    }
+
+    *p++ = 0x03;
+    *p++ = 0x00;
+    put_le32( p, q->crc );
+    put_le32( p + 4, q->size );
+
+    gzwrite( q->gp, buf, p + 8 - buf );
+}
+
+
+/*-----------------------------------------------*
+ * Stores a 32-bit value in little-endian order
+ *-----------------------------------------------*/
+
+static void
+put_le32( unsigned char * p,
+          unsigned long   v )
+{
+    p[ 0 ] =   v         & 0xFF;
+    p[ 1 ] = ( v >>  8 ) & 0xFF;
+    p[ 2 ] = ( v >> 16 ) & 0xFF;
+    p[ 3 ] = ( v >> 24 ) & 0xFF;
+}
+
+
+/*---------------------------------------------------*
+ * Deallocates all chunks of a queue, must be called
+ * with the mutex locked.
+ *---------------------------------------------------*/
+
+static void
+free_chunks( Write_Queue_T * q )
+{
+    while ( q->head )
+    {
+        WQ_Chunk_T *c = q->head;
+
+        q->head = c->next;
+        WQ_Memory -= sizeof *c + c->out_len;
+        free( c->out );
+        free( c );
+    }
+
+    q->tail = NULL;
+}
+
+
+/*
+ * Local variables:
+ * tags-file-name: "../TAGS"
+ * tab-width: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
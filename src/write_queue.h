@@ -0,0 +1,70 @@
+/*
+ *  Copyright (C) 1999-2016 Jens Thoms Toerring
+ *
+ *  This file is part of fsc2.
+ *
+ *  Fsc2 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3, or (at your option)
+ *  any later version.
+ *
+ *  Fsc2 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+#if ! defined WRITE_QUEUE_HEADER
+#define WRITE_QUEUE_HEADER
+
+
+#include "fsc2.h"
+#include <zlib.h>
+
+
+typedef struct Write_Queue Write_Queue_T;
+
+
+Write_Queue_T * write_queue_create( FILE * /* fp */,
+                                    gzFile /* gp */  );
+
+size_t write_queue_put( Write_Queue_T * /* q   */,
+                        const void    * /* buf */,
+                        size_t          /* len */  );
+
+bool write_queue_flush( Write_Queue_T * /* q */ );
+
+void write_queue_retry( Write_Queue_T * /* q */ );
+
+void write_queue_set_file( Write_Queue_T * /* q  */,
+                           FILE          * /* fp */,
+                           gzFile          /* gp */  );
+
+void write_queue_get_gzip_state( Write_Queue_T * /* q    */,
+                                 unsigned long * /* crc  */,
+                                 unsigned long * /* size */  );
+
+void write_queue_set_gzip_state( Write_Queue_T * /* q    */,
+                                 unsigned long   /* crc  */,
+                                 unsigned long   /* size */  );
+
+void write_queue_close( Write_Queue_T * /* q */ );
+
+void write_queue_stop( void );
+
+
+#endif  /* ! WRITE_QUEUE_HEADER */
+
+
+/*
+ * Local variables:
+ * tags-file-name: "../TAGS"
+ * tab-width: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,261 @@
+/*
+ *  Copyright (C) 1999-2016 Jens Thoms Toerring
+ *
+ *  This file is part of fsc2.
+ *
+ *  Fsc2 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3, or (at your option)
+ *  any later version.
+ *
+ *  Fsc2 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "fsc2_bin.h"
+
+
+static uint32_t get32( const unsigned char * p );
+static uint64_t get64( const unsigned char * p );
+
+
+/*----------------------------------------------------------------*
+ * Opens a binary data file written by fsc2 and maps it into
+ * memory. Returns NULL on failure with errno set (to EINVAL if
+ * the file isn't a binary fsc2 data file or has a version that
+ * isn't supported).
+ *----------------------------------------------------------------*/
+
+Fsc2_Bin_File_T *
+fsc2_bin_open( const char * name )
+{
+    Fsc2_Bin_File_T *bf;
+    struct stat st;
+    void *map;
+    int fd;
+
+
+    if ( ( fd = open( name, O_RDONLY ) ) == -1 )
+        return NULL;
+
+    if ( fstat( fd, &st ) == -1 )
+    {
+        close( fd );
+        return NULL;
+    }
+
+    if ( st.st_size < FSC2_BIN_HEADER_SIZE )
+    {
+        close( fd );
+        errno = EINVAL;
+        return NULL;
+    }
+
+    map = mmap( NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+    close( fd );
+
+    if ( map == MAP_FAILED )
+        return NULL;
+
+    if (    memcmp( map, FSC2_BIN_MAGIC, 8 )
+         || get32( ( unsigned char * ) map + 8 ) > FSC2_BIN_VERSION
+         || ( bf = malloc( sizeof *bf ) ) == NULL )
+    {
+        munmap( map, st.st_size );
+        errno = EINVAL;
+        return NULL;
+    }
+
+    bf->map     = map;
+    bf->size    = st.st_size;
+    bf->pos     = FSC2_BIN_HEADER_SIZE;
+    bf->version = get32( bf->map + 8 );
+
+    return bf;
+}
+
+
+/*------------------------------------------*
+ * Unmaps and closes a binary data file.
+ *------------------------------------------*/
+
+void
+fsc2_bin_close( Fsc2_Bin_File_T * bf )
+{
+    if ( bf == NULL )
+        return;
+
+    munmap( ( void * ) bf->map, bf->size );
+    free( bf );
+}
+
+
+/*---------------------------------------------------------------*
+ * Makes the next call of fsc2_bin_next() return the first record
+ *---------------------------------------------------------------*/
+
+void
+fsc2_bin_rewind( Fsc2_Bin_File_T * bf )
+{
+    bf->pos = FSC2_BIN_HEADER_SIZE;
+}
+
+
+/*---------------------------------------------------------------------*
+ * Gets the next record from the file. Returns 1 if there was another
+ * record, 0 at the end of the file and -1 if the file is corrupted or
+ * truncated (e.g. because the experiment was aborted while writing).
+ *---------------------------------------------------------------------*/
+
+int
+fsc2_bin_next( Fsc2_Bin_File_T   * bf,
+               Fsc2_Bin_Record_T * rec )
+{
+    size_t left = bf->size - bf->pos;
+    const unsigned char *p = bf->map + bf->pos;
+    size_t len;
+
+
+    if ( left == 0 )
+        return 0;
+
+    if ( left < 8 )
+        return -1;
+
+    rec->type  = get32( p );
+    rec->ndims = get32( p + 4 );
+
+    if (    rec->type < FSC2_BIN_INT || rec->type > FSC2_BIN_TEXT
+         || rec->ndims < 0 || ( size_t ) rec->ndims > ( left - 8 ) / 8
+         || ( rec->type == FSC2_BIN_TEXT && rec->ndims != 1 ) )
+        return -1;
+
+    rec->dims = p + 8;
+    len = 8 + 8 * rec->ndims;
+
+    /* Determine the number of values (or characters) from the sizes of
+       the dimensions and check that the data are all in the file */
+
+    rec->count = 1;
+    for ( int i = 0; i < rec->ndims; i++ )
+    {
+        uint64_t d = get64( rec->dims + 8 * i );
+
+        if ( d != 0 && rec->count > ( left - len ) / d )
+            return -1;
+        rec->count *= d;
+    }
+
+    rec->data = p + len;
+
+    if ( rec->type == FSC2_BIN_TEXT )
+        len += ( rec->count + 7 ) & ~ ( size_t ) 7;
+    else
+        len += 8 * rec->count;
+
+    if ( len > left )
+        return -1;
+
+    bf->pos += len;
+    return 1;
+}
+
+
+/*------------------------------------------------------------------*
+ * Returns if the data of records can be used directly as arrays of
+ * int64_t or double, i.e. if this is a little-endian machine.
+ *------------------------------------------------------------------*/
+
+int
+fsc2_bin_is_native( void )
+{
+    uint16_t x = 1;
+
+    return * ( unsigned char * ) &x == 1;
+}
+
+
+/*-----------------------------------------------*
+ * Returns the size of the i-th dimension of the
+ * data of a record.
+ *-----------------------------------------------*/
+
+uint64_t
+fsc2_bin_dim( const Fsc2_Bin_Record_T * rec,
+              int                       i )
+{
+    return get64( rec->dims + 8 * i );
+}
+
+
+/*-------------------------------------------------*
+ * Returns the i-th value of a record of integers
+ *-------------------------------------------------*/
+
+int64_t
+fsc2_bin_int( const Fsc2_Bin_Record_T * rec,
+              size_t                    i )
+{
+    return ( int64_t ) get64( ( const unsigned char * ) rec->data + 8 * i );
+}
+
+
+/*-----------------------------------------------*
+ * Returns the i-th value of a record of floats
+ *-----------------------------------------------*/
+
+double
+fsc2_bin_float( const Fsc2_Bin_Record_T * rec,
+                size_t                    i )
+{
+    uint64_t u = get64( ( const unsigned char * ) rec->data + 8 * i );
+    double d;
+
+    memcpy( &d, &u, sizeof d );
+    return d;
+}
+
+
+/*-----------------------------------------------*
+ * Converts 4 bytes in little-endian byte order
+ *-----------------------------------------------*/
+
+static uint32_t
+get32( const unsigned char * p )
+{
+    return   ( uint32_t ) p[ 0 ]         | ( ( uint32_t ) p[ 1 ] <<  8 )
+           | ( ( uint32_t ) p[ 2 ] << 16 ) | ( ( uint32_t ) p[ 3 ] << 24 );
+}
+
+
+/*-----------------------------------------------*
+ * Converts 8 bytes in little-endian byte order
+ *-----------------------------------------------*/
+
+static uint64_t
+get64( const unsigned char * p )
+{
+    return get32( p ) | ( ( uint64_t ) get32( p + 4 ) << 32 );
+}
+
+
+/*
+ * Local variables:
+ * tags-file-name: "../TAGS"
+ * tab-width: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
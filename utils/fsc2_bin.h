@@ -0,0 +1,109 @@
+/*
+ *  Copyright (C) 1999-2016 Jens Thoms Toerring
+ *
+ *  This file is part of fsc2.
+ *
+ *  Fsc2 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3, or (at your option)
+ *  any later version.
+ *
+ *  Fsc2 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/* Reader for the binary data files written by fsc2 for files opened with
+   the EDL functions open_binary_file() and get_binary_file().
+
+   A binary file starts with a header of 16 bytes, the magic string
+   "FSC2BIN\n" followed by the format version and a reserved field, both
+   32-bit integers. Then records follow, each consisting of
+
+     - the type of the data (32-bit integer, FSC2_BIN_INT, FSC2_BIN_FLOAT
+       or FSC2_BIN_TEXT)
+     - the number of dimensions (32-bit integer, 0 for a single value, 1
+       for texts)
+     - the sizes of all dimensions (64-bit integers)
+     - the data, 64-bit integers, IEEE 754 doubles (with the last index
+       varying fastest) or the characters of a text, padded with zero
+       bytes to a multiple of 8 bytes.
+
+   All numbers are stored in little-endian byte order. Since all records
+   start at multiples of 8 bytes, on little-endian machines the data of a
+   record can be used directly from the memory mapped file. Texts are
+   what functions like fsave() or save_program() would have written to a
+   normal file, including all newline characters. */
+
+
+#pragma once
+#if ! defined FSC2_BIN_HEADER
+#define FSC2_BIN_HEADER
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+#define FSC2_BIN_MAGIC        "FSC2BIN\n"
+#define FSC2_BIN_VERSION      1
+#define FSC2_BIN_HEADER_SIZE  16
+
+#define FSC2_BIN_INT          1
+#define FSC2_BIN_FLOAT        2
+#define FSC2_BIN_TEXT         3
+
+
+typedef struct {
+    const unsigned char * map;      /* start of the memory mapped file */
+    size_t                size;     /* size of the file */
+    size_t                pos;      /* position of next record */
+    int                   version;  /* format version of the file */
+} Fsc2_Bin_File_T;
+
+
+typedef struct {
+    int                   type;     /* FSC2_BIN_INT, _FLOAT or _TEXT */
+    int                   ndims;    /* number of dimensions */
+    const unsigned char * dims;     /* sizes of dimensions (raw) */
+    size_t                count;    /* number of values or characters */
+    const void          * data;     /* start of the data */
+} Fsc2_Bin_Record_T;
+
+
+Fsc2_Bin_File_T * fsc2_bin_open( const char * /* name */ );
+
+void fsc2_bin_close( Fsc2_Bin_File_T * /* bf */ );
+
+void fsc2_bin_rewind( Fsc2_Bin_File_T * /* bf */ );
+
+int fsc2_bin_next( Fsc2_Bin_File_T   * /* bf  */,
+                   Fsc2_Bin_Record_T * /* rec */  );
+
+int fsc2_bin_is_native( void );
+
+uint64_t fsc2_bin_dim( const Fsc2_Bin_Record_T * /* rec */,
+                       int                       /* i   */  );
+
+int64_t fsc2_bin_int( const Fsc2_Bin_Record_T * /* rec */,
+                      size_t                    /* i   */  );
+
+double fsc2_bin_float( const Fsc2_Bin_Record_T * /* rec */,
+                       size_t                    /* i   */  );
+
+
+#endif  /* ! FSC2_BIN_HEADER */
+
+
+/*
+ * Local variables:
+ * tags-file-name: "../TAGS"
+ * tab-width: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,154 @@
+/*
+ *  Copyright (C) 1999-2016 Jens Thoms Toerring
+ *
+ *  This file is part of fsc2.
+ *
+ *  Fsc2 is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 3, or (at your option)
+ *  any later version.
+ *
+ *  Fsc2 is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/* Converts binary data files written by fsc2 to the text format fsc2
+   would have written when using a normal file, i.e. each value on a
+   line of its own with empty lines between the slices of arrays with
+   more than one dimension. The result is written to stdout. */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "fsc2_bin.h"
+
+
+static int convert( const char * name );
+static size_t print_slice( const Fsc2_Bin_Record_T * rec,
+                           int                       dim,
+                           size_t                    index );
+
+
+/*---------------------------------------------*
+ *---------------------------------------------*/
+
+int
+main( int    argc,
+      char * argv[ ] )
+{
+    int ret = EXIT_SUCCESS;
+
+
+    if ( argc < 2 )
+    {
+        fprintf( stderr, "Usage: fsc2_bin2text file ...\n" );
+        return EXIT_FAILURE;
+    }
+
+    for ( int i = 1; i < argc; i++ )
+        if ( convert( argv[ i ] ) )
+            ret = EXIT_FAILURE;
+
+    return ret;
+}
+
+
+/*----------------------------------------------------------*
+ * Writes out the contents of a single file, returns 0 on
+ * success and -1 on failure.
+ *----------------------------------------------------------*/
+
+static int
+convert( const char * name )
+{
+    Fsc2_Bin_File_T *bf;
+    Fsc2_Bin_Record_T rec;
+    int ret;
+
+
+    if ( ( bf = fsc2_bin_open( name ) ) == NULL )
+    {
+        fprintf( stderr, "fsc2_bin2text: Can't open '%s': %s\n", name,
+                 errno == EINVAL ? "not a binary fsc2 data file"
+                                 : strerror( errno ) );
+        return -1;
+    }
+
+    while ( ( ret = fsc2_bin_next( bf, &rec ) ) > 0 )
+    {
+        if ( rec.type == FSC2_BIN_TEXT )
+            fwrite( rec.data, 1, rec.count, stdout );
+        else
+            print_slice( &rec, 0, 0 );
+    }
+
+    fsc2_bin_close( bf );
+
+    if ( ret < 0 )
+    {
+        fprintf( stderr, "fsc2_bin2text: File '%s' is truncated or "
+                 "corrupted.\n", name );
+        return -1;
+    }
+
+    if ( fflush( stdout ) == EOF )
+    {
+        fprintf( stderr, "fsc2_bin2text: Writing data failed: %s\n",
+                 strerror( errno ) );
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/*-----------------------------------------------------------------*
+ * Writes the values of a record, starting at the value with the
+ * index passed to the function, for all dimensions starting with
+ * 'dim'. For the last dimension each value is written on a line
+ * of its own, for all others the slices are separated by an empty
+ * line (exactly as the save() function does it for normal files).
+ * Returns the index of the value following the ones written out.
+ *-----------------------------------------------------------------*/
+
+static size_t
+print_slice( const Fsc2_Bin_Record_T * rec,
+             int                       dim,
+             size_t                    index )
+{
+    uint64_t len = dim < rec->ndims ? fsc2_bin_dim( rec, dim ) : 1;
+
+
+    for ( uint64_t i = 0; i < len; i++ )
+    {
+        if ( dim < rec->ndims - 1 )
+        {
+            index = print_slice( rec, dim + 1, index );
+            if ( i != len - 1 )
+                putchar( '\n' );
+        }
+        else if ( rec->type == FSC2_BIN_INT )
+            printf( "%lld\n", ( long long ) fsc2_bin_int( rec, index++ ) );
+        else
+            printf( "%#.9g\n", fsc2_bin_float( rec, index++ ) );
+    }
+
+    return index;
+}
+
+
+/*
+ * Local variables:
+ * tags-file-name: "../TAGS"
+ * tab-width: 4
+ * indent-tabs-mode: nil
+ * End:
+ */